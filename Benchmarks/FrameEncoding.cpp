@@ -0,0 +1,132 @@
+// Vazao dos codificadores da captura de frames (ImageEncoders.h) em 1000x1000 de 1 a N threads
+// e uma simulacao da captura a 60 fps com o pool limitado do FrameCapture.h: a cada 16,7 ms
+// chega um frame, que e descartado se os CAPTURE_MAX_PENDING buffers estiverem ocupados.
+// Os frames sinteticos imitam o RotatingCubes: fundo branco e quadrados de cores chapadas girando.
+// Uso: FrameEncoding [threads] [frames]
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "JobSystem.h"
+#include "ImageEncoders.h"
+#include "FrameCapture.h"
+
+using namespace std;
+
+const int FRAME_SIZE = 1000;
+const double CAPTURE_FPS = 60.0;
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void renderFrame(int index, vector<uint8_t>& rgba)
+{
+	const uint8_t colors[6][3] = { { 255, 0, 0 }, { 0, 255, 0 }, { 0, 0, 255 }, { 255, 255, 0 }, { 255, 0, 255 }, { 0, 255, 255 } };
+	rgba.assign((size_t)FRAME_SIZE * FRAME_SIZE * 4, 255);
+	float angle = index * 0.05f;
+	float cosine = cos(angle), sine = sin(angle);
+	for (int y = 0; y < FRAME_SIZE; y++)
+	{
+		for (int x = 0; x < FRAME_SIZE; x++)
+		{
+			float px = (x - FRAME_SIZE * 0.5f) / (FRAME_SIZE * 0.5f), py = (y - FRAME_SIZE * 0.5f) / (FRAME_SIZE * 0.5f);
+			float rx = px * cosine - py * sine, ry = px * sine + py * cosine;
+			for (int square = 0; square < 6; square++)
+			{
+				float cx = -0.75f + square * 0.3f;
+				if (fabs(rx - cx) < 0.12f && fabs(ry - cx * 0.5f) < 0.12f)
+				{
+					uint8_t* pixel = &rgba[((size_t)y * FRAME_SIZE + x) * 4];
+					pixel[0] = colors[square][0];
+					pixel[1] = colors[square][1];
+					pixel[2] = colors[square][2];
+					break;
+				}
+			}
+		}
+	}
+}
+
+// Codifica todos os frames em paralelo; devolve frames por segundo e o tamanho medio
+double encodeAll(JobSystem& jobs, const vector<vector<uint8_t>>& frames, CaptureFormat format, size_t& averageBytes)
+{
+	atomic<size_t> totalBytes(0);
+	JobCounter done;
+	auto start = chrono::steady_clock::now();
+	for (const vector<uint8_t>& frame : frames)
+	{
+		jobs.run([&frame, format, &totalBytes]() {
+			vector<uint8_t> out;
+			if (format == CAPTURE_PNG_SEQUENCE) encodePng(frame.data(), FRAME_SIZE, FRAME_SIZE, true, out);
+			else encodeGifFrame(frame.data(), FRAME_SIZE, FRAME_SIZE, true, CAPTURE_GIF_MIN_DELAY, out);
+			totalBytes += out.size();
+		}, &done);
+	}
+	jobs.wait(done);
+	averageBytes = totalBytes / frames.size();
+	return frames.size() * 1000.0 / elapsedMs(start);
+}
+
+// Frames chegando a CAPTURE_FPS com no maximo CAPTURE_MAX_PENDING esperando ou em codificacao
+int simulateCapture(JobSystem& jobs, const vector<vector<uint8_t>>& frames, CaptureFormat format, int count)
+{
+	atomic<int> busy(0);
+	int dropped = 0;
+	JobCounter done;
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < count; i++)
+	{
+		this_thread::sleep_until(start + chrono::microseconds((long long)(i * 1e6 / CAPTURE_FPS)));
+		if (busy.load() >= CAPTURE_MAX_PENDING)
+		{
+			dropped++;
+			continue;
+		}
+		busy++;
+		const vector<uint8_t>& frame = frames[i % frames.size()];
+		jobs.run([&frame, format, &busy]() {
+			vector<uint8_t> out;
+			if (format == CAPTURE_PNG_SEQUENCE) encodePng(frame.data(), FRAME_SIZE, FRAME_SIZE, true, out);
+			else encodeGifFrame(frame.data(), FRAME_SIZE, FRAME_SIZE, true, CAPTURE_GIF_MIN_DELAY, out);
+			busy--;
+		}, &done);
+	}
+	jobs.wait(done);
+	return dropped;
+}
+
+int main(int argc, char** argv)
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : max(1, (int)thread::hardware_concurrency());
+	int frameCount = argc > 2 ? atoi(argv[2]) : 120;
+
+	vector<vector<uint8_t>> frames(min(frameCount, 30));
+	for (size_t i = 0; i < frames.size(); i++) renderFrame((int)i, frames[i]);
+	vector<vector<uint8_t>> workload(frameCount);
+	for (int i = 0; i < frameCount; i++) workload[i] = frames[i % frames.size()];
+
+	cout << frameCount << " frames " << FRAME_SIZE << "x" << FRAME_SIZE << ", " << thread::hardware_concurrency() << " hardware threads" << endl;
+	for (int threads = 1; threads <= maxThreads; threads++)
+	{
+		// A thread principal so produz na simulacao, entao os encoders sao todos workers
+		JobSystem jobs(threads);
+		size_t pngBytes = 0, gifBytes = 0;
+		double pngFps = encodeAll(jobs, workload, CAPTURE_PNG_SEQUENCE, pngBytes);
+		double gifFps = encodeAll(jobs, workload, CAPTURE_GIF, gifBytes);
+		int pngDropped = simulateCapture(jobs, frames, CAPTURE_PNG_SEQUENCE, frameCount);
+		int gifDropped = simulateCapture(jobs, frames, CAPTURE_GIF, frameCount);
+		cout << threads << " encoder threads: PNG " << pngFps << " fps (" << pngBytes / 1024 << " KB/frame, "
+			<< pngDropped << "/" << frameCount << " dropped at 60 fps), GIF " << gifFps << " fps (" << gifBytes / 1024
+			<< " KB/frame, " << gifDropped << "/" << frameCount << " dropped at 60 fps)" << endl;
+	}
+	return 0;
+}
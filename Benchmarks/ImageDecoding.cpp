@@ -0,0 +1,75 @@
+// Decodificacao das texturas PNG do repositorio: stb_image contra o PngDecoder.h (inflate proprio
+// e filtros em SSE2, direto num buffer do chamador). Mede MB/s de pixels decodificados e confere
+// que as duas saidas sao identicas.
+// Uso: ImageDecoding [repeticoes] [arquivos PNG...]
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "stb_image.h"
+#include "PngDecoder.h"
+
+using namespace std;
+
+const vector<string> defaultFiles = {
+	"../Camera/textures/suzanne/Suzanne.png",
+	"../Camera/textures/cube/Cube.png",
+	"../Hello3D/result.png",
+};
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+	int repetitions = argc > 1 ? atoi(argv[1]) : 20;
+	vector<string> files = argc > 2 ? vector<string>(argv + 2, argv + argc) : defaultFiles;
+
+	for (const string& path : files)
+	{
+		ifstream file(path, ios::binary);
+		vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+		PngInfo info;
+		if (data.empty() || !readPngInfo(data.data(), data.size(), info))
+		{
+			cout << path << ": not found or not supported by PngDecoder" << endl;
+			continue;
+		}
+		size_t pixelBytes = (size_t)info.width * info.height * info.channels;
+		vector<uint8_t> pixels(pixelBytes);
+
+		int width, height, channels;
+		unsigned char* reference = nullptr;
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < repetitions; i++)
+		{
+			stbi_image_free(reference);
+			reference = stbi_load_from_memory(data.data(), (int)data.size(), &width, &height, &channels, 0);
+		}
+		double stbMs = elapsedMs(start) / repetitions;
+
+		bool decoded = true;
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < repetitions; i++)
+		{
+			decoded = decodePng(info, pixels.data(), (size_t)info.width * info.channels) && decoded;
+		}
+		double fastMs = elapsedMs(start) / repetitions;
+
+		bool identical = decoded && reference && !memcmp(reference, pixels.data(), pixelBytes);
+		stbi_image_free(reference);
+		double megabytes = pixelBytes / (1024.0 * 1024.0);
+		cout << path << " (" << info.width << "x" << info.height << "x" << info.channels << ", " << data.size() / 1024 << " KB): stb_image "
+			<< stbMs << " ms (" << megabytes * 1000.0 / stbMs << " MB/s), PngDecoder " << fastMs << " ms ("
+			<< megabytes * 1000.0 / fastMs << " MB/s, " << stbMs / fastMs << "x), " << (identical ? "identical" : "MISMATCH") << endl;
+	}
+	return 0;
+}
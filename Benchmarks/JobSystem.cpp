@@ -0,0 +1,118 @@
+// Escalabilidade do JobSystem.h de 1 a N threads em duas cargas: parse de varios OBJ/MTL
+// (uma tarefa por arquivo, com uma tarefa final dependente que soma os resultados) e
+// atualizacao de transformacoes em lote com parallelFor.
+// Uso: JobSystem [threads] [copias de OBJ] [objetos] [repeticoes]
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "ObjLoader.h"
+#include "TransformBatch.h"
+#include "JobSystem.h"
+
+using namespace std;
+
+const string suzanneObjFile = "../Camera/textures/suzanne/SuzanneTriTextured.obj";
+const string suzanneMtlFile = "../Camera/textures/suzanne/SuzanneTriTextured.mtl";
+const string cubeObjFile = "../Camera/textures/cube/CubeTextured.obj";
+const string cubeMtlFile = "../Camera/textures/cube/CubeTextured.mtl";
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Uma tarefa por arquivo; a soma dos vertices so roda depois que todos terminam
+double parseFiles(JobSystem& jobs, int copies, size_t& totalFloats)
+{
+	vector<vector<float>> meshes(copies);
+	vector<Material> materials(copies);
+	auto start = chrono::steady_clock::now();
+	JobCounter parsed, merged;
+	for (int i = 0; i < copies; i++)
+	{
+		jobs.run([&meshes, &materials, i]() {
+			bool suzanne = i % 2 == 0;
+			meshes[i] = parseObjFile(suzanne ? suzanneObjFile : cubeObjFile);
+			materials[i] = parseMTL(suzanne ? suzanneMtlFile : cubeMtlFile);
+		}, &parsed);
+	}
+	jobs.run([&meshes, &totalFloats]() {
+		totalFloats = 0;
+		for (const vector<float>& mesh : meshes) totalFloats += mesh.size();
+	}, &merged, &parsed);
+	jobs.wait(merged);
+	return elapsedMs(start);
+}
+
+double updateBatch(JobSystem& jobs, const TransformBatch& batch, const glm::mat4& viewProjection,
+	TransformBatchOutputs& outputs, int repetitions)
+{
+	auto start = chrono::steady_clock::now();
+	for (int r = 0; r < repetitions; r++)
+	{
+		jobs.parallelFor(0, batch.size(), 4096, [&](size_t first, size_t last) {
+			updateTransforms(batch, viewProjection, outputs, first, last);
+		});
+	}
+	return elapsedMs(start) / repetitions;
+}
+
+int main(int argc, char** argv)
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : max(1, (int)thread::hardware_concurrency());
+	int copies = argc > 2 ? atoi(argv[2]) : 64;
+	size_t count = argc > 3 ? (size_t)atol(argv[3]) : 500000;
+	int repetitions = argc > 4 ? atoi(argv[4]) : 20;
+
+	mt19937 gen(7);
+	uniform_real_distribution<float> position(-100.0f, 100.0f);
+	uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	TransformBatch batch;
+	batch.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		glm::quat rotation = glm::normalize(glm::quat(unit(gen), unit(gen), unit(gen), unit(gen)));
+		batch.set(i, glm::vec3(position(gen), position(gen), position(gen)), rotation, glm::vec3(0.5f),
+			glm::vec3(-1.0f), glm::vec3(1.0f));
+	}
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 500.0f)
+		* glm::lookAt(glm::vec3(0.0f, 50.0f, 200.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	vector<glm::mat4> world(count), mvp(count);
+	TransformBatchOutputs outputs;
+	outputs.world = world.data();
+	outputs.worldViewProjection = mvp.data();
+
+	cout << copies << " OBJ/MTL files, " << count << " transforms (" << transformKernelName(bestTransformKernel())
+		<< "), " << thread::hardware_concurrency() << " hardware threads" << endl;
+	double parseBase = 0.0, transformBase = 0.0;
+	for (int threads = 1; threads <= maxThreads; threads++)
+	{
+		JobSystem jobs(threads - 1);
+		size_t totalFloats = 0;
+		// Primeira passada aquece o cache de arquivos do sistema
+		parseFiles(jobs, copies, totalFloats);
+		double parseMs = parseFiles(jobs, copies, totalFloats);
+		double transformMs = updateBatch(jobs, batch, viewProjection, outputs, repetitions);
+		if (threads == 1)
+		{
+			parseBase = parseMs;
+			transformBase = transformMs;
+		}
+		cout << threads << " threads: parse " << parseMs << " ms (" << parseBase / parseMs << "x, "
+			<< totalFloats / OBJ_VERTEX_STRIDE << " vertices), transforms " << transformMs << " ms ("
+			<< transformBase / transformMs << "x)" << endl;
+	}
+	return 0;
+}
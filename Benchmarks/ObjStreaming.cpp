@@ -0,0 +1,150 @@
+// Leitura de um OBJ grande: parseObjFile (tudo na memoria) contra streamObjFile do
+// ObjStreamLoader.h com um orcamento de memoria. Gera uma grade com v/vt/vn (na ordem de um
+// exportador: todos os atributos antes das faces), mede tempo e pico de RSS de cada caminho e
+// confere que os vertices intercalados sao os mesmos (hash). O streaming roda primeiro, porque o
+// pico de RSS do processo so cresce.
+// Uso: ObjStreaming [lado da grade] [orcamento MB] [arquivo OBJ gerado]
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "ObjLoader.h"
+#include "ObjStreamLoader.h"
+
+using namespace std;
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Pico de memoria residente do processo, em MB
+double peakRssMb()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024.0;
+#endif
+}
+
+// FNV-1a sobre os bits dos floats, na ordem em que chegam
+struct FloatHash {
+	uint64_t value = 1469598103934665603ull;
+	void add(const float* data, size_t count)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < count * sizeof(float); i++) value = (value ^ bytes[i]) * 1099511628211ull;
+	}
+};
+
+void writeGrid(const string& path, int side)
+{
+	ofstream file(path);
+	char line[160];
+	for (int y = 0; y < side; y++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			float height = 0.05f * (float)((x * 7 + y * 13) % 17);
+			snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x / (float)side, height, y / (float)side);
+			file << line;
+		}
+	}
+	for (int y = 0; y < side; y++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			snprintf(line, sizeof(line), "vt %.6f %.6f\n", x / (float)side, y / (float)side);
+			file << line;
+		}
+	}
+	for (int i = 0; i < side * side; i++)
+	{
+		snprintf(line, sizeof(line), "vn %.4f %.4f %.4f\n", 0.0f, 1.0f, 0.0f);
+		file << line;
+	}
+	for (int y = 0; y + 1 < side; y++)
+	{
+		for (int x = 0; x + 1 < side; x++)
+		{
+			int a = y * side + x + 1, b = a + 1, c = a + side, d = c + 1;
+			snprintf(line, sizeof(line), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, c, c, c, d, d, d, b, b, b);
+			file << line;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int side = argc > 1 ? atoi(argv[1]) : 700;
+	size_t budgetMb = argc > 2 ? (size_t)atoll(argv[2]) : 64;
+	string path = argc > 3 ? argv[3] : "ObjStreaming_grid.obj";
+
+	auto start = chrono::steady_clock::now();
+	writeGrid(path, side);
+	double baseRss = peakRssMb();
+	ifstream probe(path, ios::binary | ios::ate);
+	cout << "Grid " << side << "x" << side << ": " << probe.tellg() / (1024 * 1024) << " MB OBJ written in " << elapsedMs(start) << " ms" << endl;
+
+	ObjStreamOptions options;
+	options.memoryBudget = budgetMb << 20;
+	options.batchTriangles = 16384;
+	ObjStreamStats stats;
+	FloatHash streamed;
+	size_t streamedFloats = 0;
+	start = chrono::steady_clock::now();
+	double firstBatchMs = -1.0;
+	bool ok = streamObjFile(path, options, [&](vector<float>& batch) {
+		if (firstBatchMs < 0.0) firstBatchMs = elapsedMs(start);
+		streamed.add(batch.data(), batch.size());
+		streamedFloats += batch.size();
+		return true;
+	}, &stats);
+	double streamMs = elapsedMs(start);
+	double streamRss = peakRssMb();
+	if (!ok)
+	{
+		remove(path.c_str());
+		return 1;
+	}
+	cout << "streamObjFile (" << budgetMb << " MB budget): " << streamMs << " ms, first batch after " << firstBatchMs << " ms, "
+		<< stats.batches << " batches, " << stats.triangles << " triangles, " << stats.pagesSpilled << " pages spilled, "
+		<< stats.pageLoads << " page loads, tracked peak " << (stats.peakTrackedBytes >> 20) << " MB, process peak RSS "
+		<< streamRss << " MB (+" << streamRss - baseRss << ")" << endl;
+
+	start = chrono::steady_clock::now();
+	vector<float> full = parseObjFile(path);
+	double fullMs = elapsedMs(start);
+	double fullRss = peakRssMb();
+	FloatHash loaded;
+	loaded.add(full.data(), full.size());
+	cout << "parseObjFile: " << fullMs << " ms, " << full.size() / (3 * OBJ_VERTEX_STRIDE) << " triangles, process peak RSS "
+		<< fullRss << " MB (+" << fullRss - baseRss << ")" << endl;
+	cout << (streamedFloats == full.size() && streamed.value == loaded.value ? "identical vertices" : "VERTEX MISMATCH") << endl;
+	remove(path.c_str());
+	return 0;
+}
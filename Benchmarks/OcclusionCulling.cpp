@@ -0,0 +1,190 @@
+// Cena com muita oclusao para o OcclusionCuller.h: uma fileira de Suzannes grandes e paredes
+// na frente de um campo de objetos pequenos. A camera gira de um lado para o outro; em cada frame
+// os objetos passam pelo frustum culling e depois pelo teste contra os oclusores rasterizados,
+// e o programa mostra quantos draws sobram em cada etapa e o tempo de rasterizacao e de teste
+// de 1 a N threads (e o AVX2 contra o escalar).
+// Uso: OcclusionCulling [threads] [frames]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "ObjLoader.h"
+#include "MeshOptimizer.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "OcclusionCuller.h"
+
+using namespace std;
+
+const string suzanneObjFile = "../Camera/textures/suzanne/SuzanneTriTextured.obj";
+// 160 x 160 objetos atras dos oclusores
+const int FIELD_SIZE = 160;
+const float FIELD_SPACING = 1.5f;
+
+struct Box {
+	glm::vec3 min, max;
+};
+
+struct SceneOccluder {
+	const vector<float>* vertices;
+	int stride;
+	const vector<uint32_t>* indices;
+	glm::mat4 model;
+};
+
+struct FrameStats {
+	size_t frustumVisible = 0, occlusionVisible = 0, triangles = 0;
+	double rasterMs = 0.0, testMs = 0.0;
+};
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Cubo unitario [-0.5, 0.5]^3, so posicoes
+void buildCube(vector<float>& vertices, vector<uint32_t>& indices)
+{
+	for (int corner = 0; corner < 8; corner++)
+	{
+		vertices.push_back(corner & 1 ? 0.5f : -0.5f);
+		vertices.push_back(corner & 2 ? 0.5f : -0.5f);
+		vertices.push_back(corner & 4 ? 0.5f : -0.5f);
+	}
+	indices = { 0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4, 2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5 };
+}
+
+FrameStats runFrame(OcclusionCuller& culler, JobSystem* jobs, const vector<SceneOccluder>& occluders, const vector<Box>& objects,
+	const glm::mat4& viewProjection, vector<uint8_t>& visible)
+{
+	FrameStats stats;
+	Frustum frustum = Frustum::fromMatrix(viewProjection);
+
+	auto start = chrono::steady_clock::now();
+	for (const SceneOccluder& occluder : occluders)
+	{
+		culler.addOccluder(occluder.vertices->data(), occluder.stride, occluder.indices->data(), occluder.indices->size(), viewProjection * occluder.model);
+	}
+	culler.rasterize(jobs);
+	stats.rasterMs = elapsedMs(start);
+	stats.triangles = culler.rasterizedTriangles;
+
+	start = chrono::steady_clock::now();
+	visible.assign(objects.size(), 0);
+	auto test = [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i++)
+		{
+			if (!frustum.intersectsAABB(objects[i].min, objects[i].max)) continue;
+			visible[i] = culler.isOccluded(objects[i].min, objects[i].max, viewProjection) ? 1 : 2;
+		}
+	};
+	if (jobs) jobs->parallelFor(0, objects.size(), 1024, test);
+	else test(0, objects.size());
+	stats.testMs = elapsedMs(start);
+	for (uint8_t flag : visible)
+	{
+		stats.frustumVisible += flag != 0;
+		stats.occlusionVisible += flag == 2;
+	}
+	return stats;
+}
+
+int main(int argc, char** argv)
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : (int)max(1u, thread::hardware_concurrency());
+	int frames = argc > 2 ? atoi(argv[2]) : 120;
+
+	vector<float> suzanneVertices, cubeVertices;
+	vector<uint32_t> suzanneIndices, cubeIndices;
+	vector<float> interleaved = parseObjFile(suzanneObjFile);
+	if (interleaved.empty())
+	{
+		cout << "Failed to load " << suzanneObjFile << endl;
+		return 1;
+	}
+	indexVertices(interleaved, OBJ_VERTEX_STRIDE, suzanneVertices, suzanneIndices);
+	buildCube(cubeVertices, cubeIndices);
+
+	// Fileira de Suzannes e paredes baixas entre a camera e o campo de objetos
+	vector<SceneOccluder> occluders;
+	for (int i = 0; i < 7; i++)
+	{
+		glm::mat4 model = glm::translate(glm::mat4(1), glm::vec3(-18.0f + i * 6.0f, 2.0f, -14.0f));
+		occluders.push_back({ &suzanneVertices, OBJ_VERTEX_STRIDE, &suzanneIndices, glm::scale(model, glm::vec3(3.5f)) });
+	}
+	for (int i = 0; i < 6; i++)
+	{
+		glm::mat4 model = glm::translate(glm::mat4(1), glm::vec3(-50.0f + i * 20.0f, 3.0f, -24.0f));
+		occluders.push_back({ &cubeVertices, 3, &cubeIndices, glm::scale(model, glm::vec3(16.0f, 6.0f, 1.0f)) });
+	}
+	vector<Box> objects;
+	float offset = (FIELD_SIZE - 1) * FIELD_SPACING * 0.5f;
+	for (int z = 0; z < FIELD_SIZE; z++)
+	{
+		for (int x = 0; x < FIELD_SIZE; x++)
+		{
+			glm::vec3 center(x * FIELD_SPACING - offset, 0.5f, -30.0f - z * FIELD_SPACING);
+			objects.push_back({ center - glm::vec3(0.5f), center + glm::vec3(0.5f) });
+		}
+	}
+
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 400.0f);
+	vector<glm::mat4> viewProjections;
+	for (int f = 0; f < frames; f++)
+	{
+		float yaw = glm::radians(30.0f) * sin(6.2831853f * f / frames);
+		glm::vec3 eye(0.0f, 1.7f, 0.0f);
+		glm::vec3 forward(sin(yaw), -0.02f, -cos(yaw));
+		viewProjections.push_back(projection * glm::lookAt(eye, eye + forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+	}
+
+	cout << objects.size() << " objects, " << occluders.size() << " occluders, " << frames << " frames, buffer "
+		<< OCCLUSION_WIDTH << "x" << OCCLUSION_HEIGHT << ", AVX2 " << (cpuHasAVX2() ? "yes" : "no") << endl;
+	cout << fixed << setprecision(3);
+	vector<uint8_t> visible, reference;
+	size_t referenceVisible = 0;
+	for (int threads = 1; threads <= maxThreads; threads++)
+	{
+		for (int avx2 = cpuHasAVX2() ? 1 : 0; avx2 >= 0; avx2--)
+		{
+			JobSystem jobs(threads - 1);
+			OcclusionCuller culler;
+			culler.useAVX2 = avx2 != 0;
+			FrameStats total;
+			bool agrees = true;
+			for (int f = 0; f < frames; f++)
+			{
+				FrameStats stats = runFrame(culler, &jobs, occluders, objects, viewProjections[f], visible);
+				total.frustumVisible += stats.frustumVisible;
+				total.occlusionVisible += stats.occlusionVisible;
+				total.triangles += stats.triangles;
+				total.rasterMs += stats.rasterMs;
+				total.testMs += stats.testMs;
+				// Resultado do primeiro frame da primeira configuracao serve de referencia
+				if (f == 0 && reference.empty())
+				{
+					reference = visible;
+					referenceVisible = stats.occlusionVisible;
+				}
+				else if (f == 0)
+				{
+					agrees = visible == reference;
+				}
+			}
+			cout << threads << " thread(s), " << (avx2 ? "AVX2  " : "scalar") << ": draws " << objects.size()
+				<< " -> " << total.frustumVisible / frames << " (frustum) -> " << total.occlusionVisible / frames << " (occlusion), "
+				<< total.triangles / frames << " occluder triangles, raster " << total.rasterMs / frames << " ms, test "
+				<< total.testMs / frames << " ms" << (agrees ? "" : " - RESULTS DIFFER") << endl;
+		}
+	}
+	cout << "First frame draws after occlusion: " << referenceVisible << endl;
+	return 0;
+}
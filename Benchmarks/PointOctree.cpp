@@ -0,0 +1,135 @@
+// Octree de nuvem de pontos do PointOctree.h: construcao de 1 a N threads e selecao de nos por
+// erro em tela com orcamento de pontos. Sem arquivo, gera um terreno ondulado com pontos aleatorios
+// na superficie. Confere que cada ponto esta em exatamente um no e dentro do cubo dele.
+// Uso: PointOctree [threads] [milhoes de pontos] [arquivo OBJ/PLY]
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "JobSystem.h"
+#include "PointOctree.h"
+
+using namespace std;
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+uint64_t mix(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+// Terreno de 1000 x 1000 unidades com colinas; cor pela altura
+void generateTerrain(PointCloud& cloud, size_t count)
+{
+	cloud.points.resize(count);
+	cloud.hasColors = true;
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t random = mix(i);
+		float x = (random & 0xFFFFF) / (float)0xFFFFF * 1000.0f;
+		float z = ((random >> 20) & 0xFFFFF) / (float)0xFFFFF * 1000.0f;
+		float y = 40.0f * sin(x * 0.01f) * cos(z * 0.013f) + 5.0f * sin(x * 0.1f + z * 0.07f);
+		float shade = (y + 45.0f) / 90.0f;
+		cloud.points[i] = { glm::vec3(x, y, z), packPointColor(shade, 0.6f, 1.0f - shade) };
+	}
+}
+
+bool validate(const PointOctree& octree)
+{
+	size_t total = 0;
+	for (const PointNode& node : octree.nodes)
+	{
+		total += node.count;
+		glm::vec3 high = node.boundsMin + glm::vec3(node.size);
+		for (size_t i = node.first; i < node.first + node.count; i++)
+		{
+			const glm::vec3& p = octree.points[i].position;
+			if (glm::any(glm::lessThan(p, node.boundsMin)) || glm::any(glm::greaterThan(p, high))) return false;
+		}
+	}
+	return total == octree.points.size();
+}
+
+int main(int argc, char** argv)
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : max(1, (int)thread::hardware_concurrency());
+	double millions = argc > 2 ? atof(argv[2]) : 5.0;
+
+	PointCloud source;
+	auto start = chrono::steady_clock::now();
+	if (argc > 3)
+	{
+		JobSystem jobs(maxThreads - 1);
+		if (!loadPointCloud(argv[3], source, &jobs)) return 1;
+		cout << argv[3] << ": " << source.points.size() << " points loaded in " << elapsedMs(start) << " ms" << endl;
+	}
+	else
+	{
+		generateTerrain(source, (size_t)(millions * 1e6));
+		cout << source.points.size() << " terrain points generated" << endl;
+	}
+
+	PointOctree octree;
+	for (int threads = 1; threads <= maxThreads; threads++)
+	{
+		JobSystem jobs(threads - 1);
+		PointCloud cloud = source;
+		start = chrono::steady_clock::now();
+		octree.build(move(cloud), &jobs);
+		cout << threads << " threads: build " << elapsedMs(start) << " ms, " << octree.nodes.size() << " nodes, depth "
+			<< octree.maxDepth() << ", root keeps " << octree.nodes[0].count << " points" << endl;
+	}
+	cout << (validate(octree) ? "every point in exactly one node, inside its bounds" : "OCTREE INVALID") << endl;
+
+	const PointNode& root = octree.nodes[0];
+	glm::vec3 center = root.boundsMin + glm::vec3(root.size * 0.5f);
+	float fovy = glm::radians(45.0f);
+	glm::mat4 projection = glm::perspective(fovy, 1.0f, root.size * 0.001f, root.size * 10.0f);
+	PointLodSettings settings;
+	struct Viewpoint {
+		const char* name;
+		glm::vec3 position;
+	};
+	const Viewpoint viewpoints[] = {
+		{ "far", center + glm::vec3(0.0f, root.size * 0.8f, root.size * 1.5f) },
+		{ "near", center + glm::vec3(0.0f, root.size * 0.1f, root.size * 0.3f) },
+		{ "ground", center + glm::vec3(root.size * 0.2f, 0.0f, root.size * 0.2f) },
+	};
+	vector<PointNodeSelection> selected;
+	for (const Viewpoint& viewpoint : viewpoints)
+	{
+		PointLodView view;
+		view.cameraPosition = viewpoint.position;
+		view.viewProjection = projection * glm::lookAt(viewpoint.position, center, glm::vec3(0.0f, 1.0f, 0.0f));
+		view.projectionFactor = 1000.0f / (2.0f * tan(fovy * 0.5f));
+		const int repetitions = 100;
+		start = chrono::steady_clock::now();
+		for (int i = 0; i < repetitions; i++) octree.selectNodes(view, settings, selected);
+		double selectMs = elapsedMs(start) / repetitions;
+		size_t points = 0;
+		int deepest = 0;
+		for (const PointNodeSelection& selection : selected)
+		{
+			points += octree.nodes[selection.node].count;
+			deepest = max(deepest, octree.nodes[selection.node].depth);
+		}
+		cout << viewpoint.name << " view: " << selected.size() << " nodes, " << points << " of " << settings.pointBudget
+			<< " budget points, depth " << deepest << ", select " << selectMs << " ms" << endl;
+	}
+	return 0;
+}
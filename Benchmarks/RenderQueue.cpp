@@ -0,0 +1,133 @@
+// Fila de desenho do RenderQueue.h sem GPU: grava N draws aleatorios (programas, materiais,
+// VAOs, profundidades e uma parte translucida) em varias tarefas do JobSystem, um bucket por
+// tarefa, e mede o merge + radix sort contra std::stable_sort das mesmas entradas. Conta as
+// trocas de programa, material e VAO que a execucao faria na ordem de gravacao e na das chaves.
+// Uso: RenderQueue [threads] [draws] [repeticoes]
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+
+#include "JobSystem.h"
+#include "RenderQueue.h"
+
+using namespace std;
+
+const int PROGRAMS = 8, MATERIALS = 64, VAOS = 32;
+const int TRANSLUCENT_PERCENT = 10;
+
+double elapsedMs(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// splitmix64: numeros independentes por objeto sem o custo de criar um gerador para cada um
+uint64_t mix(uint64_t value)
+{
+	value += 0x9E3779B97F4A7C15ull;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+// A semente depende so do objeto, entao a cena e a mesma para qualquer numero de tarefas
+void record(RenderQueueBucket& bucket, size_t first, size_t last)
+{
+	for (size_t object = first; object < last; object++)
+	{
+		uint64_t state = object * 8;
+		auto random = [&state]() { return (uint32_t)mix(state++); };
+		DrawItem item;
+		item.program = 1 + random() % PROGRAMS;
+		item.texture = 1 + random() % MATERIALS;
+		item.vao = 1 + random() % VAOS;
+		item.count = 36;
+		bool translucent = (int)(random() % 100) < TRANSLUCENT_PERCENT;
+		float depth = (random() % 100000) / 100000.0f;
+		bucket.submit(makeRenderKey(0, translucent, item.program, item.texture, item.vao, depth), item);
+	}
+}
+
+struct StateChanges {
+	size_t programs = 0, materials = 0, vaos = 0;
+	void add(const DrawItem& item, const DrawItem& previous)
+	{
+		programs += item.program != previous.program;
+		materials += item.texture != previous.texture;
+		vaos += item.vao != previous.vao;
+	}
+};
+
+int main(int argc, char** argv)
+{
+	int maxThreads = argc > 1 ? atoi(argv[1]) : max(1, (int)thread::hardware_concurrency());
+	size_t drawCount = argc > 2 ? (size_t)atoll(argv[2]) : 100000;
+	int repetitions = argc > 3 ? atoi(argv[3]) : 20;
+
+	cout << drawCount << " draws, " << PROGRAMS << " programs, " << MATERIALS << " materials, " << VAOS << " VAOs, "
+		<< TRANSLUCENT_PERCENT << "% translucent" << endl;
+	RenderQueue queue;
+	for (int threads = 1; threads <= maxThreads; threads++)
+	{
+		JobSystem jobs(threads - 1);
+		double recordMs = 0.0, sortMs = 0.0, stdSortMs = 0.0;
+		bool sameOrder = true;
+		for (int repetition = 0; repetition < repetitions; repetition++)
+		{
+			auto start = chrono::steady_clock::now();
+			queue.begin(threads);
+			JobCounter recorded;
+			for (int task = 0; task < threads; task++)
+			{
+				jobs.run([&queue, task, threads, drawCount]() {
+					record(queue.bucket(task), drawCount * task / threads, drawCount * (task + 1) / threads);
+				}, &recorded);
+			}
+			jobs.wait(recorded);
+			recordMs += elapsedMs(start);
+
+			start = chrono::steady_clock::now();
+			queue.sort();
+			sortMs += elapsedMs(start);
+
+			vector<RenderQueue::Entry> reference;
+			reference.reserve(drawCount);
+			for (int b = 0; b < threads; b++)
+			{
+				for (size_t i = 0; i < queue.bucket(b).size(); i++) reference.push_back({ queue.bucket(b).key(i), (uint32_t)b, (uint32_t)i });
+			}
+			start = chrono::steady_clock::now();
+			stable_sort(reference.begin(), reference.end(), [](const RenderQueue::Entry& a, const RenderQueue::Entry& b) { return a.key < b.key; });
+			stdSortMs += elapsedMs(start);
+			for (size_t i = 0; i < reference.size() && sameOrder; i++)
+			{
+				sameOrder = &queue.bucket(reference[i].bucket).item(reference[i].index) == &queue.item(i);
+			}
+		}
+		cout << threads << " threads: record " << recordMs / repetitions << " ms, merge + radix sort " << sortMs / repetitions
+			<< " ms, std::stable_sort " << stdSortMs / repetitions << " ms" << (sameOrder ? "" : " (ORDER MISMATCH)") << endl;
+	}
+
+	// A ordem de gravacao e a mesma para qualquer numero de tarefas; basta a ultima fila
+	StateChanges submitted, sorted;
+	DrawItem previousSubmitted, previousSorted;
+	for (int b = 0; b < maxThreads; b++)
+	{
+		for (size_t i = 0; i < queue.bucket(b).size(); i++)
+		{
+			submitted.add(queue.bucket(b).item(i), previousSubmitted);
+			previousSubmitted = queue.bucket(b).item(i);
+		}
+	}
+	for (size_t i = 0; i < queue.size(); i++)
+	{
+		sorted.add(queue.item(i), previousSorted);
+		previousSorted = queue.item(i);
+	}
+	cout << "State changes in submission order: " << submitted.programs << " programs, " << submitted.materials << " materials, "
+		<< submitted.vaos << " VAOs; sorted: " << sorted.programs << " programs, " << sorted.materials << " materials, " << sorted.vaos << " VAOs" << endl;
+	return 0;
+}
@@ -0,0 +1,123 @@
+// Compara o kernel em lote de TransformBatch.h com as chamadas glm por objeto usadas nos
+// loops de render (glm::translate/rotate/scale + multiplicacao pela view-projection).
+// Uso: TransformBatch [objetos] [repeticoes]
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "TransformBatch.h"
+
+using namespace std;
+
+struct Aabb {
+	glm::vec3 min, max;
+};
+
+void updateWithGlm(const vector<glm::vec3>& positions, const vector<glm::quat>& rotations, const vector<glm::vec3>& scales,
+	const Aabb& local, const glm::mat4& viewProjection, vector<glm::mat4>& world, vector<glm::mat4>& mvp, vector<Aabb>& bounds)
+{
+	for (size_t i = 0; i < positions.size(); i++)
+	{
+		glm::mat4 model = glm::mat4(1);
+		model = glm::translate(model, positions[i]);
+		model = model * glm::mat4_cast(rotations[i]);
+		model = glm::scale(model, scales[i]);
+		world[i] = model;
+		mvp[i] = viewProjection * model;
+		Aabb box = { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec3 p((corner & 1) ? local.max.x : local.min.x, (corner & 2) ? local.max.y : local.min.y, (corner & 4) ? local.max.z : local.min.z);
+			glm::vec3 t = glm::vec3(model * glm::vec4(p, 1.0f));
+			box.min = glm::min(box.min, t);
+			box.max = glm::max(box.max, t);
+		}
+		bounds[i] = box;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+	int repetitions = argc > 2 ? atoi(argv[2]) : 50;
+
+	mt19937 gen(7);
+	uniform_real_distribution<float> position(-100.0f, 100.0f);
+	uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	uniform_real_distribution<float> scale(0.2f, 2.0f);
+	Aabb local = { glm::vec3(-1.0f, -0.8f, -0.9f), glm::vec3(1.0f, 0.9f, 0.7f) };
+	vector<glm::vec3> positions(count), scales(count);
+	vector<glm::quat> rotations(count);
+	TransformBatch batch;
+	batch.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		positions[i] = glm::vec3(position(gen), position(gen), position(gen));
+		rotations[i] = glm::normalize(glm::quat(unit(gen), unit(gen), unit(gen), unit(gen)));
+		scales[i] = glm::vec3(scale(gen), scale(gen), scale(gen));
+		batch.set(i, positions[i], rotations[i], scales[i], local.min, local.max);
+	}
+	glm::mat4 viewProjection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 500.0f)
+		* glm::lookAt(glm::vec3(0.0f, 50.0f, 200.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	vector<glm::mat4> referenceWorld(count), referenceMvp(count);
+	vector<Aabb> referenceBounds(count);
+	auto start = chrono::steady_clock::now();
+	for (int r = 0; r < repetitions; r++)
+	{
+		updateWithGlm(positions, rotations, scales, local, viewProjection, referenceWorld, referenceMvp, referenceBounds);
+	}
+	double glmNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / repetitions / count;
+	cout << count << " objects, " << repetitions << " repetitions" << endl;
+	cout << "glm per object:  " << glmNs << " ns/object" << endl;
+
+	vector<glm::mat4> world(count), mvp(count);
+	vector<float> bounds[6];
+	for (vector<float>& b : bounds) b.resize(count);
+	TransformBatchOutputs outputs;
+	outputs.world = world.data();
+	outputs.worldViewProjection = mvp.data();
+	outputs.minX = bounds[0].data(); outputs.minY = bounds[1].data(); outputs.minZ = bounds[2].data();
+	outputs.maxX = bounds[3].data(); outputs.maxY = bounds[4].data(); outputs.maxZ = bounds[5].data();
+
+	vector<TransformKernel> kernels = { TransformKernel::Scalar, TransformKernel::SSE };
+	if (cpuHasTransformAVX2()) kernels.push_back(TransformKernel::AVX2);
+	for (TransformKernel kernel : kernels)
+	{
+		start = chrono::steady_clock::now();
+		for (int r = 0; r < repetitions; r++)
+		{
+			updateTransforms(batch, viewProjection, outputs, 0, count, kernel);
+		}
+		double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / repetitions / count;
+		float maxError = 0.0f;
+		for (size_t i = 0; i < count; i++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				for (int k = 0; k < 4; k++)
+				{
+					maxError = max(maxError, fabs(world[i][c][k] - referenceWorld[i][c][k]));
+					maxError = max(maxError, fabs(mvp[i][c][k] - referenceMvp[i][c][k]) / max(1.0f, fabs(referenceMvp[i][c][k])));
+				}
+			}
+			maxError = max(maxError, fabs(bounds[0][i] - referenceBounds[i].min.x));
+			maxError = max(maxError, fabs(bounds[4][i] - referenceBounds[i].max.y));
+		}
+		cout << "batch " << transformKernelName(kernel) << ":" << string(8 - strlen(transformKernelName(kernel)), ' ')
+			<< ns << " ns/object (" << glmNs / ns << "x), max error " << maxError << endl;
+	}
+	cout << "Runtime dispatch selects " << transformKernelName(bestTransformKernel()) << endl;
+	return 0;
+}
@@ -2,6 +2,14 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <iterator>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -11,141 +19,565 @@
 #include <GLFW/glfw3.h>
 #include "Shader.h"
 #include "stb_image.h"
+#include "PngDecoder.h"
+#include "CameraController.h"
+#include "JobSystem.h"
+#include "TripleBuffer.h"
+#include "AssetArchive.h"
+#include "ObjLoader.h"
+#include "AssetFormats.h"
+#include "MeshOptimizer.h"
+#include "Meshlets.h"
+#include "Frustum.h"
+#include "GLExt.h"
+#include "ShadowMap.h"
+#include "GpuTimer.h"
+#include "DynamicResolution.h"
+#include "FrameScheduler.h"
+#include "GLStateCache.h"
+#include "RenderQueue.h"
 
 using namespace std;
 
-struct Vertex {
-	float x, y, z;
+struct DecodedImage {
+	vector<unsigned char> pixels;
+	int width = 0, height = 0, channels = 0;
+	// Niveis 1.. prontos (.tex do AssetConverter); vazio gera os mipmaps no driver
+	vector<vector<unsigned char>> mipLevels;
 };
 
-struct Normal {
-	float nx, ny, nz;
+struct FrameSnapshot {
+	glm::mat4 view;
+	glm::mat4 model;
+	glm::mat4 staticModel;
+	glm::vec3 cameraPos;
+	glm::vec3 lightPosition;
+	// Tamanho do framebuffer da janela e a projecao com o aspecto dele
+	glm::mat4 projection;
+	int outputWidth, outputHeight;
+	// Opcoes das teclas, copiadas aqui porque o key_callback roda na thread principal
+	bool shadowCache;
+	int pcfQuality;
+	bool dynamicResolution, sharpenUpscale;
+	// Meshlets que passaram no culling, ja juntados em comandos de desenho
+	vector<DrawElementsIndirectCommand> commands;
+	size_t visibleMeshlets, visibleTriangles;
+	double cullMs;
 };
 
-struct TextureCoordinate {
-	float u, v;
-};
+// Tempos de GPU por passe, medias do ultimo segundo
+enum GpuPass { PASS_SHADOW_STATIC, PASS_SHADOW_DYNAMIC, PASS_MAIN, PASS_UPSCALE, PASS_COUNT };
+const char* gpuPassNames[] = { "shadow static", "shadow dynamic", "main", "upscale" };
 
-struct FaceVertex {
-	int vertexIndex, uvIndex, normalIndex;
+struct GpuReport {
+	double passMs[PASS_COUNT] = {};
+	int passFrames[PASS_COUNT] = {};
+	int renderWidth = 0, renderHeight = 0;
 };
 
-struct Material {
+struct StartupStage {
 	string name;
-	float Ns;
-	float Ka[3];
-	float Ks[3];
-	float Ke[3];
-	float Ni;
-	float d;
-	int illum;
-	string map_Kd;
+	vector<string> dependencies;
+	double startMs, endMs;
+	bool mainThread;
 };
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
-void mouse_callback(GLFWwindow* window, double xPos, double yPos);
-Material parseMTL(const string& filename);
-int setupGeometry();
-int loadTexture(string path);
-vector<float> parseObjFile(const string& filename);
+int setupGeometry(const vector<float>& vertices, const vector<GLuint>& indices);
+int loadTexture(const DecodedImage& image);
+bool readAsset(const string& path, AssetData& asset);
+bool hasAsset(const string& path);
+void simulateFrame(GLFWwindow* window, FrameSnapshot& frame, float deltaTime);
+function<void()> startupStage(const string& name, const vector<string>& dependencies, function<void()> task);
+void printStartupReport(double firstFrameMs);
 
 const string objFile = "./textures/Suzanne/SuzanneTriTextured.obj";
 const string mtlFile = "./textures/Suzanne/SuzanneTriTextured.mtl";
+const string archiveFile = "./assets.pak";
+// Saida do Tools/AssetConverter (AssetConverter Camera/textures Camera/converted), usada quando existe
+const string convertedMeshFile = "./converted/suzanne/SuzanneTriTextured.mesh";
+const string convertedTextureFile = "./converted/suzanne/Suzanne.tex";
 const GLuint WIDTH = 1000, HEIGHT = 1000;
-bool isFirstMouseMove = true,
-rotateX,
+const float NEAR_PLANE = 0.1f, FAR_PLANE = 100.0f;
+// Esfera que envolve a cena (chao incluso), usada no enquadramento da luz
+const glm::vec3 sceneCenter(0.0f, -0.5f, 0.0f);
+const float sceneRadius = 6.0f;
+const float FLOOR_HEIGHT = -0.8f, FLOOR_HALF_SIZE = 4.0f;
+// Orcamento de GPU por frame e limites da escala da resolucao dinamica
+const double TARGET_FRAME_MS = 1000.0 / 60.0;
+const float MIN_RESOLUTION_SCALE = 0.5f, MAX_RESOLUTION_SCALE = 1.0f;
+bool rotateX,
 rotateY,
 rotateZ = false;
-float lastX, lastY, sensitivity = 0.05, pitch = 0.0, yaw = -90.0;
-int verticesQty;
-glm::vec3 cameraPos = glm::vec3(0.0, 0.0, 3.0);
-glm::vec3 cameraFront = glm::vec3(0.0, 0.0, -1.0);
-glm::vec3 cameraUp = glm::vec3(0.0, 1.0, 0.0);
-float cameraSpeed = 0.05f;
+MeshletSet meshlets;
+size_t triangleCount;
+glm::mat4 projection;
+bool meshletCulling = true;
+// L gira a luz, M move a Suzanne estatica (os dois invalidam o cache), K liga/desliga o cache, P troca o PCF
+bool orbitLight = false;
+bool shadowCache = true;
+int pcfQuality = 2;
+// R liga/desliga a resolucao dinamica, F alterna entre upscale bilinear e com nitidez
+bool dynamicResolutionEnabled = true;
+bool sharpenUpscale = true;
+// Sob demanda: so simula e desenha quando algo mudou. O alterna com o modo continuo, T liga o limitador
+const double FRAME_LIMIT_FPS = 30.0;
+FrameScheduler scheduler;
+int staticPlacement = 0;
+CameraController camera(glm::vec3(0.0, 0.0, 3.0));
+chrono::steady_clock::time_point startupBegin;
+thread::id mainThreadId;
+mutex startupMutex;
+vector<StartupStage> startupStages;
+AssetArchive archive;
 
 int main()
 {
-	glfwInit();
-	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Camera -- Rafael!", nullptr, nullptr);
-	glfwMakeContextCurrent(window);
-	glfwSetKeyCallback(window, key_callback);
-	glfwSetCursorPosCallback(window, mouse_callback);
-	glfwSetCursorPos(window, WIDTH / 2, HEIGHT / 2);
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	startupBegin = chrono::steady_clock::now();
+	mainThreadId = this_thread::get_id();
+	// Pelo menos dois workers: o trabalho de startup e em boa parte IO e espera do driver
+	JobSystem jobs(max(2, (int)thread::hardware_concurrency() - 1));
+
+	// Com assets.pak (Tools/AssetPacker) tudo vem de um unico arquivo mapeado; sem ele, dos arquivos soltos
+	startupStage("open archive", {}, [&]() {
+		cout << (archive.open(archiveFile) ? "Loading assets from " + archiveFile : string("Loading loose asset files")) << endl;
+	})();
+
+	// Leitura e decodificacao nos workers enquanto a thread principal cria a janela e o contexto
+	vector<float> vertices;
+	vector<GLuint> indices;
+	bool meshOptimized = false;
+	Material material;
+	DecodedImage image;
+	string vertexCode, fragmentCode, shadowVertexCode, shadowFragmentCode, upscaleVertexCode, upscaleFragmentCode;
+	JobCounter meshParsed, meshletsBuilt, materialParsed, textureDecoded, shadersRead, uploaded;
+	jobs.run(startupStage("parse OBJ", { "open archive" }, [&]() {
+		AssetData asset;
+		MeshBinary converted;
+		// O .mesh ja vem indexado e otimizado: so copia os vertices e indices
+		if (hasAsset(convertedMeshFile) && readAsset(convertedMeshFile, asset) && readMeshBinary(asset.data, asset.size, converted)
+			&& converted.stride == OBJ_VERTEX_STRIDE)
+		{
+			vertices.swap(converted.vertices);
+			indices.swap(converted.indices);
+			meshOptimized = true;
+			return;
+		}
+		readAsset(objFile, asset);
+		MemoryStreamBuffer buffer(asset.data, asset.size);
+		istream stream(&buffer);
+		// Normais que faltarem no OBJ sao geradas em paralelo nos outros workers
+		vertices = parseObjFile(stream, &jobs);
+	}), &meshParsed);
+	jobs.run(startupStage("build meshlets", { "parse OBJ" }, [&]() {
+		if (!meshOptimized)
+		{
+			vector<float> interleaved;
+			interleaved.swap(vertices);
+			size_t uniqueCount = indexVertices(interleaved, OBJ_VERTEX_STRIDE, vertices, indices);
+			optimizeVertexCache(indices, uniqueCount);
+			optimizeVertexFetch(vertices, OBJ_VERTEX_STRIDE, indices);
+		}
+		meshlets = buildMeshlets(vertices, OBJ_VERTEX_STRIDE, indices);
+		triangleCount = indices.size() / 3;
+		cout << meshlets.meshlets.size() << " meshlets, " << triangleCount << " triangles, " << vertices.size() / OBJ_VERTEX_STRIDE << " vertices" << endl;
+	}), &meshletsBuilt, &meshParsed);
+	jobs.run(startupStage("parse MTL", { "open archive" }, [&]() {
+		AssetData asset;
+		readAsset(mtlFile, asset);
+		MemoryStreamBuffer buffer(asset.data, asset.size);
+		istream stream(&buffer);
+		material = parseMTL(stream);
+	}), &materialParsed);
+	jobs.run(startupStage("decode texture", { "parse MTL" }, [&]() {
+		AssetData asset;
+		TextureBinary converted;
+		if (hasAsset(convertedTextureFile) && readAsset(convertedTextureFile, asset) && readTextureBinary(asset.data, asset.size, converted)
+			&& !converted.mips.empty())
+		{
+			image.width = converted.width;
+			image.height = converted.height;
+			image.channels = 4;
+			image.pixels.swap(converted.mips[0]);
+			image.mipLevels.assign(make_move_iterator(converted.mips.begin() + 1), make_move_iterator(converted.mips.end()));
+		}
+		else if (readAsset(material.map_Kd, asset))
+		{
+			// PNG suportado vai pelo decodificador SSE2; o resto pelo stb_image
+			if (!decodeImage(asset.data, asset.size, 0, image.pixels, image.width, image.height, image.channels))
+			{
+				cout << "Failed to decode texture " << material.map_Kd << endl;
+				image.pixels.clear();
+			}
+		}
+	}), &textureDecoded, &materialParsed);
+	jobs.run(startupStage("read shaders", { "open archive" }, [&]() {
+		AssetData asset;
+		if (readAsset("./shaders/sprite.vs", asset)) vertexCode = asset.text();
+		if (readAsset("./shaders/sprite.fs", asset)) fragmentCode = asset.text();
+		if (readAsset("./shaders/shadow.vs", asset)) shadowVertexCode = asset.text();
+		if (readAsset("./shaders/shadow.fs", asset)) shadowFragmentCode = asset.text();
+		if (readAsset("./shaders/upscale.vs", asset)) upscaleVertexCode = asset.text();
+		if (readAsset("./shaders/upscale.fs", asset)) upscaleFragmentCode = asset.text();
+	}), &shadersRead);
+
+	GLFWwindow* window;
+	int width, height;
+	bool extensionsLoaded = false;
+	startupStage("create window", {}, [&]() {
+		glfwInit();
+		window = glfwCreateWindow(WIDTH, HEIGHT, "Camera -- Rafael!", nullptr, nullptr);
+		glfwMakeContextCurrent(window);
+		glfwSetKeyCallback(window, key_callback);
+		scheduler.attach(window);
+		glfwSetCursorPos(window, WIDTH / 2, HEIGHT / 2);
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+		{
+			cout << "Failed to initialize GLAD" << endl;
+		}
+		extensionsLoaded = loadGLExtensions();
+		glfwGetFramebufferSize(window, &width, &height);
+		glViewport(0, 0, width, height);
+	})();
+	// glMultiDrawElementsIndirect (RenderQueue) vem do GLExt.h: sem ele o primeiro frame chamaria um ponteiro nulo
+	if (!extensionsLoaded)
 	{
-		cout << "Failed to initialize GLAD" << endl;
+		// Os workers ainda leem os assets para variaveis deste escopo
+		jobs.wait(meshletsBuilt);
+		jobs.wait(textureDecoded);
+		jobs.wait(shadersRead);
+		glfwTerminate();
+		return -1;
 	}
 	const GLubyte* renderer = glGetString(GL_RENDERER);
 	const GLubyte* version = glGetString(GL_VERSION);
 	cout << "Renderer: " << renderer << endl;
 	cout << "OpenGL version supported " << version << endl;
-	int width, height;
-	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-	Shader shader("./shaders/sprite.vs", "./shaders/sprite.fs");
-	GLuint VAO = setupGeometry();
-	glUseProgram(shader.ID);
-	glUniform1i(glGetUniformLocation(shader.ID, "tex_buffer"), 0);
-	glm::mat4 view = glm::lookAt(glm::vec3(0.0, 0.0, 3.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
-	shader.setMat4("view", value_ptr(view));
-	glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 100.0f);
-	shader.setMat4("projection", glm::value_ptr(projection));
+
+	// Uploads na thread do contexto, cada um assim que sua dependencia termina
+	Shader shader, shadowShader, upscaleShader;
+	GLuint VAO = 0, textureId = 0, commandBuffer = 0;
+	GLuint floorVAO = 0, whiteTexture = 0;
+	GLsizei indexCount = 0;
+	CachedShadowMap shadowMap;
+	GpuTimer gpuTimer;
+	DynamicResolution dynamicResolution;
+	jobs.runOnMainThread(startupStage("compile shaders", { "read shaders", "create window" }, [&]() {
+		shader.compile(vertexCode, fragmentCode);
+		shadowShader.compile(shadowVertexCode, shadowFragmentCode);
+		upscaleShader.compile(upscaleVertexCode, upscaleFragmentCode);
+	}), &uploaded, &shadersRead);
+	jobs.runOnMainThread(startupStage("upload mesh", { "build meshlets", "create window" }, [&]() {
+		VAO = setupGeometry(vertices, indices);
+		indexCount = (GLsizei)indices.size();
+		glGenBuffers(1, &commandBuffer);
+	}), &uploaded, &meshletsBuilt);
+	// Chao estatico (textura branca) e os alvos do shadow map
+	startupStage("create shadow map", { "create window" }, [&]() {
+		float h = FLOOR_HALF_SIZE, y = FLOOR_HEIGHT;
+		vector<float> floorVertices = {
+			-h, y, -h, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+			-h, y, h, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+			h, y, h, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+			h, y, -h, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+		};
+		floorVAO = setupGeometry(floorVertices, { 0, 1, 2, 0, 2, 3 });
+		unsigned char white[] = { 255, 255, 255, 255 };
+		glGenTextures(1, &whiteTexture);
+		glBindTexture(GL_TEXTURE_2D, whiteTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		shadowMap.init();
+		gpuTimer.init(PASS_COUNT);
+	})();
+	jobs.runOnMainThread(startupStage("upload texture", { "decode texture", "create window" }, [&]() {
+		textureId = loadTexture(image);
+	}), &uploaded, &textureDecoded);
+	jobs.wait(uploaded);
+
+	startupStage("create render target", { "compile shaders", "create window" }, [&]() {
+		dynamicResolution.minScale = MIN_RESOLUTION_SCALE;
+		dynamicResolution.maxScale = MAX_RESOLUTION_SCALE;
+		dynamicResolution.targetMs = TARGET_FRAME_MS;
+		dynamicResolution.init(width, height, upscaleShader.ID);
+	})();
+
 	glm::mat4 model = glm::mat4(1);
-	model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-	shader.setMat4("model", glm::value_ptr(model));
-	Material material = parseMTL(mtlFile);
-	GLuint textureId = loadTexture(material.map_Kd);
-	shader.setVec3("ka", material.Ka[0], material.Ka[1], material.Ka[2]);
-	shader.setVec3("kd", material.Ke[0], material.Ke[1], material.Ke[2]);
-	shader.setVec3("ks", material.Ks[0], material.Ks[1], material.Ks[2]);
-	shader.setFloat("q", material.Ns);
-	shader.setVec3("lightPosition", 15.0f, 15.0f, 2.0f);
-	shader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
+	startupStage("set uniforms", { "compile shaders", "parse MTL" }, [&]() {
+		glUseProgram(shader.ID);
+		glUniform1i(glGetUniformLocation(shader.ID, "tex_buffer"), 0);
+		glUniform1i(glGetUniformLocation(shader.ID, "shadowMap"), 1);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0, 0.0, 3.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
+		shader.setMat4("view", value_ptr(view));
+		projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, NEAR_PLANE, FAR_PLANE);
+		shader.setMat4("projection", glm::value_ptr(projection));
+		model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+		shader.setMat4("model", glm::value_ptr(model));
+		shader.setVec3("ka", material.Ka[0], material.Ka[1], material.Ka[2]);
+		shader.setVec3("kd", material.Ke[0], material.Ke[1], material.Ke[2]);
+		shader.setVec3("ks", material.Ks[0], material.Ks[1], material.Ks[2]);
+		shader.setFloat("q", material.Ns);
+		shader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
+	})();
 	glEnable(GL_DEPTH_TEST);
+
+	// A thread principal fica com eventos, input e simulacao (GLFW exige eventos nela); o contexto
+	// passa para a thread de render, que consome os snapshots pelo triple buffer
+	TripleBuffer<FrameSnapshot> snapshots;
+	atomic<bool> running(true);
+	unsigned renderedFrames = 0, publishedFrames = 1, presentedFrames = 0;
+	GpuReport gpuReport;
+	mutex frameMutex;
+	condition_variable frameRendered, frameReady;
+	FrameSnapshot& initialFrame = snapshots.writeBuffer();
+	simulateFrame(window, initialFrame, 0.0f);
+	initialFrame.projection = projection;
+	initialFrame.outputWidth = width;
+	initialFrame.outputHeight = height;
+	snapshots.publish();
+	glfwMakeContextCurrent(nullptr);
+	thread renderThread([&]() {
+		glfwMakeContextCurrent(window);
+		bool firstFrame = true;
+		glm::mat4 lastStaticModel(0.0f);
+		GLStateCache glState;
+		RenderQueue renderQueue;
+		GLint modelLocation = glGetUniformLocation(shader.ID, "model");
+		auto gpuReportStart = chrono::steady_clock::now();
+		unsigned consumedFrames = 0;
+		while (true)
+		{
+			// So desenha quando a thread principal publica um snapshot novo
+			{
+				unique_lock<mutex> lock(frameMutex);
+				frameReady.wait(lock, [&]() { return publishedFrames != consumedFrames || !running.load(); });
+				if (!running.load()) break;
+				consumedFrames = publishedFrames;
+			}
+			snapshots.consume();
+			const FrameSnapshot& frame = snapshots.readBuffer();
+			glm::mat4 view = frame.view, model = frame.model, staticModel = frame.staticModel, projectionMatrix = frame.projection;
+			gpuTimer.beginFrame();
+			// Janela redimensionada: a realocacao liga textura e renderbuffer direto no GL
+			if (dynamicResolution.setOutputSize(frame.outputWidth, frame.outputHeight)) glState.invalidate();
+
+			// Sombras: o cache estatico so e refeito quando a luz ou a Suzanne estatica mudam
+			shadowMap.setLight(frame.lightPosition, sceneCenter, sceneRadius);
+			if (!frame.shadowCache || staticModel != lastStaticModel) shadowMap.invalidate();
+			lastStaticModel = staticModel;
+			glState.useProgram(shadowShader.ID);
+			if (shadowMap.needsStaticPass())
+			{
+				gpuTimer.begin(PASS_SHADOW_STATIC);
+				shadowMap.beginStaticPass();
+				glm::mat4 lightSpaceModel = shadowMap.lightSpace;
+				shadowShader.setMat4("lightSpaceModel", value_ptr(lightSpaceModel));
+				glState.bindVertexArray(floorVAO);
+				glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+				lightSpaceModel = shadowMap.lightSpace * staticModel;
+				shadowShader.setMat4("lightSpaceModel", value_ptr(lightSpaceModel));
+				glState.bindVertexArray(VAO);
+				glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+				shadowMap.endPass();
+				gpuTimer.end();
+			}
+			// Objeto dinamico inteiro (o culling dos meshlets e da camera, nao da luz)
+			gpuTimer.begin(PASS_SHADOW_DYNAMIC);
+			shadowMap.beginDynamicPass();
+			glm::mat4 lightSpaceModel = shadowMap.lightSpace * model;
+			shadowShader.setMat4("lightSpaceModel", value_ptr(lightSpaceModel));
+			glState.bindVertexArray(VAO);
+			glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+			shadowMap.endPass();
+			gpuTimer.end();
+
+			// Cena no alvo fora da tela, na resolucao que cabe no orcamento do ultimo frame medido
+			dynamicResolution.enabled = frame.dynamicResolution;
+			dynamicResolution.filter = frame.sharpenUpscale ? UPSCALE_SHARPEN : UPSCALE_BILINEAR;
+			dynamicResolution.update(gpuTimer.lastFrameMs());
+			gpuTimer.begin(PASS_MAIN);
+			dynamicResolution.begin();
+			glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			// Os passes de sombra e o alvo fora da tela ligam framebuffer, viewport e offset direto no GL
+			glState.invalidateFramebuffers();
+			glState.invalidateViewport();
+			glState.invalidateCapability(GL_POLYGON_OFFSET_FILL);
+			glState.bindTexture(GL_TEXTURE1, GL_TEXTURE_2D, shadowMap.depth);
+			glState.lineWidth(10);
+			glState.pointSize(20);
+			glState.useProgram(shader.ID);
+			shader.setMat4("view", value_ptr(view));
+			shader.setMat4("projection", value_ptr(projectionMatrix));
+			shader.setVec3("cameraPos", frame.cameraPos.x, frame.cameraPos.y, frame.cameraPos.z);
+			shader.setVec3("lightPosition", frame.lightPosition.x, frame.lightPosition.y, frame.lightPosition.z);
+			shader.setMat4("lightSpaceMatrix", value_ptr(shadowMap.lightSpace));
+			shader.setInt("pcfRadius", SHADOW_PCF_RADIUS[frame.pcfQuality]);
+			glState.bindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, frame.commands.size() * sizeof(DrawElementsIndirectCommand), frame.commands.data(), GL_STREAM_DRAW);
+			// Os draws vao para a fila e saem ordenados por estado e profundidade
+			auto depthOf = [&](const glm::mat4& objectModel) { return -(view * objectModel[3]).z / FAR_PLANE; };
+			renderQueue.begin(1);
+			RenderQueueBucket& draws = renderQueue.bucket(0);
+			DrawItem item;
+			item.program = shader.ID;
+			item.modelLocation = modelLocation;
+			item.vao = VAO;
+			item.texture = textureId;
+			item.model = model;
+			item.kind = DRAW_ELEMENTS_INDIRECT;
+			item.count = (GLsizei)frame.commands.size();
+			item.indirectBuffer = commandBuffer;
+			draws.submit(makeRenderKey(0, false, item.program, item.texture, item.vao, depthOf(model)), item);
+			item.model = staticModel;
+			item.kind = DRAW_ELEMENTS;
+			item.count = indexCount;
+			draws.submit(makeRenderKey(0, false, item.program, item.texture, item.vao, depthOf(staticModel)), item);
+			item.model = glm::mat4(1.0f);
+			item.vao = floorVAO;
+			item.texture = whiteTexture;
+			item.count = 6;
+			draws.submit(makeRenderKey(0, false, item.program, item.texture, item.vao, depthOf(item.model)), item);
+			renderQueue.sort();
+			renderQueue.execute(glState);
+			glState.endFrame();
+			glState.reportIfDue();
+			gpuTimer.end();
+			gpuTimer.begin(PASS_UPSCALE);
+			dynamicResolution.resolve();
+			// resolve troca programa, VAO, textura da unidade 0, framebuffer e viewport direto no GL
+			glState.invalidateProgram();
+			glState.invalidateVertexArray();
+			glState.invalidateTexture(GL_TEXTURE0);
+			glState.invalidateFramebuffers();
+			glState.invalidateViewport();
+			gpuTimer.end();
+			glfwSwapBuffers(window);
+			if (firstFrame)
+			{
+				printStartupReport(chrono::duration<double, milli>(chrono::steady_clock::now() - startupBegin).count());
+				firstFrame = false;
+			}
+			{
+				lock_guard<mutex> lock(frameMutex);
+				renderedFrames++;
+				if (chrono::steady_clock::now() - gpuReportStart >= chrono::seconds(1))
+				{
+					for (int pass = 0; pass < PASS_COUNT; pass++)
+					{
+						gpuReport.passMs[pass] = gpuTimer.averageMs(pass);
+						gpuReport.passFrames[pass] = gpuTimer.samples(pass);
+					}
+					gpuReport.renderWidth = dynamicResolution.renderWidth;
+					gpuReport.renderHeight = dynamicResolution.renderHeight;
+					gpuTimer.resetAverages();
+					gpuReportStart = chrono::steady_clock::now();
+				}
+			}
+			frameRendered.notify_one();
+		}
+		glfwMakeContextCurrent(nullptr);
+	});
+
+	double lastFrameTime = glfwGetTime();
+	double lastReport = lastFrameTime;
+	int framesSinceReport = 0;
+	size_t meshletsSinceReport = 0, trianglesSinceReport = 0;
+	double cullMsSinceReport = 0.0;
+	glm::mat4 lastView = snapshots.writeBuffer().view;
 	while (!glfwWindowShouldClose(window))
 	{
-		glfwPollEvents();
-		glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glLineWidth(10);
-		glPointSize(20);
-		float angle = (GLfloat)glfwGetTime();
-		model = glm::mat4(1);
-		if (rotateX)
+		// Parado (camera sem movimento, nada girando, sem input) bloqueia ate o proximo evento
+		scheduler.waitEvents();
+		// DIRTY_WINDOW: o callback guardou o novo tamanho (0 com a janela minimizada)
+		if (scheduler.framebufferWidth > 0 && scheduler.framebufferHeight > 0
+			&& (scheduler.framebufferWidth != width || scheduler.framebufferHeight != height))
 		{
-			model = glm::rotate(model, angle, glm::vec3(1.0f, 0.0f, 0.0f));
+			width = scheduler.framebufferWidth;
+			height = scheduler.framebufferHeight;
+			projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, NEAR_PLANE, FAR_PLANE);
 		}
-		else if (rotateY)
+		double currentTime = glfwGetTime();
+		FrameSnapshot& frame = snapshots.writeBuffer();
+		simulateFrame(window, frame, (float)(currentTime - lastFrameTime));
+		frame.projection = projection;
+		frame.outputWidth = width;
+		frame.outputHeight = height;
+		lastFrameTime = currentTime;
+		if (matrixChanged(frame.view, lastView)) scheduler.markDirty(DIRTY_CAMERA);
+		lastView = frame.view;
+		scheduler.setAnimating(rotateX || rotateY || rotateZ || orbitLight);
+		scheduler.reportIfDue();
+		if (!scheduler.shouldRender()) continue;
+		framesSinceReport++;
+		meshletsSinceReport += frame.visibleMeshlets;
+		trianglesSinceReport += frame.visibleTriangles;
+		cullMsSinceReport += frame.cullMs;
+		snapshots.publish();
+		// Lido junto com a publicacao: se o render terminar antes da espera la embaixo, o frame ja conta
+		unsigned seen;
 		{
-			model = glm::rotate(model, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+			lock_guard<mutex> lock(frameMutex);
+			seen = renderedFrames;
+			publishedFrames++;
 		}
-		else if (rotateZ)
+		frameReady.notify_one();
+		scheduler.frameSubmitted();
+		if (currentTime - lastReport >= 1.0)
 		{
-			model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+			cout << "Meshlet culling " << (meshletCulling ? "on" : "off") << ": " << meshletsSinceReport / framesSinceReport << "/" << meshlets.meshlets.size()
+				<< " meshlets, " << trianglesSinceReport / framesSinceReport << "/" << triangleCount << " triangles, "
+				<< cullMsSinceReport / framesSinceReport << " ms cull" << endl;
+			{
+				lock_guard<mutex> lock(frameMutex);
+				int radius = SHADOW_PCF_RADIUS[pcfQuality];
+				cout << "GPU (shadow cache " << (shadowCache ? "on" : "off") << ", PCF " << (2 * radius + 1) * (2 * radius + 1) << " taps):";
+				for (int pass = 0; pass < PASS_COUNT; pass++)
+				{
+					cout << " " << gpuPassNames[pass] << " " << gpuReport.passMs[pass] << " ms x " << gpuReport.passFrames[pass];
+				}
+				cout << ", resolution " << gpuReport.renderWidth << "x" << gpuReport.renderHeight
+					<< (dynamicResolutionEnabled ? " (dynamic, " : " (fixed, ") << (sharpenUpscale ? "sharpen)" : "bilinear)") << endl;
+			}
+			lastReport = currentTime;
+			framesSinceReport = 0;
+			meshletsSinceReport = trianglesSinceReport = 0;
+			cullMsSinceReport = 0.0;
+		}
+		// Simula no maximo um frame a frente do render: espera ele terminar o frame atual
+		unique_lock<mutex> lock(frameMutex);
+		frameRendered.wait_for(lock, chrono::milliseconds(100), [&]() { return renderedFrames != seen; });
+		// O scheduler conta os frames que a thread de render ja trocou na tela
+		if (renderedFrames != presentedFrames)
+		{
+			scheduler.framePresented(renderedFrames - presentedFrames);
+			presentedFrames = renderedFrames;
 		}
-		glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
-		shader.setMat4("view", value_ptr(view));
-		shader.setVec3("cameraPos", cameraPos.x, cameraPos.y, cameraPos.z);
-		model = glm::scale(model, glm::vec3(0.5, 0.5, 0.5));
-		shader.setMat4("model", glm::value_ptr(model));
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textureId);
-		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, verticesQty);
-		glBindVertexArray(0);
-		glfwSwapBuffers(window);
 	}
+	{
+		lock_guard<mutex> lock(frameMutex);
+		running = false;
+	}
+	frameReady.notify_one();
+	renderThread.join();
+	glfwMakeContextCurrent(window);
 	glDeleteVertexArrays(1, &VAO);
+	glDeleteVertexArrays(1, &floorVAO);
+	glDeleteBuffers(1, &commandBuffer);
+	glDeleteTextures(1, &whiteTexture);
+	shadowMap.release();
+	dynamicResolution.release();
+	gpuTimer.release();
 	glfwTerminate();
 	return 0;
 }
 
-int setupGeometry()
+int setupGeometry(const vector<float>& vertices, const vector<GLuint>& indices)
 {
-	vector<float> vertices = parseObjFile(objFile);
-	verticesQty = vertices.size() / 11;
-	GLuint VBO, VAO;
+	GLuint VBO, EBO, VAO;
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
@@ -159,142 +591,187 @@ int setupGeometry()
 	glEnableVertexAttribArray(2);
 	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(GLfloat), (GLvoid*)(8 * sizeof(GLfloat)));
 	glEnableVertexAttribArray(3);
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	return VAO;
 }
 
-vector<float> parseObjFile(const string& filename)
+int loadTexture(const DecodedImage& image)
 {
-	vector<Vertex> vertices;
-	vector<Normal> normals;
-	vector<TextureCoordinate> textures;
-	vector<vector<FaceVertex>> faces;
-	ifstream file(filename);
-	string line;
-	while (getline(file, line))
+	GLuint texID;
+	glGenTextures(1, &texID);
+	glBindTexture(GL_TEXTURE_2D, texID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	if (image.pixels.empty() || image.channels < 1 || image.channels > 4) {
+		cout << "Failed to load texture" << endl;
+		return -1;
+	}
+	// decodeImage devolve os canais do arquivo: cinza e cinza+alfa viram R e RG replicados no swizzle
+	const GLenum formats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+	GLenum format = formats[image.channels - 1];
+	if (image.channels == 1)
 	{
-		if (line.empty() || line[0] == '#') continue;
-		istringstream iss(line);
-		string keyword;
-		iss >> keyword;
-		if (keyword == "v")
-		{
-			Vertex vertex;
-			iss >> vertex.x >> vertex.y >> vertex.z;
-			vertices.push_back(vertex);
-		}
-		else if (keyword == "vn")
-		{
-			Normal normal;
-			iss >> normal.nx >> normal.ny >> normal.nz;
-			normals.push_back(normal);
-		}
-		else if (keyword == "vt")
-		{
-			TextureCoordinate texture;
-			iss >> texture.u >> texture.v;
-			textures.push_back(texture);
-		}
-		else if (keyword == "f")
-		{
-			vector<FaceVertex> faceVertices;
-			string faceVertexStr;
-			while (iss >> faceVertexStr)
-			{
-				istringstream fvIss(faceVertexStr);
-				string vertexIndexStr, uvIndexStr, normalIndexStr;
-				getline(fvIss, vertexIndexStr, '/');
-				getline(fvIss, uvIndexStr, '/');
-				getline(fvIss, normalIndexStr, '/');
-				int vertexIndex = stoi(vertexIndexStr) - 1;
-				int uvIndex = stoi(uvIndexStr) - 1;
-				int normalIndex = stoi(normalIndexStr) - 1;
-				faceVertices.push_back({ vertexIndex, uvIndex, normalIndex });
-			}
-			faces.push_back(faceVertices);
-		}
+		GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
 	}
-	vector<float> vertexArray;
-	for (const auto& faceVertices : faces)
+	else if (image.channels == 2)
 	{
-		for (const auto& fv : faceVertices)
-		{
-			const Vertex& vertex = vertices[fv.vertexIndex];
-			const TextureCoordinate& texture = textures[fv.uvIndex];
-			const Normal& normal = normals[fv.normalIndex];
-			vertexArray.push_back(vertex.x);
-			vertexArray.push_back(vertex.y);
-			vertexArray.push_back(vertex.z);
-			vertexArray.push_back(0.0f);// r
-			vertexArray.push_back(0.0f);// g
-			vertexArray.push_back(0.0f);// b
-			vertexArray.push_back(texture.u);
-			vertexArray.push_back(texture.v);
-			vertexArray.push_back(normal.nx);
-			vertexArray.push_back(normal.ny);
-			vertexArray.push_back(normal.nz);
-		}
+		GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+	}
+	// Linhas de 1 a 3 canais nao sao multiplas de 4 bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	int mipWidth = image.width, mipHeight = image.height;
+	for (size_t level = 0; level < image.mipLevels.size(); level++)
+	{
+		mipWidth = max(1, mipWidth / 2);
+		mipHeight = max(1, mipHeight / 2);
+		glTexImage2D(GL_TEXTURE_2D, (GLint)level + 1, GL_RGBA, mipWidth, mipHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.mipLevels[level].data());
 	}
-	return vertexArray;
+	if (image.mipLevels.empty()) glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return texID;
 }
 
-Material parseMTL(const string& filename)
+void simulateFrame(GLFWwindow* window, FrameSnapshot& frame, float deltaTime)
 {
-	ifstream file(filename);
-	if (!file.is_open()) {
-		cerr << "Failed to open MTL file: " << filename << endl;
-		return {};
+	camera.update(window, deltaTime);
+	float angle = (GLfloat)glfwGetTime();
+	glm::mat4 model = glm::mat4(1);
+	if (rotateX)
+	{
+		model = glm::rotate(model, angle, glm::vec3(1.0f, 0.0f, 0.0f));
 	}
-	Material material;
-	string line;
-	while (getline(file, line)) {
-		istringstream iss(line);
-		string token;
-		iss >> token;
-		if (token == "newmtl") iss >> material.name;
-		if (token == "Ns") iss >> material.Ns;
-		if (token == "Ka") iss >> material.Ka[0] >> material.Ka[1] >> material.Ka[2];
-		if (token == "Ks") iss >> material.Ks[0] >> material.Ks[1] >> material.Ks[2];
-		if (token == "Ke") iss >> material.Ke[0] >> material.Ke[1] >> material.Ke[2];
-		if (token == "Ni") iss >> material.Ni;
-		if (token == "d") iss >> material.d;
-		if (token == "illum") iss >> material.illum;
-		if (token == "map_Kd") iss >> material.map_Kd;
+	else if (rotateY)
+	{
+		model = glm::rotate(model, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+	}
+	else if (rotateZ)
+	{
+		model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
+	}
+	frame.model = glm::scale(model, glm::vec3(0.5, 0.5, 0.5));
+	frame.view = camera.viewMatrix();
+	frame.cameraPos = camera.position;
+	frame.shadowCache = shadowCache;
+	frame.pcfQuality = pcfQuality;
+	frame.dynamicResolution = dynamicResolutionEnabled;
+	frame.sharpenUpscale = sharpenUpscale;
+
+	// Luz girando em volta do eixo y e Suzanne estatica em uma de quatro posicoes ao redor do centro
+	static float lightAngle = 0.0f;
+	if (orbitLight) lightAngle += deltaTime * 0.5f;
+	frame.lightPosition = glm::vec3(glm::rotate(glm::mat4(1), lightAngle, glm::vec3(0.0f, 1.0f, 0.0f)) * glm::vec4(15.0f, 15.0f, 2.0f, 1.0f));
+	glm::mat4 placement = glm::rotate(glm::mat4(1), glm::radians(90.0f) * staticPlacement, glm::vec3(0.0f, 1.0f, 0.0f));
+	frame.staticModel = glm::scale(glm::translate(placement, glm::vec3(-1.6f, -0.4f, -1.2f)), glm::vec3(0.4f));
+
+	// Culling dos meshlets no espaco do objeto (o modelo so tem rotacao e escala uniforme)
+	auto cullStart = chrono::steady_clock::now();
+	static vector<uint8_t> visible;
+	if (meshletCulling)
+	{
+		Frustum frustum = Frustum::fromMatrix(projection * frame.view * frame.model);
+		glm::vec3 localCamera = glm::vec3(glm::inverse(frame.model) * glm::vec4(camera.position, 1.0f));
+		frame.visibleMeshlets = cullMeshlets(meshlets, frustum.planes, localCamera, visible);
 	}
-	return material;
+	else
+	{
+		visible.assign(meshlets.meshlets.size(), 1);
+		frame.visibleMeshlets = meshlets.meshlets.size();
+	}
+	frame.commands.clear();
+	frame.visibleTriangles = appendMeshletDraws(meshlets, visible, frame.commands);
+	frame.cullMs = chrono::duration<double, milli>(chrono::steady_clock::now() - cullStart).count();
 }
 
-int loadTexture(string path)
+// Do assets.pak (sem copia se a entrada nao estiver comprimida) ou do arquivo solto
+bool readAsset(const string& path, AssetData& asset)
 {
-	GLuint texID;
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	int width, height, nrChannels;
-	unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-	bool isPng = nrChannels != 3;
-	if (!data) {
-		cout << "Failed to load texture" << endl;
-		return -1;
+	return readAsset(archive, path, asset);
+}
+
+// Sem mensagem de erro: os binarios convertidos sao opcionais
+bool hasAsset(const string& path)
+{
+	if (archive.isOpen()) return archive.find(path) != nullptr;
+	return ifstream(path, ios::binary).is_open();
+}
+
+function<void()> startupStage(const string& name, const vector<string>& dependencies, function<void()> task)
+{
+	return [name, dependencies, task]() {
+		double start = chrono::duration<double, milli>(chrono::steady_clock::now() - startupBegin).count();
+		task();
+		double end = chrono::duration<double, milli>(chrono::steady_clock::now() - startupBegin).count();
+		lock_guard<mutex> lock(startupMutex);
+		startupStages.push_back({ name, dependencies, start, end, this_thread::get_id() == mainThreadId });
+	};
+}
+
+void printStartupReport(double firstFrameMs)
+{
+	lock_guard<mutex> lock(startupMutex);
+	sort(startupStages.begin(), startupStages.end(), [](const StartupStage& a, const StartupStage& b) { return a.startMs < b.startMs; });
+	cout << "Time to first frame: " << firstFrameMs << " ms" << endl;
+	for (const StartupStage& stage : startupStages)
+	{
+		cout << "  " << stage.name << string(max(1, 16 - (int)stage.name.size()), ' ') << (stage.mainThread ? "main  " : "worker")
+			<< " " << stage.startMs << " -> " << stage.endMs << " ms (" << stage.endMs - stage.startMs << " ms)" << endl;
 	}
-	isPng
-		? glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data)
-		: glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-	glGenerateMipmap(GL_TEXTURE_2D);
-	stbi_image_free(data);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	return texID;
+	// Caminho critico: a partir do ultimo estagio, volta sempre pelo predecessor que terminou mais tarde
+	// (dependencias declaradas e, na thread principal, o estagio anterior na mesma thread)
+	vector<string> path;
+	const StartupStage* current = nullptr;
+	for (const StartupStage& stage : startupStages)
+	{
+		if (!current || stage.endMs > current->endMs) current = &stage;
+	}
+	while (current)
+	{
+		path.push_back(current->name);
+		const StartupStage* previous = nullptr;
+		for (const StartupStage& stage : startupStages)
+		{
+			bool isDependency = find(current->dependencies.begin(), current->dependencies.end(), stage.name) != current->dependencies.end();
+			bool sameThreadBefore = current->mainThread && stage.mainThread && stage.endMs <= current->startMs;
+			if ((isDependency || sameThreadBefore) && (!previous || stage.endMs > previous->endMs)) previous = &stage;
+		}
+		current = previous;
+	}
+	cout << "  critical path:";
+	for (auto it = path.rbegin(); it != path.rend(); ++it)
+	{
+		cout << (it == path.rbegin() ? " " : " -> ") << *it;
+	}
+	cout << " -> first frame" << endl;
 }
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode)
 {
 	if (action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_INPUT);
 		if (key == GLFW_KEY_ESCAPE) glfwSetWindowShouldClose(window, GL_TRUE);
+		if (key == GLFW_KEY_O) scheduler.onDemand = !scheduler.onDemand;
+		if (key == GLFW_KEY_T) scheduler.frameLimit = scheduler.frameLimit > 0.0 ? 0.0 : FRAME_LIMIT_FPS;
+		if (key == GLFW_KEY_M || key == GLFW_KEY_X || key == GLFW_KEY_Y || key == GLFW_KEY_Z) scheduler.markDirty(DIRTY_TRANSFORM);
+		if (key == GLFW_KEY_P || key == GLFW_KEY_K || key == GLFW_KEY_R || key == GLFW_KEY_F) scheduler.markDirty(DIRTY_MATERIAL);
+		if (key == GLFW_KEY_C) meshletCulling = !meshletCulling;
+		if (key == GLFW_KEY_L) orbitLight = !orbitLight;
+		if (key == GLFW_KEY_M) staticPlacement = (staticPlacement + 1) % 4;
+		if (key == GLFW_KEY_K) shadowCache = !shadowCache;
+		if (key == GLFW_KEY_P) pcfQuality = (pcfQuality + 1) % SHADOW_PCF_LEVELS;
+		if (key == GLFW_KEY_R) dynamicResolutionEnabled = !dynamicResolutionEnabled;
+		if (key == GLFW_KEY_F) sharpenUpscale = !sharpenUpscale;
 		if (key == GLFW_KEY_X)
 		{
 			rotateX = true;
@@ -314,34 +791,4 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 			rotateZ = true;
 		}
 	}
-	if (action == GLFW_REPEAT)
-	{
-		if (key == GLFW_KEY_W) cameraPos += cameraFront * cameraSpeed;
-		if (key == GLFW_KEY_A) cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
-		if (key == GLFW_KEY_S) cameraPos -= cameraFront * cameraSpeed;
-		if (key == GLFW_KEY_D) cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
-	}
-}
-
-void mouse_callback(GLFWwindow* window, double xPos, double yPos)
-{
-	if (isFirstMouseMove)
-	{
-		lastX = xPos;
-		lastY = yPos;
-		isFirstMouseMove = false;
-	}
-	float offsetX = xPos - lastX;
-	float offsetY = lastY - yPos;
-	lastX = xPos;
-	lastY = yPos;
-	offsetX *= sensitivity;
-	offsetY *= sensitivity;
-	pitch += offsetY;
-	yaw += offsetX;
-	glm::vec3 front;
-	front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-	front.y = sin(glm::radians(pitch));
-	front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-	cameraFront = glm::normalize(front);
 }
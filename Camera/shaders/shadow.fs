@@ -0,0 +1,6 @@
+#version 450
+
+// So profundidade
+void main()
+{
+}
@@ -0,0 +1,10 @@
+#version 450
+
+layout (location = 0) in vec3 position;
+
+uniform mat4 lightSpaceModel;
+
+void main()
+{
+    gl_Position = lightSpaceModel * vec4(position, 1.0);
+}
@@ -4,6 +4,7 @@ in vec3 finalColor;
 in vec3 scaledNormal;
 in vec2 textureCoord;
 in vec3 fragmentPosition;
+in vec4 lightSpacePosition;
 
 uniform vec3 lightColor;
 uniform vec3 lightPosition;
@@ -14,9 +15,30 @@ uniform float q;
 
 uniform vec3 cameraPos;
 uniform sampler2D tex_buffer;
+uniform sampler2DShadow shadowMap;
+uniform int pcfRadius;
 
 out vec4 color;
 
+// Fracao iluminada: media de (2 * pcfRadius + 1)^2 comparacoes, cada uma filtrada 2x2 pelo hardware
+float shadowFactor(vec3 N, vec3 L)
+{
+	vec3 p = lightSpacePosition.xyz / lightSpacePosition.w * 0.5 + 0.5;
+	if (p.z > 1.0) return 1.0;
+	float bias = max(0.002 * (1.0 - dot(N, L)), 0.0005);
+	vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0));
+	float lit = 0.0;
+	for (int y = -pcfRadius; y <= pcfRadius; y++)
+	{
+		for (int x = -pcfRadius; x <= pcfRadius; x++)
+		{
+			lit += texture(shadowMap, vec3(p.xy + vec2(x, y) * texel, p.z - bias));
+		}
+	}
+	float taps = float(2 * pcfRadius + 1);
+	return lit / (taps * taps);
+}
+
 void main()
 {
 	vec3 ambient = ka * lightColor;
@@ -32,8 +54,9 @@ void main()
 	spec = pow(spec, q);
 	vec3 specular = ks * spec * lightColor;
 
+	float shadow = shadowFactor(N, L);
 	vec3 texColor = texture(tex_buffer, textureCoord).xyz;
-	vec3 result = (ambient + diffuse) * texColor + specular;
+	vec3 result = (ambient + shadow * diffuse) * texColor + shadow * specular;
 
 	color = vec4(result, 1.0f);
 }
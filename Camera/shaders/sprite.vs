@@ -8,17 +8,20 @@ layout (location = 3) in vec3 normal;
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform mat4 lightSpaceMatrix;
 
 out vec3 finalColor;
 out vec3 scaledNormal;
 out vec2 textureCoord;
 out vec3 fragmentPosition;
+out vec4 lightSpacePosition;
 
 void main()
 {
     gl_Position = projection * view * model * vec4(position, 1.0);
     finalColor = color;
-    scaledNormal = normal;
+    scaledNormal = mat3(model) * normal;
     textureCoord = vec2(tex_coord.x, 1 - tex_coord.y);
     fragmentPosition = vec3(model * vec4(position, 1.0));
+    lightSpacePosition = lightSpaceMatrix * vec4(fragmentPosition, 1.0);
 }
\ No newline at end of file
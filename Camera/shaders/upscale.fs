@@ -0,0 +1,29 @@
+#version 450
+
+in vec2 uv;
+
+uniform sampler2D scene;
+uniform vec2 uvScale;
+uniform vec2 texelSize;
+uniform int sharpen;
+uniform float sharpness;
+
+out vec4 color;
+
+void main()
+{
+	// So a parte renderizada da textura: nao deixa o filtro pegar texels de fora
+	vec2 uvMax = uvScale - texelSize * 0.5;
+	vec2 p = min(uv, uvMax);
+	vec3 center = texture(scene, p).rgb;
+	if (sharpen == 1)
+	{
+		// Mascara de nitidez com os 4 vizinhos, para compensar o borrado do bilinear
+		vec3 neighbors = texture(scene, min(p + vec2(texelSize.x, 0.0), uvMax)).rgb
+			+ texture(scene, max(p - vec2(texelSize.x, 0.0), vec2(0.0))).rgb
+			+ texture(scene, min(p + vec2(0.0, texelSize.y), uvMax)).rgb
+			+ texture(scene, max(p - vec2(0.0, texelSize.y), vec2(0.0))).rgb;
+		center = clamp(center + sharpness * (4.0 * center - neighbors), 0.0, 1.0);
+	}
+	color = vec4(center, 1.0);
+}
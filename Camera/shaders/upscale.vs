@@ -0,0 +1,13 @@
+#version 450
+
+uniform vec2 uvScale;
+
+out vec2 uv;
+
+// Triangulo que cobre a tela inteira, sem vertex buffer
+void main()
+{
+    vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    uv = corner * uvScale;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,436 @@
+// Arquivo de assets empacotados (.pak): um unico arquivo mapeado em memoria com todos os
+// meshes, texturas e shaders, em vez de centenas de open()/read() no startup.
+//
+// Layout (little endian):
+//   ArchiveHeader
+//   blobs, cada um alinhado em ARCHIVE_ALIGNMENT bytes
+//   tabela de conteudo: ArchiveEntry[entryCount], ordenada por nameHash para busca binaria
+//   nomes: strings terminadas em zero (so para listar / conferir colisao de hash)
+//
+// Entradas sem compressao sao lidas sem copia: AssetData aponta direto para o mapeamento.
+// Entradas com ARCHIVE_COMPRESSION_LZ4 sao descomprimidas para AssetData::storage.
+// Os nomes passam por normalizeAssetPath, entao "./textures/Suzanne/x.obj" e
+// "textures\\suzanne\\x.obj" acham a mesma entrada.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <streambuf>
+#include <iterator>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cctype>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Lz4.h"
+
+using namespace std;
+
+const char ARCHIVE_MAGIC[8] = { 'A', 'C', 'G', 'P', 'A', 'K', '\0', '\0' };
+const uint32_t ARCHIVE_VERSION = 1;
+const uint64_t ARCHIVE_ALIGNMENT = 64;
+const uint32_t ARCHIVE_COMPRESSION_NONE = 0;
+const uint32_t ARCHIVE_COMPRESSION_LZ4 = 1;
+// Fracao minima economizada para guardar em LZ4: abaixo disso a entrada fica sem compressao e
+// continua sendo lida sem copia (PNG/JPG ja comprimidos quase nunca passam)
+const double ARCHIVE_MIN_COMPRESSION_SAVING = 0.10;
+
+struct ArchiveHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t entryCount;
+	uint64_t tocOffset;
+	uint64_t namesOffset;
+};
+
+struct ArchiveEntry {
+	uint64_t nameHash;
+	// Hash do conteudo descomprimido
+	uint64_t contentHash;
+	uint64_t offset;
+	uint64_t storedSize;
+	uint64_t size;
+	uint32_t compression;
+	uint32_t nameOffset;
+};
+
+// FNV-1a 64 bits
+inline uint64_t hashBytes(const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Minusculas, '/' como separador, sem "." e resolvendo ".." (os que sobrarem no inicio sao
+// descartados: a raiz do arquivo e a pasta base usada no empacotamento)
+inline string normalizeAssetPath(const string& path)
+{
+	vector<string> parts;
+	string part;
+	for (size_t i = 0; i <= path.size(); i++)
+	{
+		char c = i < path.size() ? path[i] : '/';
+		if (c == '/' || c == '\\')
+		{
+			if (part == "..")
+			{
+				if (!parts.empty()) parts.pop_back();
+			}
+			else if (!part.empty() && part != ".")
+			{
+				parts.push_back(part);
+			}
+			part.clear();
+		}
+		else
+		{
+			part += (char)tolower((unsigned char)c);
+		}
+	}
+	string normalized;
+	for (const string& p : parts)
+	{
+		if (!normalized.empty()) normalized += '/';
+		normalized += p;
+	}
+	return normalized;
+}
+
+// Arquivo mapeado somente leitura
+class MappedFile
+{
+public:
+	MappedFile() {}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { close(); }
+
+	bool open(const string& path)
+	{
+		close();
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(file, &fileSize);
+		size = (size_t)fileSize.QuadPart;
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+		{
+			close();
+			return false;
+		}
+		data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		descriptor = ::open(path.c_str(), O_RDONLY);
+		if (descriptor < 0) return false;
+		struct stat info;
+		fstat(descriptor, &info);
+		size = (size_t)info.st_size;
+		void* address = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0) : MAP_FAILED;
+		data = address == MAP_FAILED ? nullptr : (const unsigned char*)address;
+#endif
+		if (!data)
+		{
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close()
+	{
+#ifdef _WIN32
+		if (data) UnmapViewOfFile(data);
+		if (mapping) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (data) munmap((void*)data, size);
+		if (descriptor >= 0) ::close(descriptor);
+		descriptor = -1;
+#endif
+		data = nullptr;
+		size = 0;
+	}
+
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+
+private:
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int descriptor = -1;
+#endif
+};
+
+// Bytes de um asset: aponta para o mapeamento (sem copia) ou para storage (descomprimido)
+struct AssetData {
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+	vector<unsigned char> storage;
+
+	string text() const { return string((const char*)data, size); }
+};
+
+// streambuf sobre memoria, para os parsers baseados em istream lerem direto do mapeamento
+class MemoryStreamBuffer : public streambuf
+{
+public:
+	MemoryStreamBuffer(const unsigned char* data, size_t size)
+	{
+		char* begin = (char*)data;
+		setg(begin, begin, begin + size);
+	}
+};
+
+class AssetArchive
+{
+public:
+	bool open(const string& path)
+	{
+		entries = nullptr;
+		entryCount = 0;
+		if (!file.open(path)) return false;
+		if (file.size < sizeof(ArchiveHeader))
+		{
+			cout << "ERROR::ASSET_ARCHIVE::TRUNCATED " << path << endl;
+			return false;
+		}
+		ArchiveHeader header;
+		memcpy(&header, file.data, sizeof(header));
+		if (memcmp(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0 || header.version != ARCHIVE_VERSION
+			|| header.tocOffset + (uint64_t)header.entryCount * sizeof(ArchiveEntry) > file.size || header.namesOffset > file.size)
+		{
+			cout << "ERROR::ASSET_ARCHIVE::INVALID_HEADER " << path << endl;
+			file.close();
+			return false;
+		}
+		entries = (const ArchiveEntry*)(file.data + header.tocOffset);
+		entryCount = header.entryCount;
+		names = (const char*)(file.data + header.namesOffset);
+		namesSize = file.size - header.namesOffset;
+		return true;
+	}
+
+	bool isOpen() const { return entries != nullptr; }
+
+	const ArchiveEntry* find(const string& path) const
+	{
+		string name = normalizeAssetPath(path);
+		uint64_t hash = hashBytes(name.data(), name.size());
+		const ArchiveEntry* end = entries + entryCount;
+		const ArchiveEntry* entry = lower_bound(entries, end, hash,
+			[](const ArchiveEntry& e, uint64_t h) { return e.nameHash < h; });
+		for (; entry != end && entry->nameHash == hash; ++entry)
+		{
+			if (entry->nameOffset < namesSize && name == names + entry->nameOffset) return entry;
+		}
+		return nullptr;
+	}
+
+	// Le um asset; com verifyHash confere o hash do conteudo (custa uma passada nos bytes)
+	bool read(const string& path, AssetData& asset, bool verifyHash = false) const
+	{
+		const ArchiveEntry* entry = find(path);
+		if (!entry)
+		{
+			cout << "ERROR::ASSET_ARCHIVE::NOT_FOUND " << path << endl;
+			return false;
+		}
+		return read(*entry, asset, verifyHash);
+	}
+
+	bool read(const ArchiveEntry& entry, AssetData& asset, bool verifyHash = false) const
+	{
+		if (entry.offset + entry.storedSize > file.size) return false;
+		const unsigned char* stored = file.data + entry.offset;
+		if (entry.compression == ARCHIVE_COMPRESSION_NONE)
+		{
+			asset.storage.clear();
+			asset.data = stored;
+			asset.size = (size_t)entry.size;
+		}
+		else if (entry.compression == ARCHIVE_COMPRESSION_LZ4)
+		{
+			asset.storage.resize((size_t)entry.size);
+			if (!lz4Decompress(stored, (size_t)entry.storedSize, asset.storage.data(), asset.storage.size()))
+			{
+				cout << "ERROR::ASSET_ARCHIVE::CORRUPT_BLOCK " << nameOf(entry) << endl;
+				return false;
+			}
+			asset.data = asset.storage.data();
+			asset.size = asset.storage.size();
+		}
+		else
+		{
+			return false;
+		}
+		if (verifyHash && hashBytes(asset.data, asset.size) != entry.contentHash)
+		{
+			cout << "ERROR::ASSET_ARCHIVE::HASH_MISMATCH " << nameOf(entry) << endl;
+			return false;
+		}
+		return true;
+	}
+
+	const ArchiveEntry* begin() const { return entries; }
+	const ArchiveEntry* end() const { return entries + entryCount; }
+	uint32_t size() const { return entryCount; }
+
+	string nameOf(const ArchiveEntry& entry) const
+	{
+		return entry.nameOffset < namesSize ? string(names + entry.nameOffset) : string();
+	}
+
+private:
+	MappedFile file;
+	const ArchiveEntry* entries = nullptr;
+	uint32_t entryCount = 0;
+	const char* names = nullptr;
+	size_t namesSize = 0;
+};
+
+// Do .pak (sem copia se a entrada nao estiver comprimida) ou, com o arquivo fechado, do arquivo solto
+inline bool readAsset(const AssetArchive& archive, const string& path, AssetData& asset)
+{
+	if (archive.isOpen())
+	{
+		return archive.read(path, asset);
+	}
+	ifstream file(path, ios::binary);
+	if (!file.is_open()) {
+		cerr << "Failed to open file: " << path << endl;
+		asset.data = nullptr;
+		asset.size = 0;
+		return false;
+	}
+	asset.storage.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+	asset.data = asset.storage.data();
+	asset.size = asset.storage.size();
+	return true;
+}
+
+// Monta um .pak a partir de buffers em memoria (usado pelo AssetPacker)
+class AssetArchiveWriter
+{
+public:
+	// Com compress, guarda em LZ4 so se economizar ARCHIVE_MIN_COMPRESSION_SAVING. Nomes que
+	// normalizam para o mesmo caminho com o mesmo conteudo sao ignorados; com conteudo diferente
+	// (ou outro nome com o mesmo hash) a entrada e rejeitada e add retorna false
+	bool add(const string& path, const vector<unsigned char>& content, bool compress)
+	{
+		PendingEntry pending;
+		pending.name = normalizeAssetPath(path);
+		pending.entry.nameHash = hashBytes(pending.name.data(), pending.name.size());
+		uint64_t contentHash = hashBytes(content.data(), content.size());
+		for (const PendingEntry& existing : pendingEntries)
+		{
+			if (existing.entry.nameHash != pending.entry.nameHash) continue;
+			if (existing.name == pending.name && existing.entry.contentHash == contentHash) return true;
+			cout << "ERROR::ASSET_ARCHIVE::NAME_COLLISION " << path << " (" << pending.name << ") and " << existing.name << endl;
+			return false;
+		}
+		pending.entry.contentHash = contentHash;
+		pending.entry.size = content.size();
+		pending.entry.compression = ARCHIVE_COMPRESSION_NONE;
+		if (compress && !content.empty())
+		{
+			lz4Compress(content.data(), content.size(), pending.stored);
+			if (pending.stored.size() <= content.size() * (1.0 - ARCHIVE_MIN_COMPRESSION_SAVING))
+			{
+				pending.entry.compression = ARCHIVE_COMPRESSION_LZ4;
+			}
+		}
+		if (pending.entry.compression == ARCHIVE_COMPRESSION_NONE) pending.stored = content;
+		pending.entry.storedSize = pending.stored.size();
+		pending.entry.offset = 0;
+		pending.entry.nameOffset = 0;
+		pendingEntries.push_back(move(pending));
+		return true;
+	}
+
+	bool write(const string& path)
+	{
+		sort(pendingEntries.begin(), pendingEntries.end(),
+			[](const PendingEntry& a, const PendingEntry& b) { return a.entry.nameHash < b.entry.nameHash; });
+		ofstream out(path, ios::binary);
+		if (!out) return false;
+		ArchiveHeader header;
+		memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+		header.version = ARCHIVE_VERSION;
+		header.entryCount = (uint32_t)pendingEntries.size();
+		uint64_t position = align(sizeof(ArchiveHeader));
+		string nameBlock;
+		for (PendingEntry& pending : pendingEntries)
+		{
+			pending.entry.offset = position;
+			position = align(position + pending.entry.storedSize);
+			pending.entry.nameOffset = (uint32_t)nameBlock.size();
+			nameBlock += pending.name;
+			nameBlock += '\0';
+		}
+		header.tocOffset = position;
+		header.namesOffset = header.tocOffset + pendingEntries.size() * sizeof(ArchiveEntry);
+
+		out.write((const char*)&header, sizeof(header));
+		pad(out, align(sizeof(ArchiveHeader)) - sizeof(ArchiveHeader));
+		for (const PendingEntry& pending : pendingEntries)
+		{
+			out.write((const char*)pending.stored.data(), pending.stored.size());
+			pad(out, align(pending.entry.offset + pending.entry.storedSize) - (pending.entry.offset + pending.entry.storedSize));
+		}
+		for (const PendingEntry& pending : pendingEntries)
+		{
+			out.write((const char*)&pending.entry, sizeof(ArchiveEntry));
+		}
+		out.write(nameBlock.data(), nameBlock.size());
+		return (bool)out;
+	}
+
+private:
+	struct PendingEntry {
+		string name;
+		ArchiveEntry entry;
+		vector<unsigned char> stored;
+	};
+	vector<PendingEntry> pendingEntries;
+
+	static uint64_t align(uint64_t value)
+	{
+		return (value + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+	}
+
+	static void pad(ofstream& out, uint64_t count)
+	{
+		static const char zeros[ARCHIVE_ALIGNMENT] = {};
+		out.write(zeros, (streamsize)count);
+	}
+};
@@ -0,0 +1,267 @@
+// Formatos binarios prontos para upload gerados pelo AssetConverter:
+//   .mesh  vertices intercalados (OBJ_VERTEX_STRIDE floats) ja indexados e otimizados + indices
+//          de 16 ou 32 bits, direto para glBufferData;
+//   .tex   RGBA8 com a cadeia de mipmaps inteira, um glTexImage2D por nivel;
+//   .mat   os campos do MTL em uma struct de tamanho fixo.
+// Mesh e textura comecam com um header fixo seguido do payload, opcionalmente em LZ4.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+#include "Lz4.h"
+#include "ObjLoader.h"
+
+using namespace std;
+
+const uint32_t MESH_BINARY_MAGIC = 0x4853454D; // "MESH"
+const uint32_t TEXTURE_BINARY_MAGIC = 0x52584554; // "TEXR"
+const uint32_t MATERIAL_BINARY_MAGIC = 0x5254414D; // "MATR"
+const uint32_t ASSET_BINARY_VERSION = 1;
+const uint32_t PAYLOAD_RAW = 0;
+const uint32_t PAYLOAD_LZ4 = 1;
+
+struct MeshBinaryHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	// Floats por vertice e bytes por indice (2 ou 4)
+	uint32_t stride;
+	uint32_t indexSize;
+	float aabbMin[3];
+	float aabbMax[3];
+	uint32_t compression;
+	uint32_t padding;
+	uint64_t payloadSize;
+	uint64_t storedSize;
+};
+
+struct TextureBinaryHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	// Sempre 4 (RGBA8)
+	uint32_t channels;
+	uint32_t mipCount;
+	uint32_t compression;
+	uint32_t padding;
+	uint64_t payloadSize;
+	uint64_t storedSize;
+};
+
+struct MaterialBinary {
+	uint32_t magic;
+	uint32_t version;
+	float Ns;
+	float Ka[3];
+	float Ks[3];
+	float Ke[3];
+	float Ni;
+	float d;
+	int32_t illum;
+	char name[64];
+	char map_Kd[256];
+};
+
+struct MeshBinary {
+	vector<float> vertices;
+	vector<uint32_t> indices;
+	uint32_t stride = OBJ_VERTEX_STRIDE;
+	float aabbMin[3];
+	float aabbMax[3];
+};
+
+struct TextureBinary {
+	int width = 0, height = 0;
+	// Nivel 0 primeiro; largura e altura caem pela metade (minimo 1) a cada nivel
+	vector<vector<unsigned char>> mips;
+};
+
+// Acrescenta header + payload (comprimido se compress e se ficar menor) em out
+template<typename Header>
+inline void writeAssetBinary(Header header, const vector<unsigned char>& payload, bool compress, vector<unsigned char>& out)
+{
+	vector<unsigned char> stored;
+	header.compression = PAYLOAD_RAW;
+	if (compress && !payload.empty())
+	{
+		lz4Compress(payload.data(), payload.size(), stored);
+		if (stored.size() < payload.size()) header.compression = PAYLOAD_LZ4;
+	}
+	const vector<unsigned char>& body = header.compression == PAYLOAD_LZ4 ? stored : payload;
+	header.payloadSize = payload.size();
+	header.storedSize = body.size();
+	const unsigned char* headerBytes = (const unsigned char*)&header;
+	out.insert(out.end(), headerBytes, headerBytes + sizeof(Header));
+	out.insert(out.end(), body.begin(), body.end());
+}
+
+template<typename Header>
+inline bool readAssetBinary(const unsigned char* data, size_t size, uint32_t magic, Header& header, vector<unsigned char>& payload)
+{
+	if (size < sizeof(Header)) return false;
+	memcpy(&header, data, sizeof(Header));
+	if (header.magic != magic || header.version != ASSET_BINARY_VERSION || sizeof(Header) + header.storedSize > size) return false;
+	const unsigned char* body = data + sizeof(Header);
+	payload.resize((size_t)header.payloadSize);
+	if (header.compression == PAYLOAD_LZ4)
+	{
+		return lz4Decompress(body, (size_t)header.storedSize, payload.data(), payload.size());
+	}
+	if (header.storedSize != header.payloadSize) return false;
+	if (!payload.empty()) memcpy(payload.data(), body, payload.size());
+	return true;
+}
+
+inline void writeMeshBinary(const MeshBinary& mesh, bool compress, vector<unsigned char>& out)
+{
+	MeshBinaryHeader header = {};
+	header.magic = MESH_BINARY_MAGIC;
+	header.version = ASSET_BINARY_VERSION;
+	header.stride = mesh.stride;
+	header.vertexCount = (uint32_t)(mesh.vertices.size() / mesh.stride);
+	header.indexCount = (uint32_t)mesh.indices.size();
+	header.indexSize = header.vertexCount <= 65536 ? 2 : 4;
+	memcpy(header.aabbMin, mesh.aabbMin, sizeof(header.aabbMin));
+	memcpy(header.aabbMax, mesh.aabbMax, sizeof(header.aabbMax));
+	vector<unsigned char> payload(mesh.vertices.size() * sizeof(float) + mesh.indices.size() * header.indexSize);
+	memcpy(payload.data(), mesh.vertices.data(), mesh.vertices.size() * sizeof(float));
+	unsigned char* indexBytes = payload.data() + mesh.vertices.size() * sizeof(float);
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		if (header.indexSize == 2)
+		{
+			uint16_t index = (uint16_t)mesh.indices[i];
+			memcpy(indexBytes + i * 2, &index, 2);
+		}
+		else
+		{
+			memcpy(indexBytes + i * 4, &mesh.indices[i], 4);
+		}
+	}
+	writeAssetBinary(header, payload, compress, out);
+}
+
+inline bool readMeshBinary(const unsigned char* data, size_t size, MeshBinary& mesh)
+{
+	MeshBinaryHeader header;
+	vector<unsigned char> payload;
+	if (!readAssetBinary(data, size, MESH_BINARY_MAGIC, header, payload)) return false;
+	size_t vertexBytes = (size_t)header.vertexCount * header.stride * sizeof(float);
+	if (payload.size() != vertexBytes + (size_t)header.indexCount * header.indexSize) return false;
+	mesh.stride = header.stride;
+	memcpy(mesh.aabbMin, header.aabbMin, sizeof(mesh.aabbMin));
+	memcpy(mesh.aabbMax, header.aabbMax, sizeof(mesh.aabbMax));
+	mesh.vertices.resize((size_t)header.vertexCount * header.stride);
+	if (vertexBytes > 0) memcpy(mesh.vertices.data(), payload.data(), vertexBytes);
+	mesh.indices.resize(header.indexCount);
+	const unsigned char* indexBytes = payload.data() + vertexBytes;
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		if (header.indexSize == 2)
+		{
+			uint16_t index;
+			memcpy(&index, indexBytes + i * 2, 2);
+			mesh.indices[i] = index;
+		}
+		else
+		{
+			memcpy(&mesh.indices[i], indexBytes + i * 4, 4);
+		}
+	}
+	return true;
+}
+
+inline void writeTextureBinary(const TextureBinary& texture, bool compress, vector<unsigned char>& out)
+{
+	TextureBinaryHeader header = {};
+	header.magic = TEXTURE_BINARY_MAGIC;
+	header.version = ASSET_BINARY_VERSION;
+	header.width = texture.width;
+	header.height = texture.height;
+	header.channels = 4;
+	header.mipCount = (uint32_t)texture.mips.size();
+	vector<unsigned char> payload;
+	for (const vector<unsigned char>& mip : texture.mips)
+	{
+		payload.insert(payload.end(), mip.begin(), mip.end());
+	}
+	writeAssetBinary(header, payload, compress, out);
+}
+
+inline bool readTextureBinary(const unsigned char* data, size_t size, TextureBinary& texture)
+{
+	TextureBinaryHeader header;
+	vector<unsigned char> payload;
+	if (!readAssetBinary(data, size, TEXTURE_BINARY_MAGIC, header, payload) || header.channels != 4) return false;
+	texture.width = header.width;
+	texture.height = header.height;
+	texture.mips.clear();
+	size_t offset = 0;
+	int width = texture.width, height = texture.height;
+	for (uint32_t level = 0; level < header.mipCount; level++)
+	{
+		size_t bytes = (size_t)width * height * 4;
+		if (offset + bytes > payload.size()) return false;
+		texture.mips.emplace_back(payload.begin() + offset, payload.begin() + offset + bytes);
+		offset += bytes;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	return true;
+}
+
+// Gera a cadeia de mipmaps (filtro caixa 2x2) a partir de um RGBA8
+inline void buildMipChain(const unsigned char* rgba, int width, int height, TextureBinary& texture)
+{
+	texture.width = width;
+	texture.height = height;
+	texture.mips.clear();
+	texture.mips.emplace_back(rgba, rgba + (size_t)width * height * 4);
+	while (width > 1 || height > 1)
+	{
+		int nextWidth = width > 1 ? width / 2 : 1;
+		int nextHeight = height > 1 ? height / 2 : 1;
+		const vector<unsigned char>& source = texture.mips.back();
+		vector<unsigned char> mip((size_t)nextWidth * nextHeight * 4);
+		for (int y = 0; y < nextHeight; y++)
+		{
+			int y0 = min(y * 2, height - 1), y1 = min(y * 2 + 1, height - 1);
+			for (int x = 0; x < nextWidth; x++)
+			{
+				int x0 = min(x * 2, width - 1), x1 = min(x * 2 + 1, width - 1);
+				for (int c = 0; c < 4; c++)
+				{
+					int sum = source[((size_t)y0 * width + x0) * 4 + c] + source[((size_t)y0 * width + x1) * 4 + c]
+						+ source[((size_t)y1 * width + x0) * 4 + c] + source[((size_t)y1 * width + x1) * 4 + c];
+					mip[((size_t)y * nextWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+		texture.mips.push_back(move(mip));
+		width = nextWidth;
+		height = nextHeight;
+	}
+}
+
+inline MaterialBinary toMaterialBinary(const Material& material)
+{
+	MaterialBinary binary = {};
+	binary.magic = MATERIAL_BINARY_MAGIC;
+	binary.version = ASSET_BINARY_VERSION;
+	binary.Ns = material.Ns;
+	memcpy(binary.Ka, material.Ka, sizeof(binary.Ka));
+	memcpy(binary.Ks, material.Ks, sizeof(binary.Ks));
+	memcpy(binary.Ke, material.Ke, sizeof(binary.Ke));
+	binary.Ni = material.Ni;
+	binary.d = material.d;
+	binary.illum = material.illum;
+	strncpy(binary.name, material.name.c_str(), sizeof(binary.name) - 1);
+	strncpy(binary.map_Kd, material.map_Kd.c_str(), sizeof(binary.map_Kd) - 1);
+	return binary;
+}
@@ -0,0 +1,149 @@
+// Camera em primeira pessoa independente da taxa de quadros.
+// Em vez de mover a camera nos eventos GLFW_REPEAT (que dependem da taxa de repeticao do
+// teclado do sistema), update() le o estado das teclas e do cursor uma vez por frame e
+// integra com o delta time medido. A velocidade acelera ate maxSpeed e e amortecida
+// exponencialmente quando nenhuma tecla esta pressionada; o mouse e suavizado com um filtro
+// exponencial que tambem depende do delta time, entao o comportamento e o mesmo a 30 ou 300 fps.
+// Frames longos sao integrados em subpassos de no maximo CAMERA_MAX_SUBSTEP segundos.
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <GLFW/glfw3.h>
+
+const float CAMERA_MAX_SUBSTEP = 1.0f / 240.0f;
+// Limite para o delta time (janela arrastada, breakpoint...) nao teletransportar a camera
+const float CAMERA_MAX_FRAME_TIME = 0.25f;
+
+class CameraController
+{
+public:
+	glm::vec3 position;
+	glm::vec3 front = glm::vec3(0.0f, 0.0f, -1.0f);
+	glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::vec3 velocity = glm::vec3(0.0f);
+	float yaw, pitch;
+
+	// Unidades por segundo
+	float maxSpeed = 3.0f;
+	// Unidades por segundo ao quadrado para alcancar a velocidade desejada
+	float acceleration = 20.0f;
+	// Taxa de decaimento exponencial da velocidade sem input (1/s)
+	float damping = 10.0f;
+	// Graus por pixel
+	float mouseSensitivity = 0.05f;
+	// Constante de tempo do filtro do mouse em segundos (0 desliga a suavizacao)
+	float mouseSmoothing = 0.02f;
+	// Segurar Shift multiplica maxSpeed por este fator
+	float sprintMultiplier = 3.0f;
+
+	CameraController(glm::vec3 position, float yaw = -90.0f, float pitch = 0.0f)
+		: position(position), yaw(yaw), pitch(pitch)
+	{
+		updateFront();
+	}
+
+	// Amostra teclado e mouse e integra deltaTime segundos de movimento
+	void update(GLFWwindow* window, float deltaTime)
+	{
+		deltaTime = std::min(std::max(deltaTime, 0.0f), CAMERA_MAX_FRAME_TIME);
+		sampleMouse(window, deltaTime);
+
+		glm::vec3 right = glm::normalize(glm::cross(front, up));
+		glm::vec3 direction(0.0f);
+		if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) direction += front;
+		if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) direction -= front;
+		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) direction += right;
+		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) direction -= right;
+		if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) direction += up;
+		if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) direction -= up;
+		float speedLimit = maxSpeed;
+		if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) speedLimit *= sprintMultiplier;
+		bool moving = glm::dot(direction, direction) > 0.0f;
+		if (moving) direction = glm::normalize(direction);
+
+		float remaining = deltaTime;
+		while (remaining > 0.0f)
+		{
+			float step = std::min(remaining, CAMERA_MAX_SUBSTEP);
+			integrate(direction, moving, speedLimit, step);
+			remaining -= step;
+		}
+	}
+
+	glm::mat4 viewMatrix() const
+	{
+		return glm::lookAt(position, position + front, up);
+	}
+
+	// Descarta o movimento do mouse acumulado (ex.: depois de recapturar o cursor)
+	void resetMouse()
+	{
+		hasLastCursor = false;
+		pendingX = pendingY = 0.0f;
+	}
+
+private:
+	bool hasLastCursor = false;
+	double lastCursorX = 0.0, lastCursorY = 0.0;
+	// Deslocamento do mouse ainda nao aplicado pelo filtro
+	float pendingX = 0.0f, pendingY = 0.0f;
+
+	void sampleMouse(GLFWwindow* window, float deltaTime)
+	{
+		double cursorX, cursorY;
+		glfwGetCursorPos(window, &cursorX, &cursorY);
+		if (!hasLastCursor)
+		{
+			lastCursorX = cursorX;
+			lastCursorY = cursorY;
+			hasLastCursor = true;
+		}
+		pendingX += (float)(cursorX - lastCursorX) * mouseSensitivity;
+		pendingY += (float)(lastCursorY - cursorY) * mouseSensitivity;
+		lastCursorX = cursorX;
+		lastCursorY = cursorY;
+
+		// Aplica a fracao 1 - e^(-dt/tau) do deslocamento pendente: o total aplicado converge
+		// para o movimento real do mouse independente de quantos frames passaram
+		float blend = mouseSmoothing > 0.0f ? 1.0f - std::exp(-deltaTime / mouseSmoothing) : 1.0f;
+		float applyX = pendingX * blend;
+		float applyY = pendingY * blend;
+		pendingX -= applyX;
+		pendingY -= applyY;
+		yaw += applyX;
+		pitch = std::min(std::max(pitch + applyY, -89.0f), 89.0f);
+		updateFront();
+	}
+
+	void integrate(const glm::vec3& direction, bool moving, float speedLimit, float step)
+	{
+		if (moving)
+		{
+			glm::vec3 change = direction * speedLimit - velocity;
+			float distance = glm::length(change);
+			float maxChange = acceleration * step;
+			velocity += distance > maxChange ? change * (maxChange / distance) : change;
+		}
+		else
+		{
+			velocity *= std::exp(-damping * step);
+			if (glm::dot(velocity, velocity) < 1e-8f) velocity = glm::vec3(0.0f);
+		}
+		position += velocity * step;
+	}
+
+	void updateFront()
+	{
+		glm::vec3 direction;
+		direction.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+		direction.y = sin(glm::radians(pitch));
+		direction.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+		front = glm::normalize(direction);
+	}
+};
@@ -0,0 +1,165 @@
+// Resolucao dinamica: a cena e desenhada num framebuffer fora da tela com uma fracao (scale) do
+// tamanho da janela e depois ampliada para a janela (bilinear ou bilinear + nitidez). O scale e
+// ajustado pelo tempo de GPU do frame (GpuTimer) para caber em targetMs:
+// - acima de 95% do alvo reduz de uma vez, na proporcao da raiz (o custo cresce com a area);
+// - abaixo de 75% do alvo aumenta devagar (no maximo 5% por ajuste), para nao oscilar.
+// Os tempos chegam GPU_TIMER_LATENCY frames atrasados, entao depois de cada ajuste espera esse
+// tanto antes de olhar de novo. A textura e alocada no tamanho maximo e so o viewport muda.
+
+#pragma once
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "GpuTimer.h"
+
+using namespace std;
+
+const float DYNAMIC_RES_MIN_SCALE = 0.5f;
+const float DYNAMIC_RES_MAX_SCALE = 1.0f;
+// Largura e altura arredondadas para multiplos disso, para o tamanho nao mudar a cada frame
+const int DYNAMIC_RES_ALIGNMENT = 8;
+
+enum UpscaleFilter { UPSCALE_BILINEAR, UPSCALE_SHARPEN };
+
+class DynamicResolution
+{
+public:
+	bool enabled = true;
+	float scale = 1.0f, minScale = DYNAMIC_RES_MIN_SCALE, maxScale = DYNAMIC_RES_MAX_SCALE;
+	double targetMs = 1000.0 / 60.0;
+	UpscaleFilter filter = UPSCALE_SHARPEN;
+	float sharpness = 0.25f;
+	int width = 0, height = 0;
+	int renderWidth = 0, renderHeight = 0;
+
+	// upscaleProgram: shader do passe final (upscale.vs/upscale.fs do modulo)
+	void init(int outputWidth, int outputHeight, GLuint upscaleProgram)
+	{
+		width = outputWidth;
+		height = outputHeight;
+		program = upscaleProgram;
+		scale = maxScale;
+
+		glGenTextures(1, &color);
+		glBindTexture(GL_TEXTURE_2D, color);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glGenRenderbuffers(1, &depth);
+		allocate();
+		glGenFramebuffers(1, &fbo);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			cout << "Dynamic resolution framebuffer incomplete" << endl;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		// O triangulo de tela cheia sai de gl_VertexID, mas o core profile exige um VAO
+		glGenVertexArrays(1, &emptyVAO);
+	}
+
+	// Janela redimensionada: realoca a textura e a profundidade para a nova saida. Liga
+	// GL_TEXTURE_2D e GL_RENDERBUFFER direto no GL; devolve true se realocou
+	bool setOutputSize(int outputWidth, int outputHeight)
+	{
+		if (outputWidth <= 0 || outputHeight <= 0 || (outputWidth == width && outputHeight == height)) return false;
+		width = outputWidth;
+		height = outputHeight;
+		allocate();
+		return true;
+	}
+
+	// Tempo de GPU do ultimo frame medido; devolve true se o tamanho mudou
+	bool update(double gpuFrameMs)
+	{
+		float next = enabled ? scale : maxScale;
+		if (enabled && gpuFrameMs > 0.0 && --cooldown <= 0)
+		{
+			double ratio = sqrt(targetMs / gpuFrameMs);
+			if (gpuFrameMs > targetMs * 0.95) next = scale * (float)ratio;
+			else if (gpuFrameMs < targetMs * 0.75) next = scale * (float)min(ratio, 1.05);
+		}
+		next = min(maxScale, max(minScale, next));
+		if (fabs(next - scale) < 0.01f) return false;
+		scale = next;
+		cooldown = GPU_TIMER_LATENCY + 1;
+		return resize();
+	}
+
+	// Desenho da cena vai para o framebuffer fora da tela, no tamanho atual
+	void begin()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		glViewport(0, 0, renderWidth, renderHeight);
+	}
+
+	// Amplia para o framebuffer padrao; so a regiao renderizada da textura e amostrada
+	void resolve()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, width, height);
+		GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+		glDisable(GL_DEPTH_TEST);
+		glUseProgram(program);
+		glUniform2f(glGetUniformLocation(program, "uvScale"), (float)renderWidth / textureWidth, (float)renderHeight / textureHeight);
+		glUniform2f(glGetUniformLocation(program, "texelSize"), 1.0f / textureWidth, 1.0f / textureHeight);
+		glUniform1i(glGetUniformLocation(program, "sharpen"), filter == UPSCALE_SHARPEN);
+		glUniform1f(glGetUniformLocation(program, "sharpness"), sharpness);
+		glUniform1i(glGetUniformLocation(program, "scene"), 0);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, color);
+		glBindVertexArray(emptyVAO);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glBindVertexArray(0);
+		if (depthTest) glEnable(GL_DEPTH_TEST);
+	}
+
+	void release()
+	{
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteRenderbuffers(1, &depth);
+		glDeleteTextures(1, &color);
+		glDeleteVertexArrays(1, &emptyVAO);
+		fbo = depth = color = emptyVAO = 0;
+	}
+
+private:
+	GLuint fbo = 0, color = 0, depth = 0, emptyVAO = 0, program = 0;
+	int textureWidth = 0, textureHeight = 0;
+	int cooldown = 0;
+
+	// Alvo no tamanho da saida na escala maxima; as escalas menores usam so uma parte dele
+	void allocate()
+	{
+		textureWidth = max(1, (int)ceil(width * maxScale));
+		textureHeight = max(1, (int)ceil(height * maxScale));
+		glBindTexture(GL_TEXTURE_2D, color);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindRenderbuffer(GL_RENDERBUFFER, depth);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, textureWidth, textureHeight);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		resize();
+	}
+
+	bool resize()
+	{
+		int alignedWidth = (int)(width * scale) / DYNAMIC_RES_ALIGNMENT * DYNAMIC_RES_ALIGNMENT;
+		int alignedHeight = (int)(height * scale) / DYNAMIC_RES_ALIGNMENT * DYNAMIC_RES_ALIGNMENT;
+		alignedWidth = min(textureWidth, max(DYNAMIC_RES_ALIGNMENT, alignedWidth));
+		alignedHeight = min(textureHeight, max(DYNAMIC_RES_ALIGNMENT, alignedHeight));
+		bool changed = alignedWidth != renderWidth || alignedHeight != renderHeight;
+		renderWidth = alignedWidth;
+		renderHeight = alignedHeight;
+		return changed;
+	}
+};
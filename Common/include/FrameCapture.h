@@ -0,0 +1,337 @@
+// Captura de frames para PNG ou GIF animado sem travar o loop de render. Chamar captureFrame
+// depois de desenhar e antes de trocar os buffers:
+// - o glReadPixels vai para um PBO (anel de CAPTURE_PBO_COUNT) com uma fence, entao a copia fica
+//   na fila da GPU e a chamada volta na hora;
+// - nos frames seguintes, as fences ja sinalizadas (consultadas com timeout 0) liberam o PBO: ele
+//   e mapeado, copiado para um buffer do pool e a codificacao vai para o JobSystem;
+// - o pool tem no maximo CAPTURE_MAX_PENDING buffers, o que limita a memoria. Sem buffer livre
+//   (encoders atrasados) ou sem PBO livre (GPU atrasada) o frame e descartado e contado.
+// PNG: um arquivo por frame (prefixo_00000.png). GIF: os frames sao codificados em paralelo e
+// escritos em ordem; o delay de cada um vem do intervalo real ate o proximo, em centesimos com o
+// erro de arredondamento acumulado, e frames mais proximos que CAPTURE_GIF_MIN_DELAY sao
+// pulados porque os visualizadores tratam delays menores como 10.
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "JobSystem.h"
+#include "ImageEncoders.h"
+
+using namespace std;
+
+const int CAPTURE_PBO_COUNT = 3;
+const int CAPTURE_MAX_PENDING = 8;
+// Centesimos de segundo
+const int CAPTURE_GIF_MIN_DELAY = 2;
+
+enum CaptureFormat { CAPTURE_PNG_SEQUENCE, CAPTURE_GIF };
+
+class FrameCapture
+{
+public:
+	void init(int frameWidth, int frameHeight, JobSystem& jobSystem)
+	{
+		width = frameWidth;
+		height = frameHeight;
+		jobs = &jobSystem;
+		frameBytes = (size_t)width * height * 4;
+		// O pool cresce sob demanda mas nunca realoca: os encoders leem buffers que ja existem
+		// enquanto a thread principal acrescenta outros
+		buffers.reserve(CAPTURE_MAX_PENDING);
+		glGenBuffers(CAPTURE_PBO_COUNT, pbos);
+		for (GLuint pbo : pbos)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+			glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	bool recording() const { return active; }
+
+	// path: prefixo dos arquivos na sequencia PNG ou nome do arquivo .gif
+	bool start(CaptureFormat captureFormat, const string& path)
+	{
+		if (active) stop();
+		format = captureFormat;
+		prefix = path;
+		if (format == CAPTURE_GIF)
+		{
+			if (!gif.open(path, width, height))
+			{
+				cout << "Could not create " << path << endl;
+				return false;
+			}
+			gifFrames.clear();
+			nextGifWrite = 0;
+			heldGif.clear();
+			gifFirstTime = -1.0;
+			gifWrittenCs = 0;
+			lastGifCapture = -1.0;
+		}
+		sequence = 0;
+		totals = Stats();
+		interval = Stats();
+		encodedFrames = 0;
+		writeErrors = 0;
+		startTime = reportStart = now();
+		active = true;
+		cout << "Capture started: " << (format == CAPTURE_GIF ? path : path + "_*.png") << endl;
+		return true;
+	}
+
+	// Depois de desenhar o frame e antes do swap
+	void captureFrame()
+	{
+		if (!active) return;
+		auto begin = chrono::steady_clock::now();
+		collect(false);
+		double time = now();
+		if (format == CAPTURE_GIF && lastGifCapture >= 0.0 && (time - lastGifCapture) * 100.0 < CAPTURE_GIF_MIN_DELAY)
+		{
+			interval.skipped++;
+		}
+		else if (inFlight == CAPTURE_PBO_COUNT)
+		{
+			interval.droppedGpu++;
+		}
+		else
+		{
+			Slot& slot = slots[(oldest + inFlight) % CAPTURE_PBO_COUNT];
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[(oldest + inFlight) % CAPTURE_PBO_COUNT]);
+			glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			slot.time = time;
+			inFlight++;
+			if (format == CAPTURE_GIF) lastGifCapture = time;
+		}
+		interval.mainThreadMs += chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+		interval.frames++;
+		reportIfDue(false);
+	}
+
+	// Espera as leituras e os encoders pendentes e fecha os arquivos
+	void stop()
+	{
+		if (!active) return;
+		jobs->wait(pending);
+		collect(true);
+		jobs->wait(pending);
+		if (format == CAPTURE_GIF)
+		{
+			if (!heldGif.empty())
+			{
+				writeHeldGif(heldGifTime + 1.0 / 30.0);
+			}
+			gif.close();
+		}
+		active = false;
+		reportIfDue(true);
+		cout << "Capture finished: " << totals.readBack << " frames in " << now() - startTime << " s" << endl;
+	}
+
+	void release()
+	{
+		stop();
+		glDeleteBuffers(CAPTURE_PBO_COUNT, pbos);
+		for (GLuint& pbo : pbos) pbo = 0;
+		buffers.clear();
+		freeBuffers.clear();
+	}
+
+private:
+	struct Slot {
+		GLsync fence = 0;
+		double time = 0.0;
+	};
+	struct Stats {
+		long frames = 0, readBack = 0, droppedGpu = 0, droppedBacklog = 0, skipped = 0;
+		double mainThreadMs = 0.0;
+	};
+
+	int width = 0, height = 0;
+	size_t frameBytes = 0;
+	JobSystem* jobs = nullptr;
+	JobCounter pending;
+	CaptureFormat format = CAPTURE_PNG_SEQUENCE;
+	string prefix;
+	bool active = false;
+	long sequence = 0;
+	double startTime = 0.0, reportStart = 0.0;
+	Stats totals, interval;
+	atomic<long> encodedFrames{ 0 };
+	atomic<int> writeErrors{ 0 };
+
+	GLuint pbos[CAPTURE_PBO_COUNT] = {};
+	Slot slots[CAPTURE_PBO_COUNT];
+	int oldest = 0, inFlight = 0;
+
+	// Pool de buffers de CPU; freeBuffers e compartilhado com os encoders
+	vector<vector<uint8_t>> buffers;
+	vector<int> freeBuffers;
+	mutex poolMutex;
+
+	// Reordenacao dos frames do GIF: o ultimo fica retido ate o proximo chegar e definir o delay
+	GifWriter gif;
+	mutex gifMutex;
+	map<long, pair<double, vector<uint8_t>>> gifFrames;
+	long nextGifWrite = 0;
+	vector<uint8_t> heldGif;
+	double heldGifTime = 0.0, gifFirstTime = -1.0, lastGifCapture = -1.0;
+	long gifWrittenCs = 0;
+
+	static double now()
+	{
+		return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	int acquireBuffer()
+	{
+		lock_guard<mutex> lock(poolMutex);
+		if (!freeBuffers.empty())
+		{
+			int index = freeBuffers.back();
+			freeBuffers.pop_back();
+			return index;
+		}
+		if ((int)buffers.size() == CAPTURE_MAX_PENDING) return -1;
+		buffers.emplace_back(frameBytes);
+		return (int)buffers.size() - 1;
+	}
+
+	void releaseBuffer(int index)
+	{
+		lock_guard<mutex> lock(poolMutex);
+		freeBuffers.push_back(index);
+	}
+
+	// Entrega os PBOs prontos, em ordem; wait bloqueia ate a GPU terminar (usado no stop)
+	void collect(bool wait)
+	{
+		while (inFlight > 0)
+		{
+			Slot& slot = slots[oldest];
+			GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000 : 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+			glDeleteSync(slot.fence);
+			slot.fence = 0;
+			int buffer = acquireBuffer();
+			if (buffer < 0)
+			{
+				interval.droppedBacklog++;
+			}
+			else
+			{
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[oldest]);
+				const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+				if (pixels)
+				{
+					memcpy(buffers[buffer].data(), pixels, frameBytes);
+					glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+					submit(buffer, slot.time);
+				}
+				else
+				{
+					releaseBuffer(buffer);
+					interval.droppedGpu++;
+				}
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			}
+			oldest = (oldest + 1) % CAPTURE_PBO_COUNT;
+			inFlight--;
+		}
+	}
+
+	void submit(int buffer, double time)
+	{
+		const uint8_t* pixels = buffers[buffer].data();
+		long index = sequence++;
+		interval.readBack++;
+		if (format == CAPTURE_PNG_SEQUENCE)
+		{
+			char suffix[32];
+			snprintf(suffix, sizeof(suffix), "_%05ld.png", index);
+			string path = prefix + suffix;
+			jobs->run([this, buffer, pixels, path]() {
+				if (!writePng(path, pixels, width, height, true)) writeErrors++;
+				releaseBuffer(buffer);
+				encodedFrames++;
+			}, &pending);
+			return;
+		}
+		jobs->run([this, buffer, pixels, index, time]() {
+			vector<uint8_t> frame;
+			encodeGifFrame(pixels, width, height, true, 0, frame);
+			releaseBuffer(buffer);
+			lock_guard<mutex> lock(gifMutex);
+			gifFrames[index] = make_pair(time, move(frame));
+			for (auto next = gifFrames.find(nextGifWrite); next != gifFrames.end(); next = gifFrames.find(nextGifWrite))
+			{
+				if (!heldGif.empty()) writeHeldGif(next->second.first);
+				heldGifTime = next->second.first;
+				heldGif = move(next->second.second);
+				gifFrames.erase(next);
+				nextGifWrite++;
+			}
+			encodedFrames++;
+		}, &pending);
+	}
+
+	// Escreve o frame retido com o delay ate nextTime (bytes 4 e 5 do bloco de controle grafico)
+	void writeHeldGif(double nextTime)
+	{
+		if (gifFirstTime < 0.0) gifFirstTime = heldGifTime;
+		long totalCs = lround((nextTime - gifFirstTime) * 100.0);
+		int delay = (int)max((long)CAPTURE_GIF_MIN_DELAY, totalCs - gifWrittenCs);
+		gifWrittenCs += delay;
+		heldGif[4] = (uint8_t)delay;
+		heldGif[5] = (uint8_t)(delay >> 8);
+		gif.writeFrame(heldGif);
+		heldGif.clear();
+	}
+
+	void reportIfDue(bool force)
+	{
+		double time = now();
+		double elapsed = time - reportStart;
+		if (!force && elapsed < 1.0) return;
+		totals.frames += interval.frames;
+		totals.readBack += interval.readBack;
+		totals.droppedGpu += interval.droppedGpu;
+		totals.droppedBacklog += interval.droppedBacklog;
+		totals.skipped += interval.skipped;
+		size_t bufferCount;
+		{
+			lock_guard<mutex> lock(poolMutex);
+			bufferCount = buffers.size();
+		}
+		streamsize precision = cout.precision(2);
+		ios::fmtflags flags = cout.setf(ios::fixed, ios::floatfield);
+		cout << "Capture (" << (format == CAPTURE_GIF ? "GIF" : "PNG") << "): " << interval.readBack / max(elapsed, 1e-6) << " fps read back, "
+			<< encodedFrames.load() << " encoded, " << totals.droppedGpu << " dropped (GPU), " << totals.droppedBacklog << " dropped (encoders), ";
+		if (format == CAPTURE_GIF) cout << totals.skipped << " skipped (GIF delay), ";
+		cout << "main thread " << (interval.frames ? interval.mainThreadMs / interval.frames : 0.0) << " ms/frame, "
+			<< bufferCount * frameBytes / (1024 * 1024) << " MB buffered";
+		if (writeErrors) cout << ", " << writeErrors.load() << " write errors";
+		cout << endl;
+		cout.precision(precision);
+		cout.flags(flags);
+		interval = Stats();
+		reportStart = time;
+	}
+};
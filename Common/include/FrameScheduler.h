@@ -0,0 +1,190 @@
+// Renderizacao sob demanda: o loop so desenha quando algo mudou (camera, transformacoes,
+// materiais, janela ou input) ou quando ha animacao rodando. Parado, a thread bloqueia em
+// glfwWaitEventsTimeout em vez de girar com glfwPollEvents, entao CPU e GPU ficam ociosos ate o
+// proximo evento. Uso por iteracao do loop:
+//   scheduler.waitEvents();            // poll, espera o limitador ou bloqueia
+//   ... atualiza camera/simulacao, markDirty() no que mudou, setAnimating() ...
+//   if (!scheduler.shouldRender()) continue;
+//   ... desenha e troca os buffers ...
+//   scheduler.frameRendered();
+// Com uma thread de render separada, frameRendered vira frameSubmitted ao publicar o frame e
+// framePresented depois que a thread de render trocou os buffers, para so contar o que saiu na tela.
+// O limitador (frameLimit > 0) espera o intervalo minimo entre frames acordando com eventos.
+// O relatorio mostra os frames desenhados, os que um loop continuo teria desenhado a mais (na
+// taxa do monitor) e o tempo de CPU do processo por segundo, que serve de indicador de consumo.
+
+#pragma once
+
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <glm/glm.hpp>
+
+#include <GLFW/glfw3.h>
+
+using namespace std;
+
+enum DirtyFlags {
+	DIRTY_CAMERA = 1,
+	DIRTY_TRANSFORM = 2,
+	DIRTY_MATERIAL = 4,
+	DIRTY_WINDOW = 8,
+	DIRTY_INPUT = 16,
+	DIRTY_ALL = 31
+};
+
+// Parado, acorda pelo menos nesse intervalo (segundos) para o relatorio
+const double FRAME_SCHEDULER_IDLE_TIMEOUT = 0.5;
+const int FRAME_SCHEDULER_DEFAULT_REFRESH = 60;
+// Diferenca minima em algum elemento para uma matriz contar como alterada: a camera amortece
+// a velocidade exponencialmente e sem isso nunca pararia de "mudar"
+const float FRAME_SCHEDULER_EPSILON = 1e-5f;
+
+inline bool matrixChanged(const glm::mat4& a, const glm::mat4& b)
+{
+	for (int column = 0; column < 4; column++)
+	{
+		glm::vec4 difference = glm::abs(a[column] - b[column]);
+		if (glm::max(glm::max(difference.x, difference.y), glm::max(difference.z, difference.w)) > FRAME_SCHEDULER_EPSILON) return true;
+	}
+	return false;
+}
+
+// Tempo de CPU (usuario + sistema) do processo inteiro, em segundos
+inline double processCpuSeconds()
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+	auto seconds = [](const FILETIME& time) {
+		return (double)(((unsigned long long)time.dwHighDateTime << 32) | time.dwLowDateTime) * 1e-7;
+	};
+	return seconds(kernel) + seconds(user);
+#else
+	rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#endif
+}
+
+class FrameScheduler
+{
+public:
+	// false desenha todo frame, como antes (para comparar)
+	bool onDemand = true;
+	// Frames por segundo no maximo; 0 desliga o limitador
+	double frameLimit = 0.0;
+	double idleTimeout = FRAME_SCHEDULER_IDLE_TIMEOUT;
+	// Ultimo tamanho recebido pelo callback de framebuffer
+	int framebufferWidth = 0, framebufferHeight = 0;
+
+	// Registra os callbacks de refresh e tamanho da janela (usa o user pointer da janela)
+	void attach(GLFWwindow* window)
+	{
+		glfwSetWindowUserPointer(window, this);
+		glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+		glfwSetWindowRefreshCallback(window, [](GLFWwindow* window) {
+			static_cast<FrameScheduler*>(glfwGetWindowUserPointer(window))->markDirty(DIRTY_WINDOW);
+		});
+		glfwSetFramebufferSizeCallback(window, [](GLFWwindow* window, int width, int height) {
+			FrameScheduler* scheduler = static_cast<FrameScheduler*>(glfwGetWindowUserPointer(window));
+			scheduler->framebufferWidth = width;
+			scheduler->framebufferHeight = height;
+			scheduler->markDirty(DIRTY_WINDOW);
+		});
+		const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+		refreshRate = mode && mode->refreshRate > 0 ? mode->refreshRate : FRAME_SCHEDULER_DEFAULT_REFRESH;
+		reportStart = glfwGetTime();
+		reportCpu = processCpuSeconds();
+	}
+
+	void markDirty(unsigned flags) { dirty |= flags; }
+	unsigned dirtyFlags() const { return dirty; }
+	// Animacao continua (objeto girando, luz orbitando): desenha todo frame enquanto durar
+	void setAnimating(bool value) { animating = value; }
+
+	// Processa os eventos pendentes; sem nada para desenhar, bloqueia ate um evento ou o timeout
+	void waitEvents()
+	{
+		if (!wantsFrame())
+		{
+			glfwWaitEventsTimeout(idleTimeout);
+			return;
+		}
+		if (frameLimit > 0.0)
+		{
+			double next = lastFrameTime + 1.0 / frameLimit;
+			for (double now = glfwGetTime(); now < next; now = glfwGetTime())
+			{
+				glfwWaitEventsTimeout(next - now);
+			}
+		}
+		glfwPollEvents();
+	}
+
+	// Chamar depois de atualizar o estado; false conta como frame pulado
+	bool shouldRender()
+	{
+		if (wantsFrame()) return true;
+		idleWakeups++;
+		return false;
+	}
+
+	void frameRendered()
+	{
+		frameSubmitted();
+		framePresented();
+	}
+
+	// O que mudou ja foi entregue para a thread de render
+	void frameSubmitted() { dirty = 0; }
+
+	// count frames chegaram na tela (glfwSwapBuffers da thread de render)
+	void framePresented(unsigned count = 1)
+	{
+		renderedFrames += count;
+		lastFrameTime = glfwGetTime();
+	}
+
+	// Uma linha por segundo: frames desenhados, pulados em relacao a um loop continuo e CPU
+	void reportIfDue()
+	{
+		double now = glfwGetTime();
+		double elapsed = now - reportStart;
+		if (elapsed < 1.0) return;
+		double cpu = processCpuSeconds();
+		long continuousFrames = (long)(elapsed * (frameLimit > 0.0 ? min(frameLimit, (double)refreshRate) : refreshRate) + 0.5);
+		streamsize precision = cout.precision(1);
+		ios::fmtflags flags = cout.setf(ios::fixed, ios::floatfield);
+		cout << "Frames (" << (onDemand ? "on demand" : "continuous");
+		if (frameLimit > 0.0) cout << ", limit " << frameLimit << " fps";
+		cout << "): " << renderedFrames << " rendered, " << max(0L, continuousFrames - (long)renderedFrames) << " skipped, "
+			<< idleWakeups << " idle wakeups, CPU " << (cpu - reportCpu) * 1000.0 / elapsed << " ms/s" << endl;
+		cout.precision(precision);
+		cout.flags(flags);
+		reportStart = now;
+		reportCpu = cpu;
+		renderedFrames = idleWakeups = 0;
+	}
+
+private:
+	unsigned dirty = DIRTY_ALL;
+	bool animating = false;
+	int refreshRate = FRAME_SCHEDULER_DEFAULT_REFRESH;
+	double lastFrameTime = 0.0, reportStart = 0.0, reportCpu = 0.0;
+	unsigned renderedFrames = 0, idleWakeups = 0;
+
+	bool wantsFrame() const { return !onDemand || animating || dirty != 0; }
+};
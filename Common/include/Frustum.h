@@ -0,0 +1,53 @@
+// Planos do frustum extraidos da matriz projection * view (metodo de Gribb/Hartmann).
+// Os planos apontam para dentro: dot(plane.xyz, p) + plane.w >= 0 para pontos visiveis.
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+struct Frustum
+{
+	glm::vec4 planes[6];
+
+	static Frustum fromMatrix(const glm::mat4& viewProjection)
+	{
+		glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+		glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+		glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+		glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+		Frustum frustum;
+		frustum.planes[0] = row3 + row0; // left
+		frustum.planes[1] = row3 - row0; // right
+		frustum.planes[2] = row3 + row1; // bottom
+		frustum.planes[3] = row3 - row1; // top
+		frustum.planes[4] = row3 + row2; // near
+		frustum.planes[5] = row3 - row2; // far
+		for (glm::vec4& plane : frustum.planes)
+		{
+			plane /= glm::length(glm::vec3(plane));
+		}
+		return frustum;
+	}
+
+	bool intersectsSphere(const glm::vec3& center, float radius) const
+	{
+		for (const glm::vec4& plane : planes)
+		{
+			if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+		}
+		return true;
+	}
+
+	bool intersectsAABB(const glm::vec3& min, const glm::vec3& max) const
+	{
+		for (const glm::vec4& plane : planes)
+		{
+			// vertice positivo: o canto da caixa mais a frente na direcao do plano
+			glm::vec3 p(plane.x >= 0.0f ? max.x : min.x,
+				plane.y >= 0.0f ? max.y : min.y,
+				plane.z >= 0.0f ? max.z : min.z);
+			if (glm::dot(glm::vec3(plane), p) + plane.w < 0.0f) return false;
+		}
+		return true;
+	}
+};
@@ -0,0 +1,104 @@
+// Pontos de entrada da OpenGL 4.3+ que o loader da GLAD (gerado para 3.3 core) nao carrega
+// (glBufferStorage e 4.4 ou ARB_buffer_storage).
+// Os shaders ja usam #version 450, entao o contexto suporta essas funcoes; basta busca-las
+// na GLFW depois do gladLoadGLLoader.
+
+#pragma once
+
+#include <iostream>
+
+//GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+#define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_CLIENT_STORAGE_BIT
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// Layout de glMultiDrawElementsIndirect (tambem escrito pelos compute shaders)
+struct DrawElementsIndirectCommand
+{
+	GLuint count;
+	GLuint instanceCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint baseInstance;
+};
+
+typedef void (APIENTRYP PFNGLEXTDISPATCHCOMPUTEPROC)(GLuint numGroupsX, GLuint numGroupsY, GLuint numGroupsZ);
+typedef void (APIENTRYP PFNGLEXTMEMORYBARRIERPROC)(GLbitfield barriers);
+typedef void (APIENTRYP PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+typedef void (APIENTRYP PFNGLEXTBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+struct GLExtFunctions
+{
+	PFNGLEXTDISPATCHCOMPUTEPROC DispatchCompute = nullptr;
+	// Nao pode se chamar MemoryBarrier: e macro do winnt.h quando windows.h e incluido
+	PFNGLEXTMEMORYBARRIERPROC MemoryBarrierFn = nullptr;
+	PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC MultiDrawElementsIndirect = nullptr;
+	PFNGLEXTBUFFERSTORAGEPROC BufferStorage = nullptr;
+};
+
+inline GLExtFunctions& glext()
+{
+	static GLExtFunctions functions;
+	return functions;
+}
+
+// Deve ser chamada com o contexto corrente; retorna false se alguma funcao faltar
+inline bool loadGLExtensions()
+{
+	GLExtFunctions& f = glext();
+	f.DispatchCompute = (PFNGLEXTDISPATCHCOMPUTEPROC)glfwGetProcAddress("glDispatchCompute");
+	f.MemoryBarrierFn = (PFNGLEXTMEMORYBARRIERPROC)glfwGetProcAddress("glMemoryBarrier");
+	f.MultiDrawElementsIndirect = (PFNGLEXTMULTIDRAWELEMENTSINDIRECTPROC)glfwGetProcAddress("glMultiDrawElementsIndirect");
+	f.BufferStorage = (PFNGLEXTBUFFERSTORAGEPROC)glfwGetProcAddress("glBufferStorage");
+	const struct { bool found; const char* name; } required[] = {
+		{ f.DispatchCompute != nullptr, "glDispatchCompute" },
+		{ f.MemoryBarrierFn != nullptr, "glMemoryBarrier" },
+		{ f.MultiDrawElementsIndirect != nullptr, "glMultiDrawElementsIndirect" },
+		{ f.BufferStorage != nullptr, "glBufferStorage" },
+	};
+	bool ok = true;
+	for (const auto& entry : required)
+	{
+		if (entry.found) continue;
+		std::cout << "ERROR::GLEXT::FUNCTION_NOT_FOUND " << entry.name << std::endl;
+		ok = false;
+	}
+	return ok;
+}
+
+#define glDispatchCompute glext().DispatchCompute
+#define glMemoryBarrier glext().MemoryBarrierFn
+#define glMultiDrawElementsIndirect glext().MultiDrawElementsIndirect
+#define glBufferStorage glext().BufferStorage
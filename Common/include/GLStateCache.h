@@ -0,0 +1,219 @@
+// Cache do estado do OpenGL: guarda o que foi setado por ultimo (programa, VAO, texturas por
+// unidade, buffers, framebuffers, caps de glEnable, largura de linha, tamanho de ponto, viewport,
+// cor de limpeza, modo de poligono) e so repassa a chamada ao driver quando o valor muda.
+// Conta as chamadas emitidas e as evitadas por frame.
+// Regras para o cache nao mentir:
+// - todo estado rastreado tem que passar por ele; codigo que chama o GL direto (ShadowMap,
+//   DynamicResolution...) deve ser seguido de invalidate() ou, melhor, do invalidate* de cada
+//   estado que mexeu, para o resto continuar sendo evitado;
+// - o GL_ELEMENT_ARRAY_BUFFER faz parte do VAO, entao trocar de VAO esquece esse binding;
+// - apagar um objeto ainda ligado desfaz o binding no GL: chamar invalidate() depois.
+// Um valor desconhecido (inicio ou depois de invalidate) sempre e emitido.
+
+#pragma once
+
+#include <iostream>
+#include <unordered_map>
+#include <chrono>
+
+//GLAD
+#include <glad/glad.h>
+
+using namespace std;
+
+const int GL_STATE_TEXTURE_UNITS = 16;
+
+class GLStateCache
+{
+public:
+	void useProgram(GLuint program)
+	{
+		if (changed(this->program, program)) glUseProgram(program);
+	}
+
+	void bindVertexArray(GLuint vao)
+	{
+		if (!changed(vertexArray, vao)) return;
+		glBindVertexArray(vao);
+		buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+	}
+
+	void activeTexture(GLenum unit)
+	{
+		if (changed(activeUnit, unit)) glActiveTexture(unit);
+	}
+
+	// unit e GL_TEXTURE0 + i; so troca a unidade ativa se o binding mudar
+	void bindTexture(GLenum unit, GLenum target, GLuint texture)
+	{
+		int index = (int)(unit - GL_TEXTURE0);
+		if (index < 0 || index >= GL_STATE_TEXTURE_UNITS)
+		{
+			activeTexture(unit);
+			glBindTexture(target, texture);
+			issued++;
+			return;
+		}
+		if (!changed(textures[index][target], texture)) return;
+		activeTexture(unit);
+		glBindTexture(target, texture);
+	}
+
+	void bindBuffer(GLenum target, GLuint buffer)
+	{
+		if (changed(buffers[target], buffer)) glBindBuffer(target, buffer);
+	}
+
+	// GL_FRAMEBUFFER liga os dois alvos de uma vez
+	void bindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		if (target == GL_FRAMEBUFFER)
+		{
+			if (readFramebuffer.known && drawFramebuffer.known && readFramebuffer.value == framebuffer && drawFramebuffer.value == framebuffer)
+			{
+				elided++;
+				return;
+			}
+			readFramebuffer = drawFramebuffer = Cached<GLuint>{ framebuffer, true };
+			glBindFramebuffer(target, framebuffer);
+			issued++;
+			return;
+		}
+		if (changed(target == GL_READ_FRAMEBUFFER ? readFramebuffer : drawFramebuffer, framebuffer)) glBindFramebuffer(target, framebuffer);
+	}
+
+	void setEnabled(GLenum capability, bool enabled)
+	{
+		if (!changed(capabilities[capability], enabled)) return;
+		enabled ? glEnable(capability) : glDisable(capability);
+	}
+	void enable(GLenum capability) { setEnabled(capability, true); }
+	void disable(GLenum capability) { setEnabled(capability, false); }
+
+	void lineWidth(float width)
+	{
+		if (changed(this->width, width)) glLineWidth(width);
+	}
+
+	void pointSize(float size)
+	{
+		if (changed(this->size, size)) glPointSize(size);
+	}
+
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		if (changed(viewportRect, Rect{ x, y, width, height })) glViewport(x, y, width, height);
+	}
+
+	void clearColor(float r, float g, float b, float a)
+	{
+		if (changed(clear, Color{ r, g, b, a })) glClearColor(r, g, b, a);
+	}
+
+	// So GL_FRONT_AND_BACK existe no core profile
+	void polygonMode(GLenum mode)
+	{
+		if (changed(this->mode, mode)) glPolygonMode(GL_FRONT_AND_BACK, mode);
+	}
+
+	// Esquece tudo: a proxima chamada de cada estado e emitida
+	void invalidate()
+	{
+		program = vertexArray = activeUnit = Cached<GLuint>();
+		readFramebuffer = drawFramebuffer = Cached<GLuint>();
+		for (auto& unit : textures) unit.clear();
+		buffers.clear();
+		capabilities.clear();
+		width = size = Cached<float>();
+		viewportRect = Cached<Rect>();
+		clear = Cached<Color>();
+		mode = Cached<GLenum>();
+	}
+
+	// Esquecem so um estado, para depois de codigo que o muda direto no GL
+	void invalidateProgram() { program = Cached<GLuint>(); }
+	void invalidateVertexArray()
+	{
+		vertexArray = Cached<GLuint>();
+		buffers.erase(GL_ELEMENT_ARRAY_BUFFER);
+	}
+	// Tambem esquece a unidade ativa, que glActiveTexture direto sempre muda
+	void invalidateTexture(GLenum unit)
+	{
+		activeUnit = Cached<GLuint>();
+		int index = (int)(unit - GL_TEXTURE0);
+		if (index >= 0 && index < GL_STATE_TEXTURE_UNITS) textures[index].clear();
+	}
+	void invalidateFramebuffers() { readFramebuffer = drawFramebuffer = Cached<GLuint>(); }
+	void invalidateViewport() { viewportRect = Cached<Rect>(); }
+	void invalidateCapability(GLenum capability) { capabilities.erase(capability); }
+
+	// Fecha os contadores do frame
+	void endFrame()
+	{
+		lastIssued = issued;
+		lastElided = elided;
+		totalIssued += issued;
+		totalElided += elided;
+		frames++;
+		issued = elided = 0;
+	}
+
+	unsigned issuedLastFrame() const { return lastIssued; }
+	unsigned elidedLastFrame() const { return lastElided; }
+
+	// Uma linha por segundo com a media por frame
+	void reportIfDue()
+	{
+		auto now = chrono::steady_clock::now();
+		if (frames == 0 || now - reportStart < chrono::seconds(1)) return;
+		cout << "GL state: " << totalIssued / frames << " calls issued, " << totalElided / frames << " elided per frame" << endl;
+		totalIssued = totalElided = 0;
+		frames = 0;
+		reportStart = now;
+	}
+
+private:
+	template<typename T>
+	struct Cached {
+		T value{};
+		bool known = false;
+	};
+	struct Rect {
+		GLint x, y;
+		GLsizei width, height;
+		bool operator==(const Rect& other) const { return x == other.x && y == other.y && width == other.width && height == other.height; }
+	};
+	struct Color {
+		float r, g, b, a;
+		bool operator==(const Color& other) const { return r == other.r && g == other.g && b == other.b && a == other.a; }
+	};
+
+	Cached<GLuint> program, vertexArray, activeUnit, readFramebuffer, drawFramebuffer;
+	unordered_map<GLenum, Cached<GLuint>> textures[GL_STATE_TEXTURE_UNITS];
+	unordered_map<GLenum, Cached<GLuint>> buffers;
+	unordered_map<GLenum, Cached<bool>> capabilities;
+	Cached<float> width, size;
+	Cached<Rect> viewportRect;
+	Cached<Color> clear;
+	Cached<GLenum> mode;
+
+	unsigned issued = 0, elided = 0, lastIssued = 0, lastElided = 0;
+	unsigned long long totalIssued = 0, totalElided = 0, frames = 0;
+	chrono::steady_clock::time_point reportStart = chrono::steady_clock::now();
+
+	// Atualiza o valor guardado; false (e conta como evitada) se a chamada seria redundante
+	template<typename T>
+	bool changed(Cached<T>& slot, const T& value)
+	{
+		if (slot.known && slot.value == value)
+		{
+			elided++;
+			return false;
+		}
+		slot.value = value;
+		slot.known = true;
+		issued++;
+		return true;
+	}
+};
@@ -0,0 +1,99 @@
+// Tempo de GPU por passe com queries GL_TIME_ELAPSED. O resultado de uma query so fica pronto
+// alguns frames depois, entao cada passe tem um anel de GPU_TIMER_LATENCY queries: no inicio
+// do frame le as do slot que vai ser reusado (emitidas GPU_TIMER_LATENCY frames antes) e so
+// espera o driver se ainda nao estiverem prontas. Passes que nao rodaram num frame (ex. o
+// cache de sombra reaproveitado) nao entram na media.
+// As queries TIME_ELAPSED nao podem ser aninhadas: um passe por vez entre begin e end.
+
+#pragma once
+
+#include <vector>
+
+//GLAD
+#include <glad/glad.h>
+
+using namespace std;
+
+const int GPU_TIMER_LATENCY = 4;
+
+class GpuTimer
+{
+public:
+	void init(int passCount)
+	{
+		passes.assign(passCount, Pass());
+		for (Pass& pass : passes)
+		{
+			glGenQueries(GPU_TIMER_LATENCY, pass.queries);
+		}
+	}
+
+	// Chamar uma vez por frame, antes do primeiro begin
+	void beginFrame()
+	{
+		frame = (frame + 1) % GPU_TIMER_LATENCY;
+		bool anyPass = false;
+		double frameMs = 0.0;
+		for (Pass& pass : passes)
+		{
+			if (!pass.issued[frame]) continue;
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(pass.queries[frame], GL_QUERY_RESULT, &elapsed);
+			pass.lastMs = elapsed / 1e6;
+			frameMs += pass.lastMs;
+			anyPass = true;
+			pass.totalMs += pass.lastMs;
+			pass.samples++;
+			pass.issued[frame] = false;
+		}
+		if (anyPass) lastFrame = frameMs;
+	}
+
+	void begin(int pass)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, passes[pass].queries[frame]);
+		passes[pass].issued[frame] = true;
+	}
+
+	void end()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+	}
+
+	// Ultimo resultado lido (de GPU_TIMER_LATENCY frames atras)
+	double lastMs(int pass) const { return passes[pass].lastMs; }
+	// Soma dos passes que rodaram nesse mesmo frame; 0 ate chegar o primeiro resultado
+	double lastFrameMs() const { return lastFrame; }
+	// Media desde o ultimo resetAverages e quantos frames rodaram o passe
+	double averageMs(int pass) const { return passes[pass].samples ? passes[pass].totalMs / passes[pass].samples : 0.0; }
+	int samples(int pass) const { return passes[pass].samples; }
+
+	void resetAverages()
+	{
+		for (Pass& pass : passes)
+		{
+			pass.totalMs = 0.0;
+			pass.samples = 0;
+		}
+	}
+
+	void release()
+	{
+		for (Pass& pass : passes)
+		{
+			glDeleteQueries(GPU_TIMER_LATENCY, pass.queries);
+		}
+		passes.clear();
+	}
+
+private:
+	struct Pass {
+		GLuint queries[GPU_TIMER_LATENCY] = {};
+		bool issued[GPU_TIMER_LATENCY] = {};
+		double lastMs = 0.0, totalMs = 0.0;
+		int samples = 0;
+	};
+	vector<Pass> passes;
+	int frame = 0;
+	double lastFrame = 0.0;
+};
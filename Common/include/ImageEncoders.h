@@ -0,0 +1,573 @@
+// Codificadores de imagem sem dependencias, usados pela captura de frames (FrameCapture.h).
+// - PNG: RGB 8 bits. Cada linha usa o filtro (None, Sub, Up ou Paeth) com a menor soma dos
+//   valores absolutos, como a heuristica do libpng (os quatro candidatos saem juntos em SSE2). O zlib e um unico bloco deflate com os codigos
+//   de Huffman fixos e LZ77 com hash de 3 bytes e cadeia curta: comprime bem as areas chapadas de
+//   um render e roda rapido o bastante para varios frames por segundo por thread.
+// - GIF: cada frame tem sua propria paleta de 256 cores por median cut sobre um histograma
+//   RGB555 (a cor de cada caixa e a media das cores reais, entao cenas com poucas cores saem
+//   exatas) e os pixels vao em LZW de 12 bits. Os frames sao codificados separadamente e
+//   depois concatenados em ordem por GifWriter.
+// As imagens de entrada sao RGBA; flipY inverte as linhas (o glReadPixels le de baixo para cima).
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#include <emmintrin.h>
+
+using namespace std;
+
+// Ate quantas posicoes anteriores com o mesmo hash o LZ77 compara
+const int DEFLATE_CHAIN_DEPTH = 4;
+const int DEFLATE_HASH_BITS = 15;
+const int DEFLATE_WINDOW = 32768;
+const int DEFLATE_MAX_INSERT_LENGTH = 32;
+const int GIF_MAX_COLORS = 256;
+
+inline uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size)
+{
+	// Inicializacao de static local e thread-safe: os workers podem chamar ao mesmo tempo
+	static const vector<uint32_t> table = []() {
+		vector<uint32_t> values(256);
+		for (uint32_t n = 0; n < 256; n++)
+		{
+			uint32_t c = n;
+			for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			values[n] = c;
+		}
+		return values;
+	}();
+	crc = ~crc;
+	for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+inline uint32_t adler32(const uint8_t* data, size_t size)
+{
+	uint32_t a = 1, b = 0;
+	while (size > 0)
+	{
+		// 5552 e o maximo de bytes antes de b poder estourar 32 bits
+		size_t block = min<size_t>(size, 5552);
+		for (size_t i = 0; i < block; i++)
+		{
+			a += data[i];
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+		data += block;
+		size -= block;
+	}
+	return (b << 16) | a;
+}
+
+// Bits do menos para o mais significativo, como o deflate e o LZW do GIF esperam
+class BitWriter
+{
+public:
+	vector<uint8_t>& out;
+	explicit BitWriter(vector<uint8_t>& output) : out(output) {}
+
+	void write(uint32_t value, int count)
+	{
+		buffer |= (uint64_t)value << bitCount;
+		bitCount += count;
+		while (bitCount >= 8)
+		{
+			out.push_back((uint8_t)buffer);
+			buffer >>= 8;
+			bitCount -= 8;
+		}
+	}
+
+	void flush()
+	{
+		if (bitCount > 0) out.push_back((uint8_t)buffer);
+		buffer = 0;
+		bitCount = 0;
+	}
+
+private:
+	uint64_t buffer = 0;
+	int bitCount = 0;
+};
+
+// Codigos de Huffman sao definidos do bit mais significativo para o menos: inverte para o BitWriter
+inline uint32_t reverseBits(uint32_t code, int length)
+{
+	uint32_t result = 0;
+	for (int i = 0; i < length; i++)
+	{
+		result = (result << 1) | (code & 1);
+		code >>= 1;
+	}
+	return result;
+}
+
+// Codigos fixos de literal/comprimento ja invertidos, no formato (codigo << 4) | tamanho
+inline const vector<uint32_t>& fixedLiteralCodes()
+{
+	static const vector<uint32_t> codes = []() {
+		vector<uint32_t> values(288);
+		for (int symbol = 0; symbol < 288; symbol++)
+		{
+			uint32_t code, length;
+			if (symbol < 144) code = 0x30 + symbol, length = 8;
+			else if (symbol < 256) code = 0x190 + symbol - 144, length = 9;
+			else if (symbol < 280) code = symbol - 256, length = 7;
+			else code = 0xC0 + symbol - 280, length = 8;
+			values[symbol] = (reverseBits(code, length) << 4) | length;
+		}
+		return values;
+	}();
+	return codes;
+}
+
+inline void writeFixedLiteral(BitWriter& bits, int symbol)
+{
+	uint32_t code = fixedLiteralCodes()[symbol];
+	bits.write(code >> 4, code & 15);
+}
+
+inline void writeFixedMatch(BitWriter& bits, int length, int distance)
+{
+	static const int lengthBase[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	static const int lengthExtra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	static const int distanceBase[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+		4097, 6145, 8193, 12289, 16385, 24577 };
+	static const int distanceExtra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	int lengthCode = 28;
+	while (lengthBase[lengthCode] > length) lengthCode--;
+	writeFixedLiteral(bits, 257 + lengthCode);
+	bits.write(length - lengthBase[lengthCode], lengthExtra[lengthCode]);
+	int distanceCode = 29;
+	while (distanceBase[distanceCode] > distance) distanceCode--;
+	bits.write(reverseBits(distanceCode, 5), 5);
+	bits.write(distance - distanceBase[distanceCode], distanceExtra[distanceCode]);
+}
+
+// Stream zlib (cabecalho, um bloco deflate com Huffman fixo e adler32)
+inline void zlibCompress(const uint8_t* data, size_t size, vector<uint8_t>& out)
+{
+	out.push_back(0x78);
+	out.push_back(0x01);
+	BitWriter bits(out);
+	bits.write(1, 1); // ultimo bloco
+	bits.write(1, 2); // Huffman fixo
+	const size_t hashSize = (size_t)1 << DEFLATE_HASH_BITS;
+	vector<int32_t> head(hashSize, -1);
+	vector<int32_t> previous(DEFLATE_WINDOW, -1);
+	auto hashAt = [&](size_t i) {
+		uint32_t value = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+		return (value * 2654435761u) >> (32 - DEFLATE_HASH_BITS);
+	};
+	auto insert = [&](size_t i) {
+		uint32_t hash = hashAt(i);
+		previous[i & (DEFLATE_WINDOW - 1)] = head[hash];
+		head[hash] = (int32_t)i;
+	};
+	size_t i = 0;
+	while (i < size)
+	{
+		int bestLength = 0, bestDistance = 0;
+		if (i + 3 <= size)
+		{
+			size_t maxLength = min<size_t>(258, size - i);
+			int32_t candidate = head[hashAt(i)];
+			for (int depth = 0; depth < DEFLATE_CHAIN_DEPTH && candidate >= 0 && i - candidate <= (size_t)DEFLATE_WINDOW - 1; depth++)
+			{
+				const uint8_t* a = data + candidate;
+				const uint8_t* b = data + i;
+				size_t length = 0;
+				while (length < maxLength && a[length] == b[length]) length++;
+				if ((int)length > bestLength)
+				{
+					bestLength = (int)length;
+					bestDistance = (int)(i - candidate);
+					if (length == maxLength) break;
+				}
+				int32_t next = previous[candidate & (DEFLATE_WINDOW - 1)];
+				if (next >= candidate) break;
+				candidate = next;
+			}
+			insert(i);
+		}
+		if (bestLength >= 3)
+		{
+			writeFixedMatch(bits, bestLength, bestDistance);
+			// Posicoes dentro de matches curtos tambem entram no hash; nos longos (areas chapadas)
+			// isso custaria mais do que ajuda, como nos niveis rapidos do zlib
+			if (bestLength <= DEFLATE_MAX_INSERT_LENGTH)
+			{
+				for (size_t k = i + 1; k < i + bestLength && k + 3 <= size; k++) insert(k);
+			}
+			i += bestLength;
+		}
+		else
+		{
+			writeFixedLiteral(bits, data[i]);
+			i++;
+		}
+	}
+	writeFixedLiteral(bits, 256);
+	bits.flush();
+	uint32_t checksum = adler32(data, size);
+	for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(checksum >> shift));
+}
+
+inline void appendBigEndian(vector<uint8_t>& out, uint32_t value)
+{
+	for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(value >> shift));
+}
+
+inline void appendPngChunk(vector<uint8_t>& out, const char* type, const vector<uint8_t>& data)
+{
+	appendBigEndian(out, (uint32_t)data.size());
+	size_t start = out.size();
+	out.insert(out.end(), type, type + 4);
+	out.insert(out.end(), data.begin(), data.end());
+	appendBigEndian(out, crc32Update(0, &out[start], out.size() - start));
+}
+
+inline uint8_t paethPredictor(int a, int b, int c)
+{
+	int pa = abs(b - c), pb = abs(a - c), pc = abs(a + b - 2 * c);
+	if (pa <= pb && pa <= pc) return (uint8_t)a;
+	return (uint8_t)(pb <= pc ? b : c);
+}
+
+// Paeth de 8 lanes de 16 bits com os mesmos desempates do escalar (a, depois b, depois c)
+inline __m128i paethPredictor8(__m128i a, __m128i b, __m128i c)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i pa = _mm_sub_epi16(b, c);
+	__m128i pb = _mm_sub_epi16(a, c);
+	__m128i pc = _mm_add_epi16(pa, pb);
+	pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+	pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+	pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+	__m128i notA = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+	__m128i notB = _mm_cmpgt_epi16(pb, pc);
+	__m128i bc = _mm_or_si128(_mm_and_si128(notB, c), _mm_andnot_si128(notB, b));
+	return _mm_or_si128(_mm_and_si128(notA, bc), _mm_andnot_si128(notA, a));
+}
+
+inline __m128i paethPredictor16(__m128i a, __m128i b, __m128i c)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i low = paethPredictor8(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+	__m128i high = paethPredictor8(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero));
+	return _mm_packus_epi16(low, high);
+}
+
+// Residuos dos quatro filtros de uma linha RGB (None, Sub, Up e Paeth, nessa ordem) e a soma dos
+// valores absolutos como bytes com sinal de cada um. row e up precisam de 3 bytes zerados antes
+// do inicio (o pixel a esquerda do primeiro), assim a borda nao e caso especial. Sem dependencia
+// entre bytes, 16 por vez com SSE2
+inline void pngFilterCandidates(const uint8_t* row, const uint8_t* up, size_t size, uint8_t* const candidates[4], long sums[4])
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i totals[4] = { zero, zero, zero, zero };
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+		__m128i a = _mm_loadu_si128((const __m128i*)(row + i - 3));
+		__m128i b = _mm_loadu_si128((const __m128i*)(up + i));
+		__m128i c = _mm_loadu_si128((const __m128i*)(up + i - 3));
+		__m128i residuals[4] = { x, _mm_sub_epi8(x, a), _mm_sub_epi8(x, b), _mm_sub_epi8(x, paethPredictor16(a, b, c)) };
+		for (int filter = 0; filter < 4; filter++)
+		{
+			_mm_storeu_si128((__m128i*)(candidates[filter] + i), residuals[filter]);
+			// |r| como int8 = min(r, -r) sem sinal (-128 vira 128); psadbw soma os 16 bytes
+			__m128i magnitude = _mm_min_epu8(residuals[filter], _mm_sub_epi8(zero, residuals[filter]));
+			totals[filter] = _mm_add_epi64(totals[filter], _mm_sad_epu8(magnitude, zero));
+		}
+	}
+	for (int filter = 0; filter < 4; filter++)
+	{
+		alignas(16) uint64_t halves[2];
+		_mm_store_si128((__m128i*)halves, totals[filter]);
+		sums[filter] = (long)(halves[0] + halves[1]);
+	}
+	for (; i < size; i++)
+	{
+		uint8_t residuals[4] = { row[i], (uint8_t)(row[i] - row[i - 3]), (uint8_t)(row[i] - up[i]),
+			(uint8_t)(row[i] - paethPredictor(row[i - 3], up[i], up[i - 3])) };
+		for (int filter = 0; filter < 4; filter++)
+		{
+			candidates[filter][i] = residuals[filter];
+			sums[filter] += abs((int)(int8_t)residuals[filter]);
+		}
+	}
+}
+
+inline void encodePng(const uint8_t* rgba, int width, int height, bool flipY, vector<uint8_t>& out)
+{
+	const size_t padding = 16;
+	size_t rowSize = (size_t)width * 3;
+	vector<uint8_t> filtered((rowSize + 1) * height);
+	vector<uint8_t> previousRow(padding + rowSize, 0), row(padding + rowSize, 0);
+	vector<uint8_t> candidateData(rowSize * 4);
+	uint8_t* const candidates[4] = { &candidateData[0], &candidateData[rowSize], &candidateData[rowSize * 2], &candidateData[rowSize * 3] };
+	for (int y = 0; y < height; y++)
+	{
+		const uint8_t* source = rgba + (size_t)(flipY ? height - 1 - y : y) * width * 4;
+		uint8_t* pixels = &row[padding];
+		for (int x = 0; x < width; x++)
+		{
+			pixels[x * 3] = source[x * 4];
+			pixels[x * 3 + 1] = source[x * 4 + 1];
+			pixels[x * 3 + 2] = source[x * 4 + 2];
+		}
+		// O menor residuo absoluto costuma comprimir melhor
+		long sums[4];
+		pngFilterCandidates(pixels, &previousRow[padding], rowSize, candidates, sums);
+		int bestFilter = (int)(min_element(sums, sums + 4) - sums);
+		// Tipos do PNG: 0 None, 1 Sub, 2 Up, 4 Paeth
+		uint8_t* destination = &filtered[y * (rowSize + 1)];
+		destination[0] = (uint8_t)(bestFilter == 3 ? 4 : bestFilter);
+		memcpy(destination + 1, candidates[bestFilter], rowSize);
+		previousRow.swap(row);
+	}
+
+	static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	out.assign(signature, signature + 8);
+	vector<uint8_t> header;
+	appendBigEndian(header, (uint32_t)width);
+	appendBigEndian(header, (uint32_t)height);
+	header.push_back(8); // bits por canal
+	header.push_back(2); // RGB
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	appendPngChunk(out, "IHDR", header);
+	vector<uint8_t> compressed;
+	compressed.reserve(filtered.size() / 4);
+	zlibCompress(filtered.data(), filtered.size(), compressed);
+	appendPngChunk(out, "IDAT", compressed);
+	appendPngChunk(out, "IEND", vector<uint8_t>());
+}
+
+inline bool writePng(const string& path, const uint8_t* rgba, int width, int height, bool flipY)
+{
+	vector<uint8_t> png;
+	encodePng(rgba, width, height, flipY, png);
+	ofstream file(path, ios::binary);
+	file.write((const char*)png.data(), png.size());
+	return (bool)file;
+}
+
+// Paleta por median cut: palette recebe ate 256 cores RGB, indices um indice por pixel
+inline void quantizeMedianCut(const uint8_t* rgba, int width, int height, bool flipY, vector<uint8_t>& palette, vector<uint8_t>& indices)
+{
+	const int binCount = 1 << 15;
+	vector<uint32_t> counts(binCount, 0);
+	vector<uint64_t> sums(binCount * 3, 0);
+	size_t pixelCount = (size_t)width * height;
+	vector<uint16_t> bins(pixelCount);
+	for (int y = 0; y < height; y++)
+	{
+		const uint8_t* source = rgba + (size_t)(flipY ? height - 1 - y : y) * width * 4;
+		uint16_t* rowBins = &bins[(size_t)y * width];
+		for (int x = 0; x < width; x++)
+		{
+			const uint8_t* p = source + x * 4;
+			uint16_t bin = (uint16_t)(((p[0] >> 3) << 10) | ((p[1] >> 3) << 5) | (p[2] >> 3));
+			rowBins[x] = bin;
+			counts[bin]++;
+			sums[bin * 3] += p[0];
+			sums[bin * 3 + 1] += p[1];
+			sums[bin * 3 + 2] += p[2];
+		}
+	}
+	vector<uint16_t> used;
+	for (int bin = 0; bin < binCount; bin++)
+	{
+		if (counts[bin]) used.push_back((uint16_t)bin);
+	}
+
+	// Caixas sao faixas de used; divide sempre a com maior (extensao * pixels) no eixo mais longo
+	struct Box {
+		size_t first, last;
+		int axis, extent;
+		uint64_t pixels;
+	};
+	auto component = [](uint16_t bin, int axis) { return (bin >> (10 - axis * 5)) & 31; };
+	auto measure = [&](Box& box) {
+		int low[3] = { 31, 31, 31 }, high[3] = { 0, 0, 0 };
+		box.pixels = 0;
+		for (size_t i = box.first; i < box.last; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				low[axis] = min(low[axis], component(used[i], axis));
+				high[axis] = max(high[axis], component(used[i], axis));
+			}
+			box.pixels += counts[used[i]];
+		}
+		box.axis = 0;
+		for (int axis = 1; axis < 3; axis++)
+		{
+			if (high[axis] - low[axis] > high[box.axis] - low[box.axis]) box.axis = axis;
+		}
+		box.extent = high[box.axis] - low[box.axis];
+	};
+	vector<Box> boxes(1, Box{ 0, used.size(), 0, 0, 0 });
+	measure(boxes[0]);
+	while ((int)boxes.size() < GIF_MAX_COLORS)
+	{
+		int split = -1;
+		uint64_t bestScore = 0;
+		for (size_t b = 0; b < boxes.size(); b++)
+		{
+			uint64_t score = (uint64_t)boxes[b].extent * boxes[b].pixels;
+			if (boxes[b].last - boxes[b].first > 1 && boxes[b].extent > 0 && score > bestScore)
+			{
+				bestScore = score;
+				split = (int)b;
+			}
+		}
+		if (split < 0) break;
+		Box box = boxes[split];
+		sort(used.begin() + box.first, used.begin() + box.last, [&](uint16_t a, uint16_t b) {
+			return component(a, box.axis) < component(b, box.axis);
+		});
+		// Mediana pela quantidade de pixels, sem deixar nenhum lado vazio
+		uint64_t half = box.pixels / 2, accumulated = 0;
+		size_t middle = box.first;
+		while (middle < box.last - 1 && accumulated + counts[used[middle]] <= half) accumulated += counts[used[middle++]];
+		if (middle == box.first) middle++;
+		Box low = { box.first, middle, 0, 0, 0 }, high = { middle, box.last, 0, 0, 0 };
+		measure(low);
+		measure(high);
+		boxes[split] = low;
+		boxes.push_back(high);
+	}
+
+	vector<uint8_t> binIndex(binCount, 0);
+	palette.assign(GIF_MAX_COLORS * 3, 0);
+	for (size_t b = 0; b < boxes.size(); b++)
+	{
+		uint64_t total[3] = { 0, 0, 0 }, pixels = 0;
+		for (size_t i = boxes[b].first; i < boxes[b].last; i++)
+		{
+			binIndex[used[i]] = (uint8_t)b;
+			for (int c = 0; c < 3; c++) total[c] += sums[used[i] * 3 + c];
+			pixels += counts[used[i]];
+		}
+		for (int c = 0; c < 3; c++) palette[b * 3 + c] = pixels ? (uint8_t)((total[c] + pixels / 2) / pixels) : 0;
+	}
+	indices.resize(pixelCount);
+	for (size_t i = 0; i < pixelCount; i++) indices[i] = binIndex[bins[i]];
+}
+
+// LZW do GIF com codigos de 8 bits, clear em 256, fim em 257 e tabela de ate 4096 codigos
+inline void gifLzwEncode(const vector<uint8_t>& indices, vector<uint8_t>& out)
+{
+	const int clearCode = 256, endCode = 257, maxCode = 4096;
+	const int tableSize = 8192;
+	vector<int32_t> keys(tableSize, -1);
+	vector<uint16_t> codes(tableSize);
+	vector<uint8_t> data;
+	BitWriter bits(data);
+	int codeSize = 9, nextCode = 258;
+	auto reset = [&]() {
+		fill(keys.begin(), keys.end(), -1);
+		codeSize = 9;
+		nextCode = 258;
+	};
+	bits.write(clearCode, codeSize);
+	if (!indices.empty())
+	{
+		int prefix = indices[0];
+		for (size_t i = 1; i < indices.size(); i++)
+		{
+			int32_t key = (prefix << 8) | indices[i];
+			uint32_t slot = ((uint32_t)key * 2654435761u) >> 19;
+			while (keys[slot] >= 0 && keys[slot] != key) slot = (slot + 1) & (tableSize - 1);
+			if (keys[slot] == key)
+			{
+				prefix = codes[slot];
+				continue;
+			}
+			bits.write(prefix, codeSize);
+			if (nextCode < maxCode)
+			{
+				keys[slot] = key;
+				codes[slot] = (uint16_t)nextCode++;
+				// O decodificador cria cada codigo um passo depois: aumenta quando passar de 2^codeSize
+				if (nextCode > (1 << codeSize) && codeSize < 12) codeSize++;
+			}
+			else
+			{
+				bits.write(clearCode, codeSize);
+				reset();
+			}
+			prefix = indices[i];
+		}
+		bits.write(prefix, codeSize);
+	}
+	bits.write(endCode, codeSize);
+	bits.flush();
+	// Sub-blocos de ate 255 bytes
+	out.push_back(8);
+	for (size_t offset = 0; offset < data.size(); offset += 255)
+	{
+		size_t block = min<size_t>(255, data.size() - offset);
+		out.push_back((uint8_t)block);
+		out.insert(out.end(), data.begin() + offset, data.begin() + offset + block);
+	}
+	out.push_back(0);
+}
+
+// Um frame do GIF animado (controle grafico, descritor, paleta local e dados); delay em centesimos
+inline void encodeGifFrame(const uint8_t* rgba, int width, int height, bool flipY, int delay, vector<uint8_t>& out)
+{
+	vector<uint8_t> palette, indices;
+	quantizeMedianCut(rgba, width, height, flipY, palette, indices);
+	const uint8_t control[] = { 0x21, 0xF9, 0x04, 0x04, (uint8_t)delay, (uint8_t)(delay >> 8), 0x00, 0x00 };
+	out.insert(out.end(), control, control + sizeof(control));
+	const uint8_t descriptor[] = { 0x2C, 0, 0, 0, 0, (uint8_t)width, (uint8_t)(width >> 8), (uint8_t)height, (uint8_t)(height >> 8), 0x87 };
+	out.insert(out.end(), descriptor, descriptor + sizeof(descriptor));
+	out.insert(out.end(), palette.begin(), palette.end());
+	gifLzwEncode(indices, out);
+}
+
+// Arquivo GIF animado em loop; os frames ja vem codificados por encodeGifFrame
+class GifWriter
+{
+public:
+	bool open(const string& path, int width, int height)
+	{
+		file.open(path, ios::binary);
+		if (!file.is_open()) return false;
+		const uint8_t header[] = { 'G', 'I', 'F', '8', '9', 'a', (uint8_t)width, (uint8_t)(width >> 8), (uint8_t)height, (uint8_t)(height >> 8), 0x00, 0x00, 0x00 };
+		file.write((const char*)header, sizeof(header));
+		const uint8_t loop[] = { 0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 0x03, 0x01, 0x00, 0x00, 0x00 };
+		file.write((const char*)loop, sizeof(loop));
+		return true;
+	}
+
+	void writeFrame(const vector<uint8_t>& frame)
+	{
+		file.write((const char*)frame.data(), frame.size());
+	}
+
+	void close()
+	{
+		if (!file.is_open()) return;
+		file.put(0x3B);
+		file.close();
+	}
+
+private:
+	ofstream file;
+};
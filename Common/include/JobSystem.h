@@ -0,0 +1,335 @@
+// Agendador de tarefas leve compartilhado pelos loaders e pelos sistemas de cada frame.
+// Cada thread (a principal e os workers) tem sua propria fila: quem agenda empilha no fim da
+// propria fila e consome do fim (LIFO, mais cache), e threads ociosas roubam do inicio da fila
+// das outras (FIFO, tarefas maiores e mais antigas). Conclusao e dependencias usam JobCounter:
+// cada tarefa incrementa o contador ao ser agendada e decrementa ao terminar, wait() executa
+// outras tarefas enquanto espera (e dorme quando nao ha nenhuma) e tarefas agendadas com uma
+// dependency so entram nas filas quando o contador do qual dependem chega a zero. Tarefas que
+// chamam OpenGL vao para runOnMainThread e so sao executadas pela thread que criou o JobSystem
+// (dona do contexto).
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <algorithm>
+
+class JobSystem;
+
+class JobCounter
+{
+public:
+	JobCounter() : pending(0) {}
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+	struct Continuation {
+		std::function<void()> task;
+		JobCounter* counter;
+		bool mainThread;
+	};
+	std::atomic<int> pending;
+	std::mutex continuationMutex;
+	std::vector<Continuation> continuations;
+};
+
+class JobSystem
+{
+public:
+	// workerCount < 0 usa um worker por nucleo alem da thread principal
+	explicit JobSystem(int workerCount = -1)
+		: mainThreadId(std::this_thread::get_id())
+	{
+		if (workerCount < 0)
+		{
+			workerCount = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+		}
+		for (int i = 0; i <= workerCount; i++)
+		{
+			queues.emplace_back(new WorkQueue());
+		}
+		for (int i = 1; i <= workerCount; i++)
+		{
+			workers.emplace_back(&JobSystem::workerLoop, this, i);
+		}
+	}
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	// Threads que executam tarefas, incluindo a principal
+	int threadCount() const { return (int)queues.size(); }
+
+	// Agenda task; counter (opcional) e decrementado quando ela terminar e, com dependency,
+	// a tarefa so e liberada quando esse contador chegar a zero
+	void run(std::function<void()> task, JobCounter* counter = nullptr, JobCounter* dependency = nullptr)
+	{
+		schedule(std::move(task), counter, dependency, false);
+	}
+
+	// Tarefas com chamadas OpenGL: so a thread principal executa (em wait ou pumpMainThread)
+	void runOnMainThread(std::function<void()> task, JobCounter* counter = nullptr, JobCounter* dependency = nullptr)
+	{
+		schedule(std::move(task), counter, dependency, true);
+	}
+
+	// Executa outras tarefas ate o contador zerar. Depois de wait o contador pode ser destruido
+	void wait(JobCounter& counter)
+	{
+		while (!counter.done())
+		{
+			if (executeOne()) continue;
+			// Sem tarefa para executar: dorme ate o contador zerar ou chegar trabalho novo
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wake.wait(lock, [&]() {
+				return counter.done() || queuedJobs.load(std::memory_order_acquire) > 0 || hasMainThreadJob();
+			});
+		}
+		// Garante que a thread que zerou o contador ja soltou o mutex dele
+		std::lock_guard<std::mutex> lock(counter.continuationMutex);
+	}
+
+	// Executa as tarefas de thread principal pendentes sem bloquear; retorna quantas rodaram
+	int pumpMainThread()
+	{
+		int executed = 0;
+		Job job;
+		while (popMainThread(job))
+		{
+			execute(job);
+			executed++;
+		}
+		return executed;
+	}
+
+	// Divide [first, last) em blocos de grain elementos e chama function(begin, end) em paralelo
+	template<typename Function>
+	void parallelFor(size_t first, size_t last, size_t grain, const Function& function)
+	{
+		if (first >= last) return;
+		grain = std::max<size_t>(grain, 1);
+		if (last - first <= grain || queues.size() == 1)
+		{
+			function(first, last);
+			return;
+		}
+		JobCounter counter;
+		for (size_t begin = first + grain; begin < last; begin += grain)
+		{
+			size_t end = std::min(begin + grain, last);
+			run([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+		// O primeiro bloco roda na thread que chamou
+		function(first, std::min(first + grain, last));
+		wait(counter);
+	}
+
+	bool isMainThread() const { return std::this_thread::get_id() == mainThreadId; }
+
+private:
+	struct Job {
+		std::function<void()> task;
+		JobCounter* counter = nullptr;
+	};
+
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	std::thread::id mainThreadId;
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	std::vector<std::thread> workers;
+	WorkQueue mainThreadQueue;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	std::atomic<int> queuedJobs{ 0 };
+	bool stopping = false;
+
+	// Worker atual e o JobSystem dono dele; cada JobSystem so reconhece os proprios workers
+	struct ThreadSlot {
+		const JobSystem* owner = nullptr;
+		int index = 0;
+	};
+
+	static ThreadSlot& threadSlot()
+	{
+		static thread_local ThreadSlot slot;
+		return slot;
+	}
+
+	// Indice da fila da thread atual: 1..N para os workers deste JobSystem, 0 para a principal e
+	// qualquer outra thread (inclusive workers de outro JobSystem)
+	int threadIndex() const
+	{
+		const ThreadSlot& slot = threadSlot();
+		return slot.owner == this ? slot.index : 0;
+	}
+
+	void schedule(std::function<void()> task, JobCounter* counter, JobCounter* dependency, bool mainThread)
+	{
+		if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+		if (dependency)
+		{
+			std::unique_lock<std::mutex> lock(dependency->continuationMutex);
+			if (!dependency->done())
+			{
+				dependency->continuations.push_back({ std::move(task), counter, mainThread });
+				return;
+			}
+		}
+		mainThread ? pushMainThread(std::move(task), counter) : push(std::move(task), counter);
+	}
+
+	void push(std::function<void()> task, JobCounter* counter)
+	{
+		WorkQueue& queue = *queues[threadIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back({ std::move(task), counter });
+		}
+		notifyWorker();
+	}
+
+	void pushMainThread(std::function<void()> task, JobCounter* counter)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mainThreadQueue.mutex);
+			mainThreadQueue.jobs.push_back({ std::move(task), counter });
+		}
+		// Acorda a thread principal se ela estiver dormindo em wait()
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		wake.notify_all();
+	}
+
+	bool hasMainThreadJob()
+	{
+		if (!isMainThread()) return false;
+		std::lock_guard<std::mutex> lock(mainThreadQueue.mutex);
+		return !mainThreadQueue.jobs.empty();
+	}
+
+	void notifyWorker()
+	{
+		queuedJobs.fetch_add(1, std::memory_order_release);
+		if (!workers.empty())
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			wake.notify_one();
+		}
+	}
+
+	bool popMainThread(Job& job)
+	{
+		if (!isMainThread()) return false;
+		std::lock_guard<std::mutex> lock(mainThreadQueue.mutex);
+		if (mainThreadQueue.jobs.empty()) return false;
+		job = std::move(mainThreadQueue.jobs.front());
+		mainThreadQueue.jobs.pop_front();
+		return true;
+	}
+
+	bool popOwn(Job& job)
+	{
+		WorkQueue& queue = *queues[threadIndex()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty()) return false;
+		job = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool steal(Job& job)
+	{
+		int self = threadIndex();
+		int count = (int)queues.size();
+		for (int offset = 1; offset < count; offset++)
+		{
+			WorkQueue& queue = *queues[(self + offset) % count];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty()) continue;
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+		return false;
+	}
+
+	bool executeOne()
+	{
+		Job job;
+		if (popMainThread(job) || popOwn(job) || steal(job))
+		{
+			execute(job);
+			return true;
+		}
+		return false;
+	}
+
+	void execute(Job& job)
+	{
+		job.task();
+		if (job.counter) finish(*job.counter);
+	}
+
+	// Decrementa o contador e libera as tarefas que dependiam dele
+	void finish(JobCounter& counter)
+	{
+		std::vector<JobCounter::Continuation> ready;
+		{
+			// Decrementa com o mutex travado: quem espera em wait() so segue depois que ele for solto
+			std::lock_guard<std::mutex> lock(counter.continuationMutex);
+			if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+			ready.swap(counter.continuations);
+		}
+		{
+			// Acorda quem dorme em wait() por esse contador
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			wake.notify_all();
+		}
+		for (JobCounter::Continuation& continuation : ready)
+		{
+			continuation.mainThread
+				? pushMainThread(std::move(continuation.task), continuation.counter)
+				: push(std::move(continuation.task), continuation.counter);
+		}
+	}
+
+	void workerLoop(int index)
+	{
+		threadSlot().owner = this;
+		threadSlot().index = index;
+		while (true)
+		{
+			if (executeOne()) continue;
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wake.wait(lock, [this]() { return stopping || queuedJobs.load(std::memory_order_acquire) > 0; });
+			if (stopping) return;
+		}
+	}
+};
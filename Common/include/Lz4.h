@@ -0,0 +1,163 @@
+// Compressao no formato de bloco do LZ4 (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md),
+// implementada aqui para nao trazer outra dependencia. O compressor e o guloso classico com
+// uma tabela hash de posicoes (rapido, taxa parecida com o LZ4 padrao); o descompressor checa
+// todos os limites, entao dados corrompidos retornam false em vez de escrever fora do buffer.
+
+#pragma once
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+
+using namespace std;
+
+const int LZ4_MIN_MATCH = 4;
+// O formato exige que os ultimos 5 bytes sejam literais e que o ultimo match comece
+// pelo menos 12 bytes antes do fim
+const int LZ4_LAST_LITERALS = 5;
+const int LZ4_MATCH_SAFE_DISTANCE = 12;
+const int LZ4_HASH_BITS = 16;
+const int LZ4_MAX_OFFSET = 65535;
+
+inline uint32_t lz4Read32(const unsigned char* p)
+{
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+inline uint32_t lz4Hash(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+inline void lz4WriteLength(vector<unsigned char>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back((unsigned char)length);
+}
+
+inline void lz4WriteSequence(vector<unsigned char>& out, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+	unsigned char token = (unsigned char)((literalLength >= 15 ? 15 : literalLength) << 4);
+	if (matchLength > 0)
+	{
+		size_t extra = matchLength - LZ4_MIN_MATCH;
+		token |= (unsigned char)(extra >= 15 ? 15 : extra);
+	}
+	out.push_back(token);
+	if (literalLength >= 15) lz4WriteLength(out, literalLength - 15);
+	out.insert(out.end(), literals, literals + literalLength);
+	if (matchLength == 0) return;
+	out.push_back((unsigned char)(offset & 0xFF));
+	out.push_back((unsigned char)(offset >> 8));
+	if (matchLength - LZ4_MIN_MATCH >= 15) lz4WriteLength(out, matchLength - LZ4_MIN_MATCH - 15);
+}
+
+// Comprime size bytes de input e acrescenta o bloco em out
+inline void lz4Compress(const unsigned char* input, size_t size, vector<unsigned char>& out)
+{
+	out.reserve(out.size() + size + size / 255 + 16);
+	size_t anchor = 0;
+	if (size > LZ4_MATCH_SAFE_DISTANCE)
+	{
+		vector<uint32_t> table((size_t)1 << LZ4_HASH_BITS, 0xFFFFFFFFu);
+		size_t matchLimit = size - LZ4_LAST_LITERALS;
+		size_t position = 0;
+		while (position + LZ4_MATCH_SAFE_DISTANCE < size)
+		{
+			uint32_t sequence = lz4Read32(input + position);
+			uint32_t hash = lz4Hash(sequence);
+			uint32_t candidate = table[hash];
+			table[hash] = (uint32_t)position;
+			if (candidate == 0xFFFFFFFFu || position - candidate > LZ4_MAX_OFFSET || lz4Read32(input + candidate) != sequence)
+			{
+				position++;
+				continue;
+			}
+			// Estende o match para tras sobre literais pendentes e para frente ate o limite
+			while (position > anchor && candidate > 0 && input[position - 1] == input[candidate - 1])
+			{
+				position--;
+				candidate--;
+			}
+			size_t length = LZ4_MIN_MATCH;
+			while (position + length < matchLimit && input[position + length] == input[candidate + length])
+			{
+				length++;
+			}
+			lz4WriteSequence(out, input + anchor, position - anchor, position - candidate, length);
+			position += length;
+			anchor = position;
+			if (position + LZ4_MATCH_SAFE_DISTANCE < size)
+			{
+				table[lz4Hash(lz4Read32(input + position - 2))] = (uint32_t)(position - 2);
+			}
+		}
+	}
+	lz4WriteSequence(out, input + anchor, size - anchor, 0, 0);
+}
+
+// Descomprime um bloco em output, que precisa ter exatamente outputSize bytes
+inline bool lz4Decompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize)
+{
+	const unsigned char* in = input;
+	const unsigned char* inEnd = input + inputSize;
+	unsigned char* out = output;
+	unsigned char* outEnd = output + outputSize;
+	while (in < inEnd)
+	{
+		unsigned token = *in++;
+		size_t literalLength = token >> 4;
+		if (literalLength == 15)
+		{
+			unsigned char extra;
+			do
+			{
+				if (in >= inEnd) return false;
+				extra = *in++;
+				literalLength += extra;
+			} while (extra == 255);
+		}
+		if ((size_t)(inEnd - in) < literalLength || (size_t)(outEnd - out) < literalLength) return false;
+		if (literalLength > 0) memcpy(out, in, literalLength);
+		in += literalLength;
+		out += literalLength;
+		// A ultima sequencia termina depois dos literais
+		if (in == inEnd) break;
+
+		if (inEnd - in < 2) return false;
+		size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+		if (offset == 0 || offset > (size_t)(out - output)) return false;
+		size_t matchLength = (token & 15);
+		if (matchLength == 15)
+		{
+			unsigned char extra;
+			do
+			{
+				if (in >= inEnd) return false;
+				extra = *in++;
+				matchLength += extra;
+			} while (extra == 255);
+		}
+		matchLength += LZ4_MIN_MATCH;
+		if ((size_t)(outEnd - out) < matchLength) return false;
+		// Copia byte a byte: o match pode se sobrepor ao que esta sendo escrito (offset < length)
+		const unsigned char* match = out - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(out, match, matchLength);
+			out += matchLength;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++) *out++ = match[i];
+		}
+	}
+	return out == outEnd;
+}
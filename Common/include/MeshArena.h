@@ -0,0 +1,110 @@
+// Junta varias malhas em um unico VBO/EBO para que a cena inteira possa ser desenhada
+// com um VAO so (glMultiDrawElementsIndirect). Cada malha guarda o seu intervalo de
+// indices, o baseVertex e a esfera envolvente usada no culling.
+
+#pragma once
+
+#include <cfloat>
+#include <string>
+#include <vector>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+#include "ObjLoader.h"
+#include "MeshOptimizer.h"
+
+using namespace std;
+
+struct MeshRange
+{
+	GLuint firstIndex;
+	GLuint indexCount;
+	GLint baseVertex;
+	GLuint vertexCount;
+	glm::vec3 aabbMin;
+	glm::vec3 aabbMax;
+	// xyz = centro, w = raio (espaco do objeto)
+	glm::vec4 boundingSphere;
+};
+
+class MeshArena
+{
+public:
+	GLuint VAO = 0, VBO = 0, EBO = 0;
+	vector<float> vertices;
+	vector<GLuint> indices;
+	vector<MeshRange> meshes;
+
+	// Recebe o array intercalado de parseObjFile (OBJ_VERTEX_STRIDE floats por vertice),
+	// remove vertices repetidos, otimiza a ordem para o cache de vertices e devolve o id da malha na arena
+	int addMesh(const vector<float>& interleaved)
+	{
+		MeshRange range;
+		range.firstIndex = (GLuint)indices.size();
+		range.baseVertex = (GLint)(vertices.size() / OBJ_VERTEX_STRIDE);
+		range.aabbMin = glm::vec3(FLT_MAX);
+		range.aabbMax = glm::vec3(-FLT_MAX);
+		vector<float> meshVertices;
+		vector<uint32_t> meshIndices;
+		size_t uniqueCount = indexVertices(interleaved, OBJ_VERTEX_STRIDE, meshVertices, meshIndices);
+		optimizeVertexCache(meshIndices, uniqueCount);
+		GLuint localCount = (GLuint)optimizeVertexFetch(meshVertices, OBJ_VERTEX_STRIDE, meshIndices);
+		for (GLuint i = 0; i < localCount; i++)
+		{
+			const float* v = &meshVertices[i * OBJ_VERTEX_STRIDE];
+			range.aabbMin = glm::min(range.aabbMin, glm::vec3(v[0], v[1], v[2]));
+			range.aabbMax = glm::max(range.aabbMax, glm::vec3(v[0], v[1], v[2]));
+		}
+		vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+		indices.insert(indices.end(), meshIndices.begin(), meshIndices.end());
+		range.indexCount = (GLuint)indices.size() - range.firstIndex;
+		range.vertexCount = localCount;
+		glm::vec3 center = (range.aabbMin + range.aabbMax) * 0.5f;
+		float radius = 0.0f;
+		for (GLuint i = 0; i < localCount; i++)
+		{
+			const float* v = &vertices[(range.baseVertex + i) * OBJ_VERTEX_STRIDE];
+			radius = glm::max(radius, glm::length(glm::vec3(v[0], v[1], v[2]) - center));
+		}
+		range.boundingSphere = glm::vec4(center, radius);
+		meshes.push_back(range);
+		return (int)meshes.size() - 1;
+	}
+
+	// Envia a arena para a GPU com o mesmo layout de atributos dos shaders sprite.vs/shader.vs
+	void upload()
+	{
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glGenBuffers(1, &VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+		glGenBuffers(1, &EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid*)(6 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid*)(8 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(3);
+		// O EBO fica registrado no VAO; o ARRAY_BUFFER pode ser desvinculado
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+
+	void release()
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+		VAO = VBO = EBO = 0;
+	}
+};
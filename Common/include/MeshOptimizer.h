@@ -0,0 +1,161 @@
+// Etapas de otimizacao de malha usadas pela MeshArena e pelo AssetConverter:
+// - indexVertices: remove vertices repetidos do array intercalado do parseObjFile;
+// - optimizeVertexCache: reordena triangulos para reaproveitar o cache pos-transformacao
+//   (algoritmo Tipsify, Sander, Nehab e Barczak, "Fast Triangle Reordering for Vertex Locality
+//   and Reduced Overdraw", 2007);
+// - optimizeVertexFetch: renumera os vertices na ordem do primeiro uso, para o VBO ser lido
+//   de forma sequencial;
+// - averageCacheMissRatio: vertices transformados por triangulo com um cache FIFO simulado.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <unordered_map>
+
+using namespace std;
+
+const int VERTEX_CACHE_SIZE = 16;
+
+// Devolve o numero de vertices unicos
+inline size_t indexVertices(const vector<float>& interleaved, int stride, vector<float>& vertices, vector<uint32_t>& indices)
+{
+	size_t count = interleaved.size() / stride;
+	unordered_map<string, uint32_t> uniqueVertices;
+	uniqueVertices.reserve(count);
+	vertices.clear();
+	indices.clear();
+	indices.reserve(count);
+	uint32_t uniqueCount = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		const float* v = &interleaved[i * stride];
+		string key((const char*)v, stride * sizeof(float));
+		auto found = uniqueVertices.find(key);
+		if (found != uniqueVertices.end())
+		{
+			indices.push_back(found->second);
+			continue;
+		}
+		uniqueVertices.emplace(move(key), uniqueCount);
+		indices.push_back(uniqueCount++);
+		vertices.insert(vertices.end(), v, v + stride);
+	}
+	return uniqueCount;
+}
+
+inline float averageCacheMissRatio(const vector<uint32_t>& indices, size_t vertexCount, int cacheSize = VERTEX_CACHE_SIZE)
+{
+	if (indices.empty()) return 0.0f;
+	// Vertice esta no cache se entrou ha menos de cacheSize misses
+	vector<size_t> insertedAt(vertexCount, 0);
+	size_t misses = 0;
+	for (uint32_t index : indices)
+	{
+		if (insertedAt[index] == 0 || misses - insertedAt[index] >= (size_t)cacheSize)
+		{
+			misses++;
+			insertedAt[index] = misses;
+		}
+	}
+	return (float)misses / (indices.size() / 3);
+}
+
+inline void optimizeVertexCache(vector<uint32_t>& indices, size_t vertexCount, int cacheSize = VERTEX_CACHE_SIZE)
+{
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+	// Lista de triangulos de cada vertice (CSR)
+	vector<uint32_t> offsets(vertexCount + 1, 0);
+	for (uint32_t index : indices) offsets[index + 1]++;
+	for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] += offsets[v];
+	vector<uint32_t> adjacency(indices.size());
+	vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+	}
+
+	vector<uint32_t> live(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) live[v] = offsets[v + 1] - offsets[v];
+	vector<int> cacheTime(vertexCount, 0);
+	vector<bool> emitted(triangleCount, false);
+	vector<uint32_t> deadEnd;
+	vector<uint32_t> output;
+	output.reserve(indices.size());
+	int time = cacheSize + 1;
+	size_t cursor = 0;
+	int fanning = 0;
+	while (fanning >= 0)
+	{
+		vector<uint32_t> candidates;
+		for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; a++)
+		{
+			uint32_t t = adjacency[a];
+			if (emitted[t]) continue;
+			emitted[t] = true;
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[t * 3 + k];
+				output.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+				if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+			}
+		}
+		// Proximo leque: o candidato ainda no cache que vai ficar mais tempo la
+		int best = -1, bestPriority = -1;
+		for (uint32_t v : candidates)
+		{
+			if (live[v] == 0) continue;
+			int priority = 0;
+			if (time - cacheTime[v] + 2 * (int)live[v] <= cacheSize) priority = time - cacheTime[v];
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				best = (int)v;
+			}
+		}
+		if (best < 0)
+		{
+			// Sem candidato: volta pela pilha de vertices recentes e depois varre o resto em ordem
+			while (!deadEnd.empty() && best < 0)
+			{
+				uint32_t v = deadEnd.back();
+				deadEnd.pop_back();
+				if (live[v] > 0) best = (int)v;
+			}
+			while (best < 0 && cursor < vertexCount)
+			{
+				if (live[cursor] > 0) best = (int)cursor;
+				cursor++;
+			}
+		}
+		fanning = best;
+	}
+	indices.swap(output);
+}
+
+// Reordena vertices na ordem do primeiro uso pelos indices (e descarta os nao usados)
+inline size_t optimizeVertexFetch(vector<float>& vertices, int stride, vector<uint32_t>& indices)
+{
+	size_t vertexCount = vertices.size() / stride;
+	vector<uint32_t> remap(vertexCount, UINT32_MAX);
+	vector<float> reordered;
+	reordered.reserve(vertices.size());
+	uint32_t next = 0;
+	for (uint32_t& index : indices)
+	{
+		if (remap[index] == UINT32_MAX)
+		{
+			remap[index] = next++;
+			reordered.insert(reordered.end(), vertices.begin() + (size_t)index * stride, vertices.begin() + ((size_t)index + 1) * stride);
+		}
+		index = remap[index];
+	}
+	vertices.swap(reordered);
+	return next;
+}
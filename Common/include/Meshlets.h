@@ -0,0 +1,313 @@
+// Divide uma malha indexada em meshlets (ate 64 vertices e 124 triangulos, os limites usados
+// em mesh shaders) para culling por grupo de triangulos. Os triangulos sao agrupados por
+// posicao e orientacao (divisao recursiva pela mediana) e o index buffer e reordenado para
+// que cada meshlet seja um intervalo continuo, que vira direto um comando de
+// glMultiDrawElementsIndirect.
+// Cada meshlet guarda uma esfera envolvente (culling pelo frustum) e um cone de normais
+// (culling de meshlets inteiros de costas para a camera). O culling testa 4 meshlets por vez
+// com SSE, sobre os limites em SoA.
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <algorithm>
+
+#include <immintrin.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+using namespace std;
+
+const int MESHLET_MAX_VERTICES = 64;
+const int MESHLET_MAX_TRIANGLES = 124;
+
+struct Meshlet {
+	uint32_t firstIndex;
+	uint32_t triangleCount;
+	uint32_t vertexCount;
+	glm::vec3 center;
+	float radius;
+	glm::vec3 coneAxis;
+	// sin do meio-angulo do cone; 1 = normais espalhadas demais, nunca e descartado por cone
+	float coneCutoff;
+};
+
+// Limites de todos os meshlets em SoA, com o tamanho arredondado para multiplo de 4
+struct MeshletBounds {
+	vector<float> centerX, centerY, centerZ, radius;
+	vector<float> axisX, axisY, axisZ, cutoff;
+};
+
+struct MeshletSet {
+	vector<Meshlet> meshlets;
+	MeshletBounds bounds;
+};
+
+inline void computeMeshletBounds(const vector<float>& vertices, int stride, const vector<uint32_t>& indices, Meshlet& meshlet)
+{
+	glm::vec3 minimum(FLT_MAX), maximum(-FLT_MAX);
+	glm::vec3 normalSum(0.0f);
+	uint32_t first = meshlet.firstIndex, last = meshlet.firstIndex + meshlet.triangleCount * 3;
+	for (uint32_t i = first; i < last; i += 3)
+	{
+		glm::vec3 p[3];
+		for (int k = 0; k < 3; k++)
+		{
+			const float* v = &vertices[(size_t)indices[i + k] * stride];
+			p[k] = glm::vec3(v[0], v[1], v[2]);
+			minimum = glm::min(minimum, p[k]);
+			maximum = glm::max(maximum, p[k]);
+		}
+		glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+		if (glm::length(normal) > 0.0f) normalSum += glm::normalize(normal);
+	}
+	meshlet.center = (minimum + maximum) * 0.5f;
+	meshlet.radius = 0.0f;
+	float minimumDot = 1.0f;
+	bool hasAxis = glm::length(normalSum) > 1e-6f;
+	meshlet.coneAxis = hasAxis ? glm::normalize(normalSum) : glm::vec3(0.0f, 0.0f, 1.0f);
+	for (uint32_t i = first; i < last; i += 3)
+	{
+		glm::vec3 p[3];
+		for (int k = 0; k < 3; k++)
+		{
+			const float* v = &vertices[(size_t)indices[i + k] * stride];
+			p[k] = glm::vec3(v[0], v[1], v[2]);
+			meshlet.radius = max(meshlet.radius, glm::length(p[k] - meshlet.center));
+		}
+		glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+		if (glm::length(normal) > 0.0f) minimumDot = min(minimumDot, glm::dot(glm::normalize(normal), meshlet.coneAxis));
+	}
+	// Cone com abertura >= 90 graus nao garante nada
+	meshlet.coneCutoff = hasAxis && minimumDot > 0.0f ? sqrt(1.0f - minimumDot * minimumDot) : 1.0f;
+}
+
+// Peso da normal contra a posicao (normalizada pelo tamanho da malha) ao agrupar triangulos:
+// maior = cones mais fechados (mais culling por orientacao), menor = esferas menores
+const float MESHLET_NORMAL_WEIGHT = 1.0f;
+
+struct MeshletTriangle {
+	uint32_t index;
+	float key[6];
+};
+
+// Divide os triangulos [first, last) pela mediana na dimensao de maior espalhamento
+// (centroide + normal) ate cada grupo caber nos limites de um meshlet
+inline void splitMeshletTriangles(vector<MeshletTriangle>& triangles, size_t first, size_t last, const vector<uint32_t>& indices,
+	vector<uint32_t>& owner, uint32_t& stamp, vector<pair<size_t, size_t>>& leaves)
+{
+	size_t count = last - first;
+	if (count <= (size_t)MESHLET_MAX_TRIANGLES)
+	{
+		stamp++;
+		uint32_t unique = 0;
+		for (size_t t = first; t < last; t++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[triangles[t].index * 3 + k];
+				if (owner[v] != stamp)
+				{
+					owner[v] = stamp;
+					unique++;
+				}
+			}
+		}
+		if (unique <= (uint32_t)MESHLET_MAX_VERTICES || count == 1)
+		{
+			leaves.push_back(make_pair(first, last));
+			return;
+		}
+	}
+	int axis = 0;
+	float bestSpread = -1.0f;
+	for (int d = 0; d < 6; d++)
+	{
+		float low = FLT_MAX, high = -FLT_MAX;
+		for (size_t t = first; t < last; t++)
+		{
+			low = min(low, triangles[t].key[d]);
+			high = max(high, triangles[t].key[d]);
+		}
+		if (high - low > bestSpread)
+		{
+			bestSpread = high - low;
+			axis = d;
+		}
+	}
+	size_t middle = first + count / 2;
+	nth_element(triangles.begin() + first, triangles.begin() + middle, triangles.begin() + last,
+		[axis](const MeshletTriangle& a, const MeshletTriangle& b) { return a.key[axis] < b.key[axis]; });
+	splitMeshletTriangles(triangles, first, middle, indices, owner, stamp, leaves);
+	splitMeshletTriangles(triangles, middle, last, indices, owner, stamp, leaves);
+}
+
+// vertices intercalados com a posicao nos 3 primeiros floats de cada vertice. Reordena os
+// triangulos de indices para que cada meshlet fique continuo; dentro do meshlet a ordem
+// original (a do optimizeVertexCache) e mantida
+inline MeshletSet buildMeshlets(const vector<float>& vertices, int stride, vector<uint32_t>& indices)
+{
+	MeshletSet set;
+	size_t vertexCount = vertices.size() / stride;
+	size_t triangleCount = indices.size() / 3;
+	vector<MeshletTriangle> triangles(triangleCount);
+	glm::vec3 minimum(FLT_MAX), maximum(-FLT_MAX);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		glm::vec3 p(vertices[v * stride], vertices[v * stride + 1], vertices[v * stride + 2]);
+		minimum = glm::min(minimum, p);
+		maximum = glm::max(maximum, p);
+	}
+	glm::vec3 extent = maximum - minimum;
+	float scale = 1.0f / max(1e-6f, max(extent.x, max(extent.y, extent.z)));
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		glm::vec3 p[3];
+		for (int k = 0; k < 3; k++)
+		{
+			const float* v = &vertices[(size_t)indices[t * 3 + k] * stride];
+			p[k] = glm::vec3(v[0], v[1], v[2]);
+		}
+		glm::vec3 centroid = (p[0] + p[1] + p[2]) / 3.0f * scale;
+		glm::vec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+		normal = glm::length(normal) > 0.0f ? glm::normalize(normal) * MESHLET_NORMAL_WEIGHT : glm::vec3(0.0f);
+		triangles[t] = { (uint32_t)t, { centroid.x, centroid.y, centroid.z, normal.x, normal.y, normal.z } };
+	}
+	vector<uint32_t> owner(vertexCount, 0);
+	uint32_t stamp = 0;
+	vector<pair<size_t, size_t>> leaves;
+	if (triangleCount > 0) splitMeshletTriangles(triangles, 0, triangleCount, indices, owner, stamp, leaves);
+
+	vector<uint32_t> reordered;
+	reordered.reserve(indices.size());
+	for (const pair<size_t, size_t>& leaf : leaves)
+	{
+		sort(triangles.begin() + leaf.first, triangles.begin() + leaf.second,
+			[](const MeshletTriangle& a, const MeshletTriangle& b) { return a.index < b.index; });
+		Meshlet meshlet = {};
+		meshlet.firstIndex = (uint32_t)reordered.size();
+		meshlet.triangleCount = (uint32_t)(leaf.second - leaf.first);
+		stamp++;
+		for (size_t t = leaf.first; t < leaf.second; t++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				uint32_t v = indices[triangles[t].index * 3 + k];
+				reordered.push_back(v);
+				if (owner[v] != stamp)
+				{
+					owner[v] = stamp;
+					meshlet.vertexCount++;
+				}
+			}
+		}
+		set.meshlets.push_back(meshlet);
+	}
+	indices.swap(reordered);
+	for (Meshlet& meshlet : set.meshlets)
+	{
+		computeMeshletBounds(vertices, stride, indices, meshlet);
+	}
+
+	MeshletBounds& b = set.bounds;
+	size_t padded = (set.meshlets.size() + 3) & ~(size_t)3;
+	for (vector<float>* v : { &b.centerX, &b.centerY, &b.centerZ, &b.radius, &b.axisX, &b.axisY, &b.axisZ })
+	{
+		v->assign(padded, 0.0f);
+	}
+	b.cutoff.assign(padded, 1.0f);
+	for (size_t m = 0; m < set.meshlets.size(); m++)
+	{
+		const Meshlet& meshlet = set.meshlets[m];
+		b.centerX[m] = meshlet.center.x; b.centerY[m] = meshlet.center.y; b.centerZ[m] = meshlet.center.z;
+		b.radius[m] = meshlet.radius;
+		b.axisX[m] = meshlet.coneAxis.x; b.axisY[m] = meshlet.coneAxis.y; b.axisZ[m] = meshlet.coneAxis.z;
+		b.cutoff[m] = meshlet.coneCutoff;
+	}
+	return set;
+}
+
+// Referencia escalar. planes e camera no espaco do objeto (Frustum::fromMatrix(projection * view * model)
+// e inverse(model) * posicao da camera; vale para modelos com escala uniforme)
+inline bool meshletVisible(const Meshlet& meshlet, const glm::vec4 planes[6], const glm::vec3& camera)
+{
+	for (int p = 0; p < 6; p++)
+	{
+		if (glm::dot(glm::vec3(planes[p]), meshlet.center) + planes[p].w < -meshlet.radius) return false;
+	}
+	// Todo o meshlet esta de costas se a direcao ate ele cai dentro do cone oposto as normais
+	glm::vec3 toCenter = meshlet.center - camera;
+	return glm::dot(toCenter, meshlet.coneAxis) < meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius;
+}
+
+// Escreve 1/0 em visible (um por meshlet) e devolve quantos passaram
+inline size_t cullMeshlets(const MeshletSet& set, const glm::vec4 planes[6], const glm::vec3& camera, vector<uint8_t>& visible)
+{
+	const MeshletBounds& b = set.bounds;
+	size_t count = set.meshlets.size();
+	visible.resize(b.radius.size());
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+	for (int p = 0; p < 6; p++)
+	{
+		planeX[p] = _mm_set1_ps(planes[p].x);
+		planeY[p] = _mm_set1_ps(planes[p].y);
+		planeZ[p] = _mm_set1_ps(planes[p].z);
+		planeW[p] = _mm_set1_ps(planes[p].w);
+	}
+	__m128 cameraX = _mm_set1_ps(camera.x), cameraY = _mm_set1_ps(camera.y), cameraZ = _mm_set1_ps(camera.z);
+	size_t visibleCount = 0;
+	for (size_t m = 0; m < count; m += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&b.centerX[m]), cy = _mm_loadu_ps(&b.centerY[m]), cz = _mm_loadu_ps(&b.centerZ[m]);
+		__m128 radius = _mm_loadu_ps(&b.radius[m]);
+		__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+		__m128 culled = _mm_setzero_ps();
+		for (int p = 0; p < 6; p++)
+		{
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], cx), _mm_mul_ps(planeY[p], cy)),
+				_mm_add_ps(_mm_mul_ps(planeZ[p], cz), planeW[p]));
+			culled = _mm_or_ps(culled, _mm_cmplt_ps(distance, negativeRadius));
+		}
+		__m128 dx = _mm_sub_ps(cx, cameraX), dy = _mm_sub_ps(cy, cameraY), dz = _mm_sub_ps(cz, cameraZ);
+		__m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+		__m128 along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(&b.axisX[m])), _mm_mul_ps(dy, _mm_loadu_ps(&b.axisY[m]))),
+			_mm_mul_ps(dz, _mm_loadu_ps(&b.axisZ[m])));
+		__m128 limit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&b.cutoff[m]), length), radius);
+		culled = _mm_or_ps(culled, _mm_cmpge_ps(along, limit));
+		int mask = _mm_movemask_ps(culled);
+		for (int k = 0; k < 4; k++)
+		{
+			visible[m + k] = (uint8_t)((mask >> k & 1) == 0);
+		}
+	}
+	for (size_t m = 0; m < count; m++) visibleCount += visible[m];
+	return visibleCount;
+}
+
+// Um comando por sequencia de meshlets visiveis vizinhos (os intervalos de indices sao continuos)
+template<typename Command>
+inline size_t appendMeshletDraws(const MeshletSet& set, const vector<uint8_t>& visible, vector<Command>& commands)
+{
+	size_t triangles = 0;
+	for (size_t m = 0; m < set.meshlets.size(); m++)
+	{
+		if (!visible[m]) continue;
+		const Meshlet& meshlet = set.meshlets[m];
+		triangles += meshlet.triangleCount;
+		if (m > 0 && visible[m - 1] && !commands.empty())
+		{
+			commands.back().count += meshlet.triangleCount * 3;
+			continue;
+		}
+		Command command = {};
+		command.count = meshlet.triangleCount * 3;
+		command.instanceCount = 1;
+		command.firstIndex = meshlet.firstIndex;
+		commands.push_back(command);
+	}
+	return triangles;
+}
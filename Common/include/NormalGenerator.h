@@ -0,0 +1,200 @@
+// Geracao de normais suaves e tangentes para malhas sem vn (scans, exports crus).
+// A entrada e uma lista de triangulos com o indice da posicao de cada canto; a saida e um
+// valor por canto, entao cantos da mesma posicao podem ter normais diferentes nas quinas.
+// - Normal: soma das normais das faces em volta da posicao, com peso area * angulo do canto
+//   (Thurmer e Wuthrich), ignorando faces que formam mais que creaseAngle com a face do canto;
+// - Tangente: direcao de u no espaco do objeto (Lengyel), ortogonalizada contra a normal,
+//   com w = +-1 indicando a orientacao da bitangente.
+// As etapas rodam em blocos no JobSystem. A lista de cantos de cada posicao e montada sem
+// atomicos: cada bloco conta e escreve nas suas proprias faixas (contagem por bloco).
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+
+using namespace std;
+
+const float DEFAULT_CREASE_ANGLE = 60.0f;
+const size_t NORMAL_GENERATOR_GRAIN = 4096;
+
+// Cantos (triangulo * 3 + k) que usam cada posicao, no formato CSR
+struct CornerAdjacency {
+	vector<uint32_t> offsets;
+	vector<uint32_t> corners;
+};
+
+// Divide [0, count) em um bloco por thread e chama fn(bloco, inicio, fim)
+template<typename Function>
+inline void forEachBlock(JobSystem* jobs, size_t count, size_t blockCount, const Function& fn)
+{
+	size_t blockSize = (count + blockCount - 1) / blockCount;
+	auto runBlocks = [&](size_t first, size_t last) {
+		for (size_t block = first; block < last; block++)
+		{
+			fn(block, min(count, block * blockSize), min(count, (block + 1) * blockSize));
+		}
+	};
+	if (jobs) jobs->parallelFor(0, blockCount, 1, runBlocks);
+	else runBlocks(0, blockCount);
+}
+
+template<typename Function>
+inline void forEachRange(JobSystem* jobs, size_t count, const Function& fn)
+{
+	if (jobs) jobs->parallelFor(0, count, NORMAL_GENERATOR_GRAIN, fn);
+	else fn(0, count);
+}
+
+inline void buildCornerAdjacency(const vector<uint32_t>& positionIndices, size_t positionCount, CornerAdjacency& adjacency, JobSystem* jobs = nullptr)
+{
+	size_t cornerCount = positionIndices.size();
+	size_t blockCount = jobs && cornerCount > NORMAL_GENERATOR_GRAIN ? (size_t)jobs->threadCount() : 1;
+	// counts[bloco * positionCount + posicao]; vira o cursor de escrita de cada bloco
+	vector<uint32_t> counts(blockCount * positionCount, 0);
+	forEachBlock(jobs, cornerCount, blockCount, [&](size_t block, size_t first, size_t last) {
+		uint32_t* blockCounts = &counts[block * positionCount];
+		for (size_t corner = first; corner < last; corner++) blockCounts[positionIndices[corner]]++;
+	});
+	adjacency.offsets.assign(positionCount + 1, 0);
+	uint32_t offset = 0;
+	for (size_t position = 0; position < positionCount; position++)
+	{
+		adjacency.offsets[position] = offset;
+		for (size_t block = 0; block < blockCount; block++)
+		{
+			uint32_t count = counts[block * positionCount + position];
+			counts[block * positionCount + position] = offset;
+			offset += count;
+		}
+	}
+	adjacency.offsets[positionCount] = offset;
+	adjacency.corners.resize(cornerCount);
+	forEachBlock(jobs, cornerCount, blockCount, [&](size_t block, size_t first, size_t last) {
+		uint32_t* cursor = &counts[block * positionCount];
+		for (size_t corner = first; corner < last; corner++) adjacency.corners[cursor[positionIndices[corner]]++] = (uint32_t)corner;
+	});
+}
+
+inline float cornerAngle(const glm::vec3& corner, const glm::vec3& a, const glm::vec3& b)
+{
+	glm::vec3 u = a - corner, v = b - corner;
+	float lengths = glm::length(u) * glm::length(v);
+	if (lengths <= 0.0f) return 0.0f;
+	return acos(glm::clamp(glm::dot(u, v) / lengths, -1.0f, 1.0f));
+}
+
+// normals recebe uma normal por canto (positionIndices.size())
+inline void generateNormals(const vector<glm::vec3>& positions, const vector<uint32_t>& positionIndices, float creaseAngle,
+	vector<glm::vec3>& normals, JobSystem* jobs = nullptr)
+{
+	size_t triangleCount = positionIndices.size() / 3;
+	// Normal da face sem normalizar (comprimento = 2 * area) vezes o angulo de cada canto
+	vector<glm::vec3> faceNormals(triangleCount);
+	vector<glm::vec3> weighted(triangleCount * 3);
+	forEachRange(jobs, triangleCount, [&](size_t first, size_t last) {
+		for (size_t t = first; t < last; t++)
+		{
+			const glm::vec3& p0 = positions[positionIndices[t * 3]];
+			const glm::vec3& p1 = positions[positionIndices[t * 3 + 1]];
+			const glm::vec3& p2 = positions[positionIndices[t * 3 + 2]];
+			glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+			faceNormals[t] = glm::length(faceNormal) > 0.0f ? glm::normalize(faceNormal) : glm::vec3(0.0f);
+			weighted[t * 3] = faceNormal * cornerAngle(p0, p1, p2);
+			weighted[t * 3 + 1] = faceNormal * cornerAngle(p1, p2, p0);
+			weighted[t * 3 + 2] = faceNormal * cornerAngle(p2, p0, p1);
+		}
+	});
+
+	CornerAdjacency adjacency;
+	buildCornerAdjacency(positionIndices, positions.size(), adjacency, jobs);
+	float creaseCos = creaseAngle >= 180.0f ? -2.0f : cos(glm::radians(creaseAngle));
+	normals.resize(positionIndices.size());
+	forEachRange(jobs, positionIndices.size(), [&](size_t first, size_t last) {
+		for (size_t corner = first; corner < last; corner++)
+		{
+			const glm::vec3& faceNormal = faceNormals[corner / 3];
+			uint32_t position = positionIndices[corner];
+			glm::vec3 sum(0.0f);
+			for (uint32_t a = adjacency.offsets[position]; a < adjacency.offsets[position + 1]; a++)
+			{
+				uint32_t other = adjacency.corners[a];
+				if (glm::dot(faceNormals[other / 3], faceNormal) >= creaseCos) sum += weighted[other];
+			}
+			float length = glm::length(sum);
+			normals[corner] = length > 0.0f ? sum / length : (glm::length(faceNormal) > 0.0f ? faceNormal : glm::vec3(0.0f, 1.0f, 0.0f));
+		}
+	});
+}
+
+// tangents recebe uma tangente por canto; uvs e normals sao por canto
+inline void generateTangents(const vector<glm::vec3>& positions, const vector<uint32_t>& positionIndices, const vector<glm::vec2>& uvs,
+	const vector<glm::vec3>& normals, vector<glm::vec4>& tangents, JobSystem* jobs = nullptr)
+{
+	size_t triangleCount = positionIndices.size() / 3;
+	// Direcoes de u (s) e v (t) de cada triangulo, com peso da area
+	vector<glm::vec3> sDirections(triangleCount), tDirections(triangleCount);
+	forEachRange(jobs, triangleCount, [&](size_t first, size_t last) {
+		for (size_t t = first; t < last; t++)
+		{
+			const glm::vec3& p0 = positions[positionIndices[t * 3]];
+			glm::vec3 e1 = positions[positionIndices[t * 3 + 1]] - p0;
+			glm::vec3 e2 = positions[positionIndices[t * 3 + 2]] - p0;
+			glm::vec2 d1 = uvs[t * 3 + 1] - uvs[t * 3];
+			glm::vec2 d2 = uvs[t * 3 + 2] - uvs[t * 3];
+			float det = d1.x * d2.y - d2.x * d1.y;
+			if (fabs(det) < 1e-12f)
+			{
+				sDirections[t] = tDirections[t] = glm::vec3(0.0f);
+				continue;
+			}
+			// Normalizar e depois pesar pela area deixa triangulos com uv esticado com o mesmo peso
+			float area = glm::length(glm::cross(e1, e2));
+			glm::vec3 s = (e1 * d2.y - e2 * d1.y) / det;
+			glm::vec3 tv = (e2 * d1.x - e1 * d2.x) / det;
+			sDirections[t] = glm::length(s) > 0.0f ? glm::normalize(s) * area : s;
+			tDirections[t] = glm::length(tv) > 0.0f ? glm::normalize(tv) * area : tv;
+		}
+	});
+
+	CornerAdjacency adjacency;
+	buildCornerAdjacency(positionIndices, positions.size(), adjacency, jobs);
+	tangents.resize(positionIndices.size());
+	forEachRange(jobs, positionIndices.size(), [&](size_t first, size_t last) {
+		for (size_t corner = first; corner < last; corner++)
+		{
+			const glm::vec3& normal = normals[corner];
+			const glm::vec3& ownS = sDirections[corner / 3];
+			const glm::vec3& ownT = tDirections[corner / 3];
+			bool ownMirrored = glm::dot(glm::cross(normal, ownS), ownT) < 0.0f;
+			uint32_t position = positionIndices[corner];
+			glm::vec3 s(0.0f), tv(0.0f);
+			// So junta cantos com a mesma normal e a mesma orientacao de uv (costuras espelhadas separam)
+			for (uint32_t a = adjacency.offsets[position]; a < adjacency.offsets[position + 1]; a++)
+			{
+				uint32_t other = adjacency.corners[a];
+				const glm::vec3& otherS = sDirections[other / 3];
+				const glm::vec3& otherT = tDirections[other / 3];
+				if (glm::dot(normals[other], normal) < 0.999f) continue;
+				if ((glm::dot(glm::cross(normal, otherS), otherT) < 0.0f) != ownMirrored) continue;
+				s += otherS;
+				tv += otherT;
+			}
+			// Gram-Schmidt; sem uv valido usa qualquer vetor perpendicular a normal
+			glm::vec3 tangent = s - normal * glm::dot(normal, s);
+			if (glm::length(tangent) < 1e-12f)
+			{
+				tangent = glm::cross(fabs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f), normal);
+			}
+			tangent = glm::normalize(tangent);
+			float handedness = glm::dot(glm::cross(normal, tangent), tv) < 0.0f ? -1.0f : 1.0f;
+			tangents[corner] = glm::vec4(tangent, handedness);
+		}
+	});
+}
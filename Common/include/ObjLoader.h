@@ -0,0 +1,248 @@
+// Leitura de OBJ/MTL compartilhada entre os modulos.
+// Gera o mesmo array intercalado usado em Camera/SuzannePhong:
+// posicao (3), cor (3), coordenada de textura (2), normal (3) = 11 floats por vertice.
+// Faces com mais de 3 vertices viram leques de triangulos, indices negativos (relativos) sao
+// aceitos e cantos sem vt/vn recebem uv (0, 0) e uma normal suave gerada (NormalGenerator.h).
+// Com vt no arquivo, loadObj tambem gera as tangentes (xyz + sinal da bitangente em w).
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+
+#include "NormalGenerator.h"
+
+using namespace std;
+
+const int OBJ_VERTEX_STRIDE = 11;
+
+struct Vertex {
+	float x, y, z;
+};
+
+struct Normal {
+	float nx, ny, nz;
+};
+
+struct TextureCoordinate {
+	float u, v;
+};
+
+struct FaceVertex {
+	int vertexIndex, uvIndex, normalIndex;
+};
+
+// Malha triangulada com atributos por canto (3 por triangulo)
+struct ObjMesh {
+	vector<glm::vec3> positions;
+	vector<uint32_t> positionIndices;
+	vector<glm::vec2> uvs;
+	vector<glm::vec3> normals;
+	// Vazio se o arquivo nao tem vt ou a geracao foi desligada
+	vector<glm::vec4> tangents;
+	// Cantos sem vn no arquivo, que receberam normal gerada
+	size_t generatedNormals = 0;
+};
+
+struct Material {
+	string name;
+	float Ns;
+	float Ka[3];
+	float Ks[3];
+	float Ke[3];
+	float Ni;
+	float d;
+	int illum;
+	string map_Kd;
+};
+
+// Le "v", "v/t", "v//n" ou "v/t/n" a partir de cursor, parando no primeiro espaco; indices ausentes ficam -1
+inline bool parseFaceVertex(const char*& cursor, int vertexCount, int uvCount, int normalCount, FaceVertex& fv)
+{
+	int counts[3] = { vertexCount, uvCount, normalCount };
+	int indices[3] = { -1, -1, -1 };
+	for (int field = 0; field < 3 && *cursor && *cursor != ' ' && *cursor != '\t' && *cursor != '\r'; field++)
+	{
+		if (*cursor != '/')
+		{
+			char* end;
+			long index = strtol(cursor, &end, 10);
+			if (end == cursor) return false;
+			// 1 = primeiro elemento, -1 = ultimo lido ate aqui
+			indices[field] = index > 0 ? (int)index - 1 : counts[field] + (int)index;
+			if (indices[field] < 0 || indices[field] >= counts[field]) return false;
+			cursor = end;
+		}
+		if (*cursor == '/') cursor++;
+	}
+	fv = { indices[0], indices[1], indices[2] };
+	return indices[0] >= 0;
+}
+
+inline bool parseFaceVertex(const string& token, int vertexCount, int uvCount, int normalCount, FaceVertex& fv)
+{
+	const char* cursor = token.c_str();
+	return parseFaceVertex(cursor, vertexCount, uvCount, normalCount, fv);
+}
+
+// jobs (opcional) paraleliza a geracao de normais e tangentes
+inline bool loadObj(istream& file, ObjMesh& mesh, JobSystem* jobs = nullptr, float creaseAngle = DEFAULT_CREASE_ANGLE,
+	bool withTangents = true)
+{
+	vector<glm::vec2> textures;
+	vector<glm::vec3> normals;
+	vector<FaceVertex> corners;
+	mesh = ObjMesh();
+	string line;
+	vector<FaceVertex> faceVertices;
+	while (getline(file, line))
+	{
+		if (line.empty() || line[0] == '#') continue;
+		istringstream iss(line);
+		string keyword;
+		iss >> keyword;
+		if (keyword == "v")
+		{
+			glm::vec3 vertex;
+			iss >> vertex.x >> vertex.y >> vertex.z;
+			mesh.positions.push_back(vertex);
+		}
+		else if (keyword == "vn")
+		{
+			glm::vec3 normal;
+			iss >> normal.x >> normal.y >> normal.z;
+			normals.push_back(normal);
+		}
+		else if (keyword == "vt")
+		{
+			glm::vec2 texture;
+			iss >> texture.x >> texture.y;
+			textures.push_back(texture);
+		}
+		else if (keyword == "f")
+		{
+			faceVertices.clear();
+			string faceVertexStr;
+			while (iss >> faceVertexStr)
+			{
+				FaceVertex fv;
+				if (!parseFaceVertex(faceVertexStr, (int)mesh.positions.size(), (int)textures.size(), (int)normals.size(), fv))
+				{
+					cerr << "Invalid OBJ face vertex: " << faceVertexStr << endl;
+					return false;
+				}
+				faceVertices.push_back(fv);
+			}
+			for (size_t k = 1; k + 1 < faceVertices.size(); k++)
+			{
+				corners.push_back(faceVertices[0]);
+				corners.push_back(faceVertices[k]);
+				corners.push_back(faceVertices[k + 1]);
+			}
+		}
+	}
+	mesh.positionIndices.resize(corners.size());
+	mesh.uvs.resize(corners.size());
+	mesh.normals.resize(corners.size());
+	for (size_t i = 0; i < corners.size(); i++)
+	{
+		const FaceVertex& fv = corners[i];
+		mesh.positionIndices[i] = (uint32_t)fv.vertexIndex;
+		mesh.uvs[i] = fv.uvIndex >= 0 ? textures[fv.uvIndex] : glm::vec2(0.0f);
+		if (fv.normalIndex >= 0) mesh.normals[i] = normals[fv.normalIndex];
+		else mesh.generatedNormals++;
+	}
+	if (mesh.generatedNormals > 0)
+	{
+		vector<glm::vec3> generated;
+		generateNormals(mesh.positions, mesh.positionIndices, creaseAngle, generated, jobs);
+		for (size_t i = 0; i < corners.size(); i++)
+		{
+			if (corners[i].normalIndex < 0) mesh.normals[i] = generated[i];
+		}
+	}
+	if (withTangents && !textures.empty())
+	{
+		generateTangents(mesh.positions, mesh.positionIndices, mesh.uvs, mesh.normals, mesh.tangents, jobs);
+	}
+	return true;
+}
+
+inline vector<float> interleaveObjMesh(const ObjMesh& mesh)
+{
+	vector<float> vertexArray;
+	vertexArray.reserve(mesh.positionIndices.size() * OBJ_VERTEX_STRIDE);
+	for (size_t i = 0; i < mesh.positionIndices.size(); i++)
+	{
+		const glm::vec3& vertex = mesh.positions[mesh.positionIndices[i]];
+		const glm::vec2& texture = mesh.uvs[i];
+		const glm::vec3& normal = mesh.normals[i];
+		vertexArray.push_back(vertex.x);
+		vertexArray.push_back(vertex.y);
+		vertexArray.push_back(vertex.z);
+		vertexArray.push_back(0.0f);// r
+		vertexArray.push_back(0.0f);// g
+		vertexArray.push_back(0.0f);// b
+		vertexArray.push_back(texture.x);
+		vertexArray.push_back(texture.y);
+		vertexArray.push_back(normal.x);
+		vertexArray.push_back(normal.y);
+		vertexArray.push_back(normal.z);
+	}
+	return vertexArray;
+}
+
+inline vector<float> parseObjFile(istream& file, JobSystem* jobs = nullptr)
+{
+	ObjMesh mesh;
+	// O array intercalado nao tem tangentes
+	if (!loadObj(file, mesh, jobs, DEFAULT_CREASE_ANGLE, false)) return {};
+	return interleaveObjMesh(mesh);
+}
+
+inline vector<float> parseObjFile(const string& filename, JobSystem* jobs = nullptr)
+{
+	ifstream file(filename);
+	if (!file.is_open()) {
+		cerr << "Failed to open OBJ file: " << filename << endl;
+		return {};
+	}
+	return parseObjFile(file, jobs);
+}
+
+inline Material parseMTL(istream& file)
+{
+	Material material;
+	string line;
+	while (getline(file, line)) {
+		istringstream iss(line);
+		string token;
+		iss >> token;
+		if (token == "newmtl") iss >> material.name;
+		if (token == "Ns") iss >> material.Ns;
+		if (token == "Ka") iss >> material.Ka[0] >> material.Ka[1] >> material.Ka[2];
+		if (token == "Ks") iss >> material.Ks[0] >> material.Ks[1] >> material.Ks[2];
+		if (token == "Ke") iss >> material.Ke[0] >> material.Ke[1] >> material.Ke[2];
+		if (token == "Ni") iss >> material.Ni;
+		if (token == "d") iss >> material.d;
+		if (token == "illum") iss >> material.illum;
+		if (token == "map_Kd") iss >> material.map_Kd;
+	}
+	return material;
+}
+
+inline Material parseMTL(const string& filename)
+{
+	ifstream file(filename);
+	if (!file.is_open()) {
+		cerr << "Failed to open MTL file: " << filename << endl;
+		return {};
+	}
+	return parseMTL(file);
+}
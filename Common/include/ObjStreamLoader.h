@@ -0,0 +1,452 @@
+// Leitura de OBJ fora do nucleo, para malhas maiores que a RAM (fotogrametria de varios GB).
+// O arquivo e lido em blocos de tamanho fixo e os triangulos saem em lotes ja intercalados
+// (OBJ_VERTEX_STRIDE floats por vertice, o mesmo layout do parseObjFile) enquanto o resto do
+// arquivo ainda esta sendo lido, entao a malha pode ser desenhada conforme vai ficando pronta.
+// As faces podem apontar para qualquer v/vt/vn anterior, por isso os atributos ficam em paginas:
+// as que nao cabem no orcamento vao para arquivos temporarios (<prefixo>.v.pages, .vt.pages,
+// .vn.pages, apagados no fim) e voltam sob demanda (LRU). Em malhas de fotogrametria as faces
+// ficam perto dos seus vertices no arquivo, entao quase toda consulta acerta uma pagina residente.
+// Orcamento = bloco de leitura + lotes em voo + paginas de atributos.
+// Diferenca do loadObj: cantos sem vn recebem a normal da face (a normal suave precisaria da
+// adjacencia da malha inteira).
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "ObjLoader.h"
+
+using namespace std;
+
+// Elementos por pagina de atributos (768 KB de vec3)
+const size_t OBJ_STREAM_PAGE_ELEMENTS = 65536;
+const size_t OBJ_STREAM_MIN_PAGES = 2;
+
+struct ObjStreamOptions {
+	// Teto de memoria do loader: bloco de leitura + lotes + paginas de atributos
+	size_t memoryBudget = (size_t)256 << 20;
+	size_t chunkBytes = (size_t)4 << 20;
+	size_t batchTriangles = 65536;
+	// Lotes prontos que podem esperar pela thread de render
+	int maxQueuedBatches = 4;
+	// Prefixo dos arquivos de paginas; vazio usa o caminho do OBJ
+	string spillPrefix;
+};
+
+struct ObjStreamStats {
+	uint64_t fileBytes = 0, bytesRead = 0;
+	uint64_t positions = 0, uvs = 0, normals = 0, triangles = 0, batches = 0;
+	// Paginas lidas de volta do disco e paginas escritas nele
+	uint64_t pageLoads = 0, pagesSpilled = 0;
+	// Maior soma de bloco + lotes (fila sempre cheia) + paginas residentes
+	size_t peakTrackedBytes = 0;
+};
+
+// Atributos de um tipo em paginas de OBJ_STREAM_PAGE_ELEMENTS. No maximo maxResident ficam na
+// memoria; uma pagina que sai e escrita no arquivo na primeira vez e depois so relida. A ultima
+// pagina (ainda crescendo) nunca sai, entao toda pagina no disco esta completa.
+template<typename T>
+class ObjAttributePages
+{
+public:
+	uint64_t pageLoads = 0, pagesSpilled = 0;
+
+	ObjAttributePages(const string& path, size_t maxResident)
+		: path(path), maxResident(max(maxResident, OBJ_STREAM_MIN_PAGES)) {}
+	ObjAttributePages(const ObjAttributePages&) = delete;
+	ObjAttributePages& operator=(const ObjAttributePages&) = delete;
+
+	~ObjAttributePages()
+	{
+		if (!file.is_open()) return;
+		file.close();
+		remove(path.c_str());
+	}
+
+	size_t size() const { return count; }
+	size_t residentBytes() const { return resident.size() * OBJ_STREAM_PAGE_ELEMENTS * sizeof(T); }
+
+	bool push(const T& value)
+	{
+		size_t page = count / OBJ_STREAM_PAGE_ELEMENTS;
+		if (page == pages.size())
+		{
+			pages.emplace_back();
+			if (!makeResident(page, false)) return false;
+		}
+		pages[page].data.push_back(value);
+		count++;
+		return true;
+	}
+
+	// false so em erro de E/S no arquivo de paginas
+	bool get(size_t index, T& value)
+	{
+		size_t page = index / OBJ_STREAM_PAGE_ELEMENTS;
+		if (!pages[page].resident && !makeResident(page, true)) return false;
+		pages[page].lastUse = ++clock;
+		value = pages[page].data[index % OBJ_STREAM_PAGE_ELEMENTS];
+		return true;
+	}
+
+private:
+	struct Page {
+		vector<T> data;
+		uint64_t lastUse = 0;
+		bool resident = false, onDisk = false;
+	};
+
+	string path;
+	size_t maxResident;
+	size_t count = 0;
+	uint64_t clock = 0;
+	vector<Page> pages;
+	vector<size_t> resident;
+	fstream file;
+
+	// Reaproveita o buffer da pagina menos usada quando o limite ja foi atingido
+	bool makeResident(size_t page, bool load)
+	{
+		vector<T> buffer;
+		if (resident.size() >= maxResident)
+		{
+			size_t victim = 0;
+			for (size_t i = 1; i < resident.size(); i++)
+			{
+				if (resident[victim] == pages.size() - 1 || (resident[i] != pages.size() - 1 && pages[resident[i]].lastUse < pages[resident[victim]].lastUse)) victim = i;
+			}
+			Page& evicted = pages[resident[victim]];
+			if (!evicted.onDisk)
+			{
+				if (!file.is_open()) file.open(path, ios::in | ios::out | ios::binary | ios::trunc);
+				file.seekp((streamoff)resident[victim] * OBJ_STREAM_PAGE_ELEMENTS * sizeof(T));
+				file.write((const char*)evicted.data.data(), OBJ_STREAM_PAGE_ELEMENTS * sizeof(T));
+				if (!file)
+				{
+					cerr << "Failed to write OBJ page file: " << path << endl;
+					return false;
+				}
+				evicted.onDisk = true;
+				pagesSpilled++;
+			}
+			buffer.swap(evicted.data);
+			buffer.clear();
+			evicted.resident = false;
+			resident[victim] = resident.back();
+			resident.pop_back();
+		}
+		if (load)
+		{
+			buffer.resize(OBJ_STREAM_PAGE_ELEMENTS);
+			file.seekg((streamoff)page * OBJ_STREAM_PAGE_ELEMENTS * sizeof(T));
+			file.read((char*)buffer.data(), OBJ_STREAM_PAGE_ELEMENTS * sizeof(T));
+			if (!file)
+			{
+				cerr << "Failed to read OBJ page file: " << path << endl;
+				return false;
+			}
+			pageLoads++;
+		}
+		else buffer.reserve(OBJ_STREAM_PAGE_ELEMENTS);
+		pages[page].data.swap(buffer);
+		pages[page].resident = true;
+		pages[page].lastUse = ++clock;
+		resident.push_back(page);
+		return true;
+	}
+};
+
+inline size_t objStreamBatchBytes(const ObjStreamOptions& options)
+{
+	return options.batchTriangles * 3 * OBJ_VERTEX_STRIDE * sizeof(float);
+}
+
+// Parte fixa do orcamento: o bloco, o lote sendo montado, os da fila e o que a render thread esta enviando
+inline size_t objStreamFixedBytes(const ObjStreamOptions& options)
+{
+	return options.chunkBytes + (options.maxQueuedBatches + 2) * objStreamBatchBytes(options);
+}
+
+// Uma pagina de cada atributo
+inline size_t objStreamPageSetBytes()
+{
+	return OBJ_STREAM_PAGE_ELEMENTS * (2 * sizeof(glm::vec3) + sizeof(glm::vec2));
+}
+
+// Maior lote (dividindo batchTriangles por 2, ate 1024) cujos lotes ocupam no maximo metade do
+// orcamento que sobra depois do bloco e das paginas minimas; o resto fica para paginas residentes
+inline size_t objStreamBatchTrianglesForBudget(const ObjStreamOptions& options)
+{
+	size_t reserved = options.chunkBytes + OBJ_STREAM_MIN_PAGES * objStreamPageSetBytes();
+	size_t available = options.memoryBudget > reserved ? options.memoryBudget - reserved : 0;
+	size_t triangleBytes = 3 * OBJ_VERTEX_STRIDE * sizeof(float);
+	size_t triangles = options.batchTriangles;
+	while (triangles > 1024 && (options.maxQueuedBatches + 2) * triangles * triangleBytes > available / 2) triangles /= 2;
+	return triangles;
+}
+
+inline const char* skipObjSpaces(const char* cursor)
+{
+	while (*cursor == ' ' || *cursor == '\t') cursor++;
+	return cursor;
+}
+
+// onBatch recebe cada lote pronto e pode ficar com o conteudo (swap); devolve false para parar.
+// false em erro, orcamento menor que o minimo ou parada pedida pelo onBatch
+inline bool streamObjFile(const string& path, const ObjStreamOptions& options, const function<bool(vector<float>&)>& onBatch, ObjStreamStats* stats = nullptr)
+{
+	ObjStreamStats localStats;
+	ObjStreamStats& s = stats ? *stats : localStats;
+	s = ObjStreamStats();
+	size_t minimumBytes = objStreamFixedBytes(options) + OBJ_STREAM_MIN_PAGES * objStreamPageSetBytes();
+	if (options.memoryBudget < minimumBytes || options.batchTriangles == 0 || options.chunkBytes == 0)
+	{
+		cerr << "OBJ stream budget of " << (options.memoryBudget >> 20) << " MB is below the minimum of " << (minimumBytes >> 20) + 1 << " MB" << endl;
+		return false;
+	}
+	ifstream file(path, ios::binary);
+	if (!file.is_open())
+	{
+		cerr << "Failed to open OBJ file: " << path << endl;
+		return false;
+	}
+	file.seekg(0, ios::end);
+	s.fileBytes = (uint64_t)file.tellg();
+	file.seekg(0);
+
+	size_t pagesPerAttribute = (options.memoryBudget - objStreamFixedBytes(options)) / objStreamPageSetBytes();
+	string prefix = options.spillPrefix.empty() ? path : options.spillPrefix;
+	ObjAttributePages<glm::vec3> positions(prefix + ".v.pages", pagesPerAttribute);
+	ObjAttributePages<glm::vec2> uvs(prefix + ".vt.pages", pagesPerAttribute);
+	ObjAttributePages<glm::vec3> normals(prefix + ".vn.pages", pagesPerAttribute);
+
+	size_t batchFloats = options.batchTriangles * 3 * OBJ_VERTEX_STRIDE;
+	vector<float> batch;
+	batch.reserve(batchFloats);
+	// +1 para o '\0' que fecha a ultima linha
+	vector<char> chunk(options.chunkBytes + 1);
+	vector<FaceVertex> faceVertices;
+
+	auto trackMemory = [&]() {
+		size_t tracked = chunk.size() + (options.maxQueuedBatches + 2) * objStreamBatchBytes(options)
+			+ positions.residentBytes() + uvs.residentBytes() + normals.residentBytes();
+		s.peakTrackedBytes = max(s.peakTrackedBytes, tracked);
+	};
+	auto flush = [&]() {
+		if (batch.empty()) return true;
+		s.batches++;
+		trackMemory();
+		bool proceed = onBatch(batch);
+		batch.clear();
+		batch.reserve(batchFloats);
+		return proceed;
+	};
+	auto emitCorner = [&](const FaceVertex& fv, const glm::vec3& position, const glm::vec3& faceNormal) {
+		glm::vec2 uv(0.0f);
+		glm::vec3 normal = faceNormal;
+		if (fv.uvIndex >= 0 && !uvs.get(fv.uvIndex, uv)) return false;
+		if (fv.normalIndex >= 0 && !normals.get(fv.normalIndex, normal)) return false;
+		float vertex[OBJ_VERTEX_STRIDE] = { position.x, position.y, position.z, 0.0f, 0.0f, 0.0f, uv.x, uv.y, normal.x, normal.y, normal.z };
+		batch.insert(batch.end(), vertex, vertex + OBJ_VERTEX_STRIDE);
+		return true;
+	};
+	// Linha ja terminada em '\0'
+	auto parseLine = [&](const char* line) {
+		const char* cursor = skipObjSpaces(line);
+		char* end;
+		if (cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t'))
+		{
+			glm::vec3 vertex;
+			vertex.x = strtof(cursor + 2, &end);
+			vertex.y = strtof(end, &end);
+			vertex.z = strtof(end, &end);
+			return positions.push(vertex);
+		}
+		if (cursor[0] == 'v' && cursor[1] == 'n' && (cursor[2] == ' ' || cursor[2] == '\t'))
+		{
+			glm::vec3 normal;
+			normal.x = strtof(cursor + 3, &end);
+			normal.y = strtof(end, &end);
+			normal.z = strtof(end, &end);
+			return normals.push(normal);
+		}
+		if (cursor[0] == 'v' && cursor[1] == 't' && (cursor[2] == ' ' || cursor[2] == '\t'))
+		{
+			glm::vec2 texture;
+			texture.x = strtof(cursor + 3, &end);
+			texture.y = strtof(end, &end);
+			return uvs.push(texture);
+		}
+		if (cursor[0] != 'f' || (cursor[1] != ' ' && cursor[1] != '\t')) return true;
+		faceVertices.clear();
+		cursor = skipObjSpaces(cursor + 1);
+		while (*cursor && *cursor != '\r')
+		{
+			const char* token = cursor;
+			FaceVertex fv;
+			if (!parseFaceVertex(cursor, (int)positions.size(), (int)uvs.size(), (int)normals.size(), fv))
+			{
+				cerr << "Invalid OBJ face vertex: " << string(token, strcspn(token, " \t\r")) << endl;
+				return false;
+			}
+			faceVertices.push_back(fv);
+			cursor = skipObjSpaces(cursor);
+		}
+		for (size_t k = 1; k + 1 < faceVertices.size(); k++)
+		{
+			const FaceVertex* corners[3] = { &faceVertices[0], &faceVertices[k], &faceVertices[k + 1] };
+			glm::vec3 p[3];
+			for (int c = 0; c < 3; c++)
+			{
+				if (!positions.get(corners[c]->vertexIndex, p[c])) return false;
+			}
+			glm::vec3 faceNormal(0.0f);
+			if (corners[0]->normalIndex < 0 || corners[1]->normalIndex < 0 || corners[2]->normalIndex < 0)
+			{
+				glm::vec3 cross = glm::cross(p[1] - p[0], p[2] - p[0]);
+				float length = glm::length(cross);
+				if (length > 0.0f) faceNormal = cross / length;
+			}
+			for (int c = 0; c < 3; c++)
+			{
+				if (!emitCorner(*corners[c], p[c], faceNormal)) return false;
+			}
+			s.triangles++;
+			if (batch.size() >= batchFloats && !flush()) return false;
+		}
+		return true;
+	};
+
+	// Bytes de uma linha incompleta que ficaram no inicio do bloco
+	size_t carry = 0;
+	while (true)
+	{
+		file.read(chunk.data() + carry, chunk.size() - 1 - carry);
+		size_t got = (size_t)file.gcount();
+		s.bytesRead += got;
+		bool atEnd = !file;
+		char* line = chunk.data();
+		char* end = line + carry + got;
+		while (line < end)
+		{
+			char* newline = (char*)memchr(line, '\n', end - line);
+			if (!newline)
+			{
+				if (!atEnd) break;
+				newline = end;
+			}
+			*newline = '\0';
+			if (!parseLine(line)) return false;
+			line = newline + 1;
+		}
+		trackMemory();
+		if (atEnd) break;
+		carry = (size_t)(end - line);
+		memmove(chunk.data(), line, carry);
+		// Linha maior que o bloco inteiro
+		if (carry == chunk.size() - 1) chunk.resize(chunk.size() * 2);
+	}
+	if (!flush()) return false;
+	s.positions = positions.size();
+	s.uvs = uvs.size();
+	s.normals = normals.size();
+	s.pageLoads = positions.pageLoads + uvs.pageLoads + normals.pageLoads;
+	s.pagesSpilled = positions.pagesSpilled + uvs.pagesSpilled + normals.pagesSpilled;
+	return true;
+}
+
+// Roda o streamObjFile numa thread propria (ela passa a maior parte do tempo no disco ou esperando
+// espaco na fila, o que prenderia um worker do JobSystem) e entrega os lotes a thread do contexto
+// por uma fila limitada: se o upload atrasar, a leitura espera em vez de acumular lotes.
+class ObjStreamLoader
+{
+public:
+	ObjStreamLoader() = default;
+	ObjStreamLoader(const ObjStreamLoader&) = delete;
+	ObjStreamLoader& operator=(const ObjStreamLoader&) = delete;
+	~ObjStreamLoader() { cancel(); }
+
+	void start(const string& path, const ObjStreamOptions& options = ObjStreamOptions())
+	{
+		cancel();
+		cancelled = false;
+		done = false;
+		succeeded = false;
+		maxQueued = max(1, options.maxQueuedBatches);
+		worker = thread([this, path, options]() {
+			bool ok = streamObjFile(path, options, [this](vector<float>& batch) {
+				unique_lock<mutex> lock(queueMutex);
+				spaceAvailable.wait(lock, [this]() { return cancelled || (int)queue.size() < maxQueued; });
+				if (cancelled) return false;
+				queue.emplace_back();
+				queue.back().swap(batch);
+				return true;
+			}, &loaderStats);
+			lock_guard<mutex> lock(queueMutex);
+			succeeded = ok;
+			done = true;
+		});
+	}
+
+	// Tira o proximo lote sem bloquear; o lote anterior em batch e descartado
+	bool poll(vector<float>& batch)
+	{
+		lock_guard<mutex> lock(queueMutex);
+		if (queue.empty()) return false;
+		batch.swap(queue.front());
+		queue.pop_front();
+		spaceAvailable.notify_one();
+		return true;
+	}
+
+	// Leitura encerrada e nenhum lote esperando
+	bool finished()
+	{
+		lock_guard<mutex> lock(queueMutex);
+		return done && queue.empty();
+	}
+
+	bool failed()
+	{
+		lock_guard<mutex> lock(queueMutex);
+		return done && !succeeded && !cancelled;
+	}
+
+	// Valido depois de finished()
+	const ObjStreamStats& stats() const { return loaderStats; }
+
+	void cancel()
+	{
+		{
+			lock_guard<mutex> lock(queueMutex);
+			cancelled = true;
+			queue.clear();
+		}
+		spaceAvailable.notify_all();
+		if (worker.joinable()) worker.join();
+	}
+
+private:
+	thread worker;
+	mutex queueMutex;
+	condition_variable spaceAvailable;
+	deque<vector<float>> queue;
+	int maxQueued = 1;
+	bool cancelled = false, done = false, succeeded = false;
+	ObjStreamStats loaderStats;
+};
@@ -0,0 +1,298 @@
+// Occlusion culling em CPU: os oclusores (malhas grandes escolhidas pela aplicacao) sao
+// rasterizados so em profundidade em um buffer pequeno (256x128 por padrao), e as AABBs dos
+// objetos sao testadas contra ele antes de irem para a GPU.
+// - Setup: cada oclusor e transformado e vira triangulos em pixels, um job por oclusor;
+// - Rasterizacao: a tela e dividida em faixas de OCCLUSION_TILE linhas e cada job rasteriza
+//   todos os triangulos que tocam a sua faixa (sem locks: cada faixa so escreve nas suas linhas),
+//   8 pixels por vez com AVX2 (escalar se a CPU nao tiver); no fim a faixa calcula a sua linha
+//   da hierarquia: a profundidade mais distante de cada tile 8x8;
+// - Teste: a AABB projetada vira um retangulo com a profundidade mais proxima; se em todos os
+//   tiles do retangulo o oclusor mais distante esta na frente, o objeto esta oculto. Tiles que
+//   nao decidem sozinhos sao conferidos pixel a pixel.
+// Triangulos que cruzam o plano near sao descartados e objetos que o cruzam sempre passam; os
+// dois casos so diminuem o culling, nunca escondem algo visivel.
+// Baseado na ideia de Hasselgren, Andersson e Akenine-Moller, "Masked Software Occlusion
+// Culling" (2016), mas com um buffer de profundidade completo (o buffer e pequeno) em vez das
+// mascaras de cobertura por tile.
+
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <algorithm>
+
+#include <immintrin.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+#include "TransformBatch.h"
+
+using namespace std;
+
+#if defined(_MSC_VER)
+#define OCCLUSION_AVX2_TARGET
+#else
+#define OCCLUSION_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+const int OCCLUSION_WIDTH = 256;
+const int OCCLUSION_HEIGHT = 128;
+const int OCCLUSION_TILE = 8;
+const float OCCLUSION_NEAR_W = 1e-4f;
+
+struct OcclusionTriangle {
+	// Vertices em pixels; z em [0, 1] (profundidade da janela)
+	float x[3], y[3], z[3];
+	int minX, maxX, minY, maxY;
+};
+
+struct Occluder {
+	const float* vertices;
+	int stride;
+	const uint32_t* indices;
+	size_t indexCount;
+	glm::mat4 modelViewProjection;
+};
+
+class OcclusionCuller
+{
+public:
+	int width, height;
+	bool useAVX2;
+	// Estatisticas do ultimo rasterize()
+	size_t rasterizedTriangles = 0;
+
+	OcclusionCuller(int width = OCCLUSION_WIDTH, int height = OCCLUSION_HEIGHT)
+		: width(width), height(height), useAVX2(cpuHasAVX2())
+	{
+		tilesX = (width + OCCLUSION_TILE - 1) / OCCLUSION_TILE;
+		tilesY = (height + OCCLUSION_TILE - 1) / OCCLUSION_TILE;
+		depth.assign((size_t)width * height, 1.0f);
+		tileMax.assign((size_t)tilesX * tilesY, 1.0f);
+	}
+
+	// Os ponteiros precisam continuar validos ate o rasterize()
+	void addOccluder(const float* vertices, int stride, const uint32_t* indices, size_t indexCount, const glm::mat4& modelViewProjection)
+	{
+		occluders.push_back({ vertices, stride, indices, indexCount, modelViewProjection });
+	}
+
+	// Limpa o buffer, rasteriza os oclusores adicionados e monta a hierarquia
+	void rasterize(JobSystem* jobs = nullptr)
+	{
+		occluderTriangles.resize(occluders.size());
+		forEach(jobs, occluders.size(), 1, [&](size_t first, size_t last) {
+			for (size_t o = first; o < last; o++) setupOccluder(occluders[o], occluderTriangles[o]);
+		});
+		rasterizedTriangles = 0;
+		for (const vector<OcclusionTriangle>& triangles : occluderTriangles) rasterizedTriangles += triangles.size();
+		forEach(jobs, tilesY, 1, [&](size_t first, size_t last) {
+			for (size_t band = first; band < last; band++) rasterizeBand((int)band);
+		});
+		occluders.clear();
+	}
+
+	// true se a AABB (espaco do objeto, levada por modelViewProjection) esta toda atras dos oclusores
+	bool isOccluded(const glm::vec3& aabbMin, const glm::vec3& aabbMax, const glm::mat4& modelViewProjection) const
+	{
+		float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, nearest = FLT_MAX;
+		for (int corner = 0; corner < 8; corner++)
+		{
+			glm::vec4 p = modelViewProjection * glm::vec4(corner & 1 ? aabbMax.x : aabbMin.x,
+				corner & 2 ? aabbMax.y : aabbMin.y, corner & 4 ? aabbMax.z : aabbMin.z, 1.0f);
+			if (p.w <= OCCLUSION_NEAR_W || p.z < -p.w) return false;
+			float x = (p.x / p.w * 0.5f + 0.5f) * width;
+			float y = (p.y / p.w * 0.5f + 0.5f) * height;
+			minX = min(minX, x); maxX = max(maxX, x);
+			minY = min(minY, y); maxY = max(maxY, y);
+			nearest = min(nearest, p.z / p.w * 0.5f + 0.5f);
+		}
+		// Pixels cujo centro pode cair dentro do retangulo
+		int x0 = max(0, (int)floor(minX - 0.5f)), x1 = min(width - 1, (int)ceil(maxX - 0.5f));
+		int y0 = max(0, (int)floor(minY - 0.5f)), y1 = min(height - 1, (int)ceil(maxY - 0.5f));
+		if (x0 > x1 || y0 > y1) return false;
+		for (int ty = y0 / OCCLUSION_TILE; ty <= y1 / OCCLUSION_TILE; ty++)
+		{
+			for (int tx = x0 / OCCLUSION_TILE; tx <= x1 / OCCLUSION_TILE; tx++)
+			{
+				if (tileMax[(size_t)ty * tilesX + tx] < nearest) continue;
+				int px0 = max(x0, tx * OCCLUSION_TILE), px1 = min(x1, tx * OCCLUSION_TILE + OCCLUSION_TILE - 1);
+				int py0 = max(y0, ty * OCCLUSION_TILE), py1 = min(y1, ty * OCCLUSION_TILE + OCCLUSION_TILE - 1);
+				for (int py = py0; py <= py1; py++)
+				{
+					const float* row = &depth[(size_t)py * width];
+					for (int px = px0; px <= px1; px++)
+					{
+						if (row[px] >= nearest) return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	const vector<float>& depthBuffer() const { return depth; }
+
+private:
+	int tilesX, tilesY;
+	vector<float> depth;
+	vector<float> tileMax;
+	vector<Occluder> occluders;
+	vector<vector<OcclusionTriangle>> occluderTriangles;
+
+	template<typename Function>
+	static void forEach(JobSystem* jobs, size_t count, size_t grain, const Function& fn)
+	{
+		if (jobs) jobs->parallelFor(0, count, grain, fn);
+		else fn(0, count);
+	}
+
+	void setupOccluder(const Occluder& occluder, vector<OcclusionTriangle>& triangles) const
+	{
+		triangles.clear();
+		for (size_t i = 0; i + 2 < occluder.indexCount; i += 3)
+		{
+			OcclusionTriangle triangle;
+			bool clipped = false;
+			for (int k = 0; k < 3; k++)
+			{
+				const float* v = occluder.vertices + (size_t)occluder.indices[i + k] * occluder.stride;
+				glm::vec4 p = occluder.modelViewProjection * glm::vec4(v[0], v[1], v[2], 1.0f);
+				if (p.w <= OCCLUSION_NEAR_W || p.z < -p.w)
+				{
+					clipped = true;
+					break;
+				}
+				triangle.x[k] = (p.x / p.w * 0.5f + 0.5f) * width;
+				triangle.y[k] = (p.y / p.w * 0.5f + 0.5f) * height;
+				triangle.z[k] = p.z / p.w * 0.5f + 0.5f;
+			}
+			if (clipped) continue;
+			float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) - (triangle.x[2] - triangle.x[0]) * (triangle.y[1] - triangle.y[0]);
+			if (area == 0.0f) continue;
+			// Dos dois lados (oclusores abertos, como a Suzanne, tambem contam); gira para area positiva
+			if (area < 0.0f)
+			{
+				swap(triangle.x[1], triangle.x[2]);
+				swap(triangle.y[1], triangle.y[2]);
+				swap(triangle.z[1], triangle.z[2]);
+			}
+			triangle.minX = max(0, (int)floor(min(triangle.x[0], min(triangle.x[1], triangle.x[2]))));
+			triangle.maxX = min(width - 1, (int)ceil(max(triangle.x[0], max(triangle.x[1], triangle.x[2]))));
+			triangle.minY = max(0, (int)floor(min(triangle.y[0], min(triangle.y[1], triangle.y[2]))));
+			triangle.maxY = min(height - 1, (int)ceil(max(triangle.y[0], max(triangle.y[1], triangle.y[2]))));
+			if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) continue;
+			triangles.push_back(triangle);
+		}
+	}
+
+	// Funcoes de aresta e plano de profundidade avaliados no centro de cada pixel
+	struct TriangleSetup {
+		float edgeA[3], edgeB[3], edgeC[3];
+		float zA, zB, zC;
+	};
+
+	static TriangleSetup setupTriangle(const OcclusionTriangle& t)
+	{
+		TriangleSetup s;
+		for (int e = 0; e < 3; e++)
+		{
+			int a = (e + 1) % 3, b = (e + 2) % 3;
+			// E(x, y) >= 0 dentro do triangulo (area positiva)
+			s.edgeA[e] = t.y[a] - t.y[b];
+			s.edgeB[e] = t.x[b] - t.x[a];
+			s.edgeC[e] = t.x[a] * t.y[b] - t.x[b] * t.y[a];
+		}
+		float area = s.edgeC[0] + s.edgeC[1] + s.edgeC[2];
+		s.zA = (s.edgeA[0] * t.z[0] + s.edgeA[1] * t.z[1] + s.edgeA[2] * t.z[2]) / area;
+		s.zB = (s.edgeB[0] * t.z[0] + s.edgeB[1] * t.z[1] + s.edgeB[2] * t.z[2]) / area;
+		s.zC = (s.edgeC[0] * t.z[0] + s.edgeC[1] * t.z[1] + s.edgeC[2] * t.z[2]) / area;
+		return s;
+	}
+
+	void rasterizeRowsScalar(const TriangleSetup& s, int x0, int x1, int y0, int y1)
+	{
+		for (int y = y0; y <= y1; y++)
+		{
+			float py = y + 0.5f;
+			float* row = &depth[(size_t)y * width];
+			// Mesma ordem de operacoes do caminho AVX2, para os dois darem o mesmo resultado
+			float rowE0 = s.edgeB[0] * py + s.edgeC[0], rowE1 = s.edgeB[1] * py + s.edgeC[1], rowE2 = s.edgeB[2] * py + s.edgeC[2];
+			float rowZ = s.zB * py + s.zC;
+			for (int x = x0; x <= x1; x++)
+			{
+				float px = x + 0.5f;
+				float e0 = s.edgeA[0] * px + rowE0;
+				float e1 = s.edgeA[1] * px + rowE1;
+				float e2 = s.edgeA[2] * px + rowE2;
+				if (e0 < 0.0f || e1 < 0.0f || e2 < 0.0f) continue;
+				float z = s.zA * px + rowZ;
+				row[x] = min(row[x], z);
+			}
+		}
+	}
+
+	OCCLUSION_AVX2_TARGET void rasterizeRowsAVX2(const TriangleSetup& s, int x0, int x1, int y0, int y1)
+	{
+		const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+		const __m256 zero = _mm256_setzero_ps();
+		__m256 a0 = _mm256_set1_ps(s.edgeA[0]), a1 = _mm256_set1_ps(s.edgeA[1]), a2 = _mm256_set1_ps(s.edgeA[2]);
+		__m256 za = _mm256_set1_ps(s.zA);
+		// Comeca em multiplo de 8 para as cargas/escritas ficarem dentro da linha (width % 8 == 0)
+		int start = x0 & ~7;
+		for (int y = y0; y <= y1; y++)
+		{
+			float py = y + 0.5f;
+			float* row = &depth[(size_t)y * width];
+			float rowE0 = s.edgeB[0] * py + s.edgeC[0], rowE1 = s.edgeB[1] * py + s.edgeC[1], rowE2 = s.edgeB[2] * py + s.edgeC[2];
+			float rowZ = s.zB * py + s.zC;
+			for (int x = start; x <= x1; x += 8)
+			{
+				__m256 px = _mm256_add_ps(_mm256_set1_ps((float)x), laneOffsets);
+				__m256 e0 = _mm256_add_ps(_mm256_mul_ps(a0, px), _mm256_set1_ps(rowE0));
+				__m256 e1 = _mm256_add_ps(_mm256_mul_ps(a1, px), _mm256_set1_ps(rowE1));
+				__m256 e2 = _mm256_add_ps(_mm256_mul_ps(a2, px), _mm256_set1_ps(rowE2));
+				__m256 inside = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(e0, zero, _CMP_GE_OQ), _mm256_cmp_ps(e1, zero, _CMP_GE_OQ)),
+					_mm256_cmp_ps(e2, zero, _CMP_GE_OQ));
+				if (_mm256_movemask_ps(inside) == 0) continue;
+				__m256 z = _mm256_add_ps(_mm256_mul_ps(za, px), _mm256_set1_ps(rowZ));
+				__m256 current = _mm256_loadu_ps(row + x);
+				_mm256_storeu_ps(row + x, _mm256_blendv_ps(current, _mm256_min_ps(current, z), inside));
+			}
+		}
+	}
+
+	void rasterizeBand(int band)
+	{
+		int y0 = band * OCCLUSION_TILE, y1 = min(height - 1, y0 + OCCLUSION_TILE - 1);
+		fill(depth.begin() + (size_t)y0 * width, depth.begin() + (size_t)(y1 + 1) * width, 1.0f);
+		bool avx2 = useAVX2 && width % 8 == 0;
+		for (const vector<OcclusionTriangle>& triangles : occluderTriangles)
+		{
+			for (const OcclusionTriangle& triangle : triangles)
+			{
+				if (triangle.maxY < y0 || triangle.minY > y1) continue;
+				TriangleSetup s = setupTriangle(triangle);
+				int rowStart = max(y0, triangle.minY), rowEnd = min(y1, triangle.maxY);
+				if (avx2) rasterizeRowsAVX2(s, triangle.minX, triangle.maxX, rowStart, rowEnd);
+				else rasterizeRowsScalar(s, triangle.minX, triangle.maxX, rowStart, rowEnd);
+			}
+		}
+		for (int tx = 0; tx < tilesX; tx++)
+		{
+			float farthest = 0.0f;
+			for (int y = y0; y <= y1; y++)
+			{
+				for (int x = tx * OCCLUSION_TILE; x < min(width, (tx + 1) * OCCLUSION_TILE); x++)
+				{
+					farthest = max(farthest, depth[(size_t)y * width + x]);
+				}
+			}
+			tileMax[(size_t)band * tilesX + tx] = farthest;
+		}
+	}
+};
@@ -0,0 +1,495 @@
+// Decodificador de PNG para o caminho quente das texturas, no lugar do stb_image (que continua
+// como fallback em decodeImage). Cobre o que os assets usam: 8 bits por canal, sem entrelacamento,
+// cinza, cinza + alfa, RGB e RGBA. O resto (paleta, 16 bits, Adam7, tRNS...) devolve false em
+// readPngInfo e vai para o stb_image.
+// - inflate: tabela direta de INFLATE_FAST_BITS bits para os codigos curtos, buffer de 64 bits
+//   recarregado com uma leitura de 8 bytes e copia dos matches de 8 em 8 bytes;
+// - filtros: desfeitos no proprio buffer do inflate, com SSE2. Up e 16 bytes por vez; Sub de 4
+//   canais e uma soma de prefixos em 16 bytes; Sub de 3 canais, Average e Paeth dependem do pixel
+//   anterior e andam um pixel por vez, com os canais em paralelo (Paeth em lanes de 16 bits);
+// - cada linha pronta e copiada para destination, que e so escrito e nunca lido: pode ser um PBO
+//   mapeado ou qualquer buffer do chamador, com o stride dele.
+// Os CRCs dos chunks e o adler32 nao sao conferidos, como no stb_image.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#include <emmintrin.h>
+
+#include "ImageEncoders.h"
+#include "stb_image.h"
+
+using namespace std;
+
+const int INFLATE_FAST_BITS = 10;
+// Folga no fim do buffer do inflate para as copias de 8 bytes passarem do fim
+const size_t INFLATE_COPY_SLACK = 8;
+
+struct PngInfo {
+	int width = 0, height = 0, channels = 0;
+	// Dados comprimidos (IDAT) em ordem; aponta para dentro do arquivo
+	vector<pair<const uint8_t*, size_t>> idat;
+};
+
+class InflateBits
+{
+public:
+	InflateBits(const uint8_t* input, size_t inputSize, size_t start) : data(input), size(inputSize), position(start) {}
+
+	// Garante pelo menos 56 bits no buffer; depois do fim entram zeros
+	void refill()
+	{
+		if (position + 8 <= size)
+		{
+			uint64_t word;
+			memcpy(&word, data + position, 8);
+			buffer |= word << count;
+			position += (63 - count) >> 3;
+			count |= 56;
+			return;
+		}
+		while (count <= 56)
+		{
+			if (position < size) buffer |= (uint64_t)data[position] << count;
+			position++;
+			count += 8;
+		}
+	}
+
+	uint32_t peek(int bits) const { return (uint32_t)(buffer & ((1ull << bits) - 1)); }
+	void consume(int bits) { buffer >>= bits; count -= bits; }
+	uint32_t read(int bits)
+	{
+		uint32_t value = peek(bits);
+		consume(bits);
+		return value;
+	}
+
+	// Posicao do proximo byte inteiro (blocos sem compressao); descarta os bits que sobraram
+	size_t alignToByte()
+	{
+		consume(count & 7);
+		size_t next = position - count / 8;
+		buffer = 0;
+		count = 0;
+		position = next;
+		return next;
+	}
+	void skipTo(size_t next) { position = next; }
+
+	// Leu alem do fim do stream?
+	bool overrun() const { return position - count / 8 > size; }
+
+private:
+	const uint8_t* data;
+	size_t size, position;
+	uint64_t buffer = 0;
+	int count = 0;
+};
+
+class InflateHuffman
+{
+public:
+	// Codigos canonicos a partir dos tamanhos (0 = simbolo ausente)
+	bool build(const uint8_t* lengths, int count)
+	{
+		int sizes[16] = {};
+		for (int i = 0; i < count; i++) sizes[lengths[i]]++;
+		sizes[0] = 0;
+		int nextCode[16] = {};
+		int code = 0, symbol = 0;
+		for (int length = 1; length < 16; length++)
+		{
+			nextCode[length] = code;
+			firstCode[length] = (uint16_t)code;
+			firstSymbol[length] = (uint16_t)symbol;
+			code += sizes[length];
+			if (sizes[length] && code - 1 >= (1 << length)) return false;
+			maxCode[length] = code << (16 - length);
+			code <<= 1;
+			symbol += sizes[length];
+		}
+		maxCode[16] = 0x10000;
+		memset(fast, 0, sizeof(fast));
+		for (int i = 0; i < count; i++)
+		{
+			int length = lengths[i];
+			if (!length) continue;
+			symbols[nextCode[length] - firstCode[length] + firstSymbol[length]] = (uint16_t)i;
+			if (length <= INFLATE_FAST_BITS)
+			{
+				for (uint32_t j = reverseBits(nextCode[length], length); j < (1u << INFLATE_FAST_BITS); j += 1u << length)
+				{
+					fast[j] = (uint16_t)((length << 9) | i);
+				}
+			}
+			nextCode[length]++;
+		}
+		return true;
+	}
+
+	// Precisa de 15 bits no buffer; -1 para codigo invalido
+	int decode(InflateBits& bits) const
+	{
+		uint16_t entry = fast[bits.peek(INFLATE_FAST_BITS)];
+		if (entry)
+		{
+			bits.consume(entry >> 9);
+			return entry & 511;
+		}
+		int reversed = (int)reverseBits(bits.peek(16), 16);
+		int length = INFLATE_FAST_BITS + 1;
+		while (length < 16 && reversed >= maxCode[length]) length++;
+		if (length == 16) return -1;
+		bits.consume(length);
+		return symbols[(reversed >> (16 - length)) - firstCode[length] + firstSymbol[length]];
+	}
+
+private:
+	// (tamanho << 9) | simbolo; 0 indica codigo mais longo que a tabela
+	uint16_t fast[1 << INFLATE_FAST_BITS];
+	uint16_t firstCode[16] = {}, firstSymbol[16] = {};
+	int maxCode[17] = {};
+	uint16_t symbols[288] = {};
+};
+
+inline bool inflateFixedTables(const InflateHuffman*& literals, const InflateHuffman*& distances)
+{
+	static const InflateHuffman* tables = []() {
+		static InflateHuffman fixed[2];
+		uint8_t lengths[288];
+		for (int i = 0; i < 288; i++) lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+		fixed[0].build(lengths, 288);
+		memset(lengths, 5, 30);
+		fixed[1].build(lengths, 30);
+		return fixed;
+	}();
+	literals = &tables[0];
+	distances = &tables[1];
+	return true;
+}
+
+inline bool inflateDynamicTables(InflateBits& bits, InflateHuffman& literals, InflateHuffman& distances)
+{
+	static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	bits.refill();
+	int literalCount = bits.read(5) + 257;
+	int distanceCount = bits.read(5) + 1;
+	int codeLengthCount = bits.read(4) + 4;
+	uint8_t codeLengths[19] = {};
+	for (int i = 0; i < codeLengthCount; i++)
+	{
+		bits.refill();
+		codeLengths[order[i]] = (uint8_t)bits.read(3);
+	}
+	InflateHuffman codeLengthTable;
+	if (!codeLengthTable.build(codeLengths, 19)) return false;
+	uint8_t lengths[286 + 32];
+	int total = literalCount + distanceCount;
+	for (int i = 0; i < total;)
+	{
+		bits.refill();
+		int symbol = codeLengthTable.decode(bits);
+		if (symbol < 0) return false;
+		if (symbol < 16)
+		{
+			lengths[i++] = (uint8_t)symbol;
+			continue;
+		}
+		int repeat;
+		uint8_t value = 0;
+		if (symbol == 16)
+		{
+			if (i == 0) return false;
+			repeat = 3 + bits.read(2);
+			value = lengths[i - 1];
+		}
+		else if (symbol == 17) repeat = 3 + bits.read(3);
+		else repeat = 11 + bits.read(7);
+		if (i + repeat > total) return false;
+		memset(lengths + i, value, repeat);
+		i += repeat;
+	}
+	return literals.build(lengths, literalCount) && distances.build(lengths + literalCount, distanceCount);
+}
+
+// Descomprime um stream zlib em out, que precisa ter outSize + INFLATE_COPY_SLACK bytes.
+// So aceita o stream se ele tiver exatamente outSize bytes
+inline bool inflateZlib(const uint8_t* data, size_t size, uint8_t* out, size_t outSize)
+{
+	static const uint16_t lengthBase[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	static const uint8_t lengthExtra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	static const uint16_t distanceBase[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+		4097, 6145, 8193, 12289, 16385, 24577 };
+	static const uint8_t distanceExtra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	// Cabecalho: deflate, checagem do FCHECK e sem dicionario
+	if (size < 2 || (data[0] & 15) != 8 || ((data[0] << 8) | data[1]) % 31 != 0 || (data[1] & 32)) return false;
+	InflateBits bits(data, size, 2);
+	InflateHuffman dynamicLiterals, dynamicDistances;
+	size_t written = 0;
+	bool last = false;
+	while (!last)
+	{
+		bits.refill();
+		last = bits.read(1) != 0;
+		int type = bits.read(2);
+		if (type == 0)
+		{
+			size_t position = bits.alignToByte();
+			if (position + 4 > size) return false;
+			size_t length = data[position] | (data[position + 1] << 8);
+			if ((length ^ (data[position + 2] | (data[position + 3] << 8))) != 0xFFFF) return false;
+			position += 4;
+			if (position + length > size || written + length > outSize) return false;
+			memcpy(out + written, data + position, length);
+			written += length;
+			bits.skipTo(position + length);
+			continue;
+		}
+		const InflateHuffman* literals;
+		const InflateHuffman* distances;
+		if (type == 1) inflateFixedTables(literals, distances);
+		else if (type == 2)
+		{
+			if (!inflateDynamicTables(bits, dynamicLiterals, dynamicDistances)) return false;
+			literals = &dynamicLiterals;
+			distances = &dynamicDistances;
+		}
+		else return false;
+		// Um refill por simbolo basta: literal/comprimento + extra + distancia + extra <= 48 bits
+		while (true)
+		{
+			bits.refill();
+			int symbol = literals->decode(bits);
+			if (symbol < 256)
+			{
+				if (symbol < 0 || written >= outSize) return false;
+				out[written++] = (uint8_t)symbol;
+				continue;
+			}
+			if (symbol == 256) break;
+			symbol -= 257;
+			if (symbol >= 29) return false;
+			size_t length = lengthBase[symbol] + bits.read(lengthExtra[symbol]);
+			int distanceSymbol = distances->decode(bits);
+			if (distanceSymbol < 0 || distanceSymbol >= 30) return false;
+			size_t distance = distanceBase[distanceSymbol] + bits.read(distanceExtra[distanceSymbol]);
+			if (distance > written || written + length > outSize) return false;
+			uint8_t* destination = out + written;
+			const uint8_t* source = destination - distance;
+			if (distance >= 8)
+			{
+				// Cada bloco de 8 bytes le so o que ja foi escrito; pode passar do fim ate 7 bytes
+				for (size_t i = 0; i < length; i += 8) memcpy(destination + i, source + i, 8);
+			}
+			else if (distance == 1)
+			{
+				memset(destination, *source, length);
+			}
+			else
+			{
+				for (size_t i = 0; i < length; i++) destination[i] = source[i];
+			}
+			written += length;
+		}
+	}
+	return !bits.overrun() && written == outSize;
+}
+
+inline uint32_t readBigEndian(const uint8_t* data)
+{
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+// Le o cabecalho e localiza os IDAT; false se o arquivo nao for um PNG que o caminho rapido cobre
+inline bool readPngInfo(const uint8_t* data, size_t size, PngInfo& info)
+{
+	static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	if (size < 8 || memcmp(data, signature, 8) != 0) return false;
+	info = PngInfo();
+	bool header = false;
+	for (size_t position = 8; position + 12 <= size;)
+	{
+		uint32_t length = readBigEndian(data + position);
+		const uint8_t* type = data + position + 4;
+		const uint8_t* chunk = data + position + 8;
+		if (length > size - position - 12) return false;
+		if (!memcmp(type, "IHDR", 4))
+		{
+			if (length != 13) return false;
+			info.width = (int)readBigEndian(chunk);
+			info.height = (int)readBigEndian(chunk + 4);
+			int bitDepth = chunk[8], colorType = chunk[9];
+			static const int channelsByType[] = { 1, 0, 3, 0, 2, 0, 4 };
+			if (bitDepth != 8 || colorType > 6 || !channelsByType[colorType] || chunk[10] || chunk[11] || chunk[12]) return false;
+			if (info.width <= 0 || info.height <= 0 || info.width > (1 << 24) || info.height > (1 << 24)) return false;
+			info.channels = channelsByType[colorType];
+			header = true;
+		}
+		else if (!memcmp(type, "IDAT", 4))
+		{
+			info.idat.emplace_back(chunk, length);
+		}
+		else if (!memcmp(type, "IEND", 4))
+		{
+			return header && !info.idat.empty();
+		}
+		// tRNS mudaria o numero de canais; chunks criticos desconhecidos (letra maiuscula) tambem ficam com o stb
+		else if (!memcmp(type, "tRNS", 4) || !(type[0] & 32))
+		{
+			return false;
+		}
+		position += 12 + length;
+	}
+	return false;
+}
+
+// Desfaz o Paeth e o Average de uma linha com bpp 3 ou 4, um pixel por vez
+template<int bpp>
+inline void unfilterPixelsSse2(int filter, uint8_t* row, const uint8_t* up, size_t size)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi8(1);
+	auto load = [](const uint8_t* pixel) {
+		uint32_t value = 0;
+		memcpy(&value, pixel, bpp);
+		return _mm_cvtsi32_si128((int)value);
+	};
+	__m128i a = zero, c = zero;
+	for (size_t i = 0; i + bpp <= size; i += bpp)
+	{
+		__m128i x = load(row + i);
+		__m128i b = load(up + i);
+		if (filter == 3)
+		{
+			// floor((a + b) / 2) com a media arredondada para cima do pavgb
+			__m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+			a = _mm_add_epi8(x, average);
+		}
+		else
+		{
+			__m128i predicted = paethPredictor8(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+			a = _mm_add_epi8(x, _mm_packus_epi16(predicted, predicted));
+			c = b;
+		}
+		uint32_t value = (uint32_t)_mm_cvtsi128_si32(a);
+		memcpy(row + i, &value, bpp);
+	}
+}
+
+// Linha sem o byte de filtro; up e a linha anterior ja decodificada (zeros na primeira)
+inline bool unfilterPngRow(int filter, uint8_t* row, const uint8_t* up, size_t size, int bpp)
+{
+	size_t i = 0;
+	switch (filter)
+	{
+	case 0:
+		return true;
+	case 2:
+		for (; i + 16 <= size; i += 16)
+		{
+			__m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+			_mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(x, _mm_loadu_si128((const __m128i*)(up + i))));
+		}
+		for (; i < size; i++) row[i] = (uint8_t)(row[i] + up[i]);
+		return true;
+	case 1:
+		if (bpp == 4)
+		{
+			// Soma de prefixos dos 4 pixels do bloco mais o ultimo pixel do bloco anterior
+			__m128i previous = _mm_setzero_si128();
+			for (; i + 16 <= size; i += 16)
+			{
+				__m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+				x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+				x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+				x = _mm_add_epi8(x, previous);
+				_mm_storeu_si128((__m128i*)(row + i), x);
+				previous = _mm_shuffle_epi32(x, 0xFF);
+			}
+			for (; i < size; i++) row[i] = (uint8_t)(row[i] + (i >= 4 ? row[i - 4] : 0));
+			return true;
+		}
+		for (i = bpp; i < size; i++) row[i] = (uint8_t)(row[i] + row[i - bpp]);
+		return true;
+	case 3:
+	case 4:
+		if (bpp == 4)
+		{
+			unfilterPixelsSse2<4>(filter, row, up, size);
+			return true;
+		}
+		if (bpp == 3)
+		{
+			unfilterPixelsSse2<3>(filter, row, up, size);
+			return true;
+		}
+		for (; i < size; i++)
+		{
+			int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+			int c = i >= (size_t)bpp ? up[i - bpp] : 0;
+			row[i] = (uint8_t)(row[i] + (filter == 3 ? (a + up[i]) >> 1 : paethPredictor(a, up[i], c)));
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+// Decodifica nos canais do proprio arquivo (info.channels) direto em destination, linha 0 no topo
+inline bool decodePng(const PngInfo& info, uint8_t* destination, size_t stride)
+{
+	size_t rowSize = (size_t)info.width * info.channels;
+	size_t rawSize = (rowSize + 1) * info.height;
+	// IDAT em mais de um chunk: junta antes de descomprimir
+	const uint8_t* compressed = info.idat[0].first;
+	size_t compressedSize = info.idat[0].second;
+	vector<uint8_t> joined;
+	if (info.idat.size() > 1)
+	{
+		for (const pair<const uint8_t*, size_t>& chunk : info.idat) joined.insert(joined.end(), chunk.first, chunk.first + chunk.second);
+		compressed = joined.data();
+		compressedSize = joined.size();
+	}
+	vector<uint8_t> raw(rawSize + INFLATE_COPY_SLACK);
+	if (!inflateZlib(compressed, compressedSize, raw.data(), rawSize)) return false;
+	vector<uint8_t> zeros(rowSize, 0);
+	const uint8_t* up = zeros.data();
+	for (int y = 0; y < info.height; y++)
+	{
+		uint8_t* row = &raw[y * (rowSize + 1)];
+		if (!unfilterPngRow(row[0], row + 1, up, rowSize, info.channels)) return false;
+		memcpy(destination + y * stride, row + 1, rowSize);
+		up = row + 1;
+	}
+	return true;
+}
+
+// Caminho rapido quando o PNG e suportado e desiredChannels e 0 (os do arquivo) ou igual aos do
+// arquivo; senao stb_image. channels recebe os canais de pixels
+inline bool decodeImage(const uint8_t* data, size_t size, int desiredChannels, vector<uint8_t>& pixels, int& width, int& height, int& channels)
+{
+	PngInfo info;
+	if (readPngInfo(data, size, info) && (desiredChannels == 0 || desiredChannels == info.channels))
+	{
+		pixels.resize((size_t)info.width * info.height * info.channels);
+		if (decodePng(info, pixels.data(), (size_t)info.width * info.channels))
+		{
+			width = info.width;
+			height = info.height;
+			channels = info.channels;
+			return true;
+		}
+	}
+	int fileChannels;
+	unsigned char* decoded = stbi_load_from_memory(data, (int)size, &width, &height, &fileChannels, desiredChannels);
+	if (!decoded) return false;
+	channels = desiredChannels ? desiredChannels : fileChannels;
+	pixels.assign(decoded, decoded + (size_t)width * height * channels);
+	stbi_image_free(decoded);
+	return true;
+}
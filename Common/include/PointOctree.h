@@ -0,0 +1,570 @@
+// Nuvens de pontos grandes (OBJ so com "v", com ou sem cor "v x y z r g b", e PLY ascii ou
+// binario little endian) em uma octree com nivel de detalhe, no estilo do Potree:
+// - cada no guarda uma amostra dos pontos da sua regiao: uma grade de POINT_OCTREE_GRID celulas
+//   por eixo e no maximo um ponto por celula, entao os pontos do no ficam a ~size / GRID uns dos
+//   outros (o "spacing" do no); o resto desce para os 8 filhos. O modelo e aditivo: desenhar um
+//   no mais os seus filhos nao repete ponto nenhum;
+// - os pontos sao reordenados no lugar, entao os de cada no ficam contiguos no array (um upload
+//   por no, sem copia);
+// - a construcao divide as subarvores grandes em tarefas do JobSystem;
+// - selectNodes escolhe os nos visiveis por prioridade (tamanho na tela) ate o orcamento de
+//   pontos, refinando so onde o spacing projetado passa do erro maximo em pixels.
+// Tudo fica na RAM (16 bytes por ponto); a GPU recebe so os nos selecionados.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <mutex>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+#include "JobSystem.h"
+
+using namespace std;
+
+// Celulas por eixo da grade de amostragem de cada no
+const int POINT_OCTREE_GRID = 64;
+// Nos com ate esta quantidade de pontos viram folhas e ficam com todos
+const size_t POINT_OCTREE_LEAF_CAPACITY = 20000;
+// Pontos repetidos nunca se separam; a profundidade para aqui
+const int POINT_OCTREE_MAX_DEPTH = 20;
+// Subarvores menores que isso sao construidas na mesma tarefa
+const size_t POINT_OCTREE_TASK_POINTS = 200000;
+// Bloco de texto lido por tarefa na leitura de OBJ
+const size_t POINT_CLOUD_BLOCK_BYTES = (size_t)8 << 20;
+
+struct CloudPoint {
+	glm::vec3 position;
+	// RGBA8, vermelho no byte baixo (atributo GL_UNSIGNED_BYTE normalizado)
+	uint32_t color;
+};
+
+struct PointCloud {
+	vector<CloudPoint> points;
+	bool hasColors = false;
+};
+
+inline uint32_t packPointColor(float r, float g, float b)
+{
+	auto channel = [](float value) { return (uint32_t)(min(max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+	return channel(r) | (channel(g) << 8) | (channel(b) << 16) | 0xFF000000u;
+}
+
+// Linhas "v x y z [r g b]" de [begin, end), que termina em '\n'; o resto do OBJ e ignorado
+inline void parsePointCloudObjBlock(char* begin, char* end, vector<CloudPoint>& points, bool& hasColors)
+{
+	char* line = begin;
+	while (line < end)
+	{
+		char* newline = (char*)memchr(line, '\n', end - line);
+		if (!newline) newline = end;
+		*newline = '\0';
+		while (*line == ' ' || *line == '\t') line++;
+		if (line[0] == 'v' && (line[1] == ' ' || line[1] == '\t'))
+		{
+			char* cursor = line + 2;
+			float values[6];
+			int count = 0;
+			for (; count < 6; count++)
+			{
+				char* next;
+				values[count] = strtof(cursor, &next);
+				if (next == cursor) break;
+				cursor = next;
+			}
+			if (count >= 3)
+			{
+				bool colored = count == 6;
+				hasColors = hasColors || colored;
+				points.push_back({ glm::vec3(values[0], values[1], values[2]),
+					colored ? packPointColor(values[3], values[4], values[5]) : 0xFFFFFFFFu });
+			}
+		}
+		line = newline + 1;
+	}
+}
+
+// Blocos de POINT_CLOUD_BLOCK_BYTES cortados no ultimo '\n'; uma leva de blocos (um por thread)
+// e interpretada em paralelo e anexada em ordem antes da proxima ser lida
+inline bool loadPointCloudObj(ifstream& file, PointCloud& cloud, JobSystem* jobs)
+{
+	int threads = jobs ? jobs->threadCount() : 1;
+	vector<vector<char>> blocks(threads);
+	vector<vector<CloudPoint>> parsed(threads);
+	vector<char> colored(threads);
+	vector<char> carry;
+	bool atEnd = false;
+	while (!atEnd)
+	{
+		int used = 0;
+		for (; used < threads && !atEnd; used++)
+		{
+			vector<char>& block = blocks[used];
+			block.assign(carry.begin(), carry.end());
+			block.resize(carry.size() + POINT_CLOUD_BLOCK_BYTES + 1);
+			file.read(block.data() + carry.size(), POINT_CLOUD_BLOCK_BYTES);
+			size_t filled = carry.size() + (size_t)file.gcount();
+			atEnd = !file;
+			size_t cut = filled;
+			if (!atEnd)
+			{
+				while (cut > 0 && block[cut - 1] != '\n') cut--;
+				// Linha maior que o bloco: segue para o proximo inteira
+				if (cut == 0) cut = filled;
+			}
+			carry.assign(block.begin() + cut, block.begin() + filled);
+			block[cut] = '\0';
+			block.resize(cut + 1);
+		}
+		JobCounter counter;
+		for (int b = 0; b < used; b++)
+		{
+			auto parse = [&blocks, &parsed, &colored, b]() {
+				bool hasColors = false;
+				parsed[b].clear();
+				parsePointCloudObjBlock(blocks[b].data(), blocks[b].data() + blocks[b].size() - 1, parsed[b], hasColors);
+				colored[b] = hasColors;
+			};
+			if (jobs) jobs->run(parse, &counter);
+			else parse();
+		}
+		if (jobs) jobs->wait(counter);
+		for (int b = 0; b < used; b++)
+		{
+			cloud.points.insert(cloud.points.end(), parsed[b].begin(), parsed[b].end());
+			cloud.hasColors = cloud.hasColors || colored[b];
+		}
+	}
+	return true;
+}
+
+enum PlyType { PLY_INT8, PLY_UINT8, PLY_INT16, PLY_UINT16, PLY_INT32, PLY_UINT32, PLY_FLOAT32, PLY_FLOAT64, PLY_UNKNOWN };
+
+inline PlyType plyType(const string& name)
+{
+	if (name == "char" || name == "int8") return PLY_INT8;
+	if (name == "uchar" || name == "uint8") return PLY_UINT8;
+	if (name == "short" || name == "int16") return PLY_INT16;
+	if (name == "ushort" || name == "uint16") return PLY_UINT16;
+	if (name == "int" || name == "int32") return PLY_INT32;
+	if (name == "uint" || name == "uint32") return PLY_UINT32;
+	if (name == "float" || name == "float32") return PLY_FLOAT32;
+	if (name == "double" || name == "float64") return PLY_FLOAT64;
+	return PLY_UNKNOWN;
+}
+
+inline int plyTypeSize(PlyType type)
+{
+	static const int sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8, 0 };
+	return sizes[type];
+}
+
+// Valor em little endian
+inline double readPlyValue(const unsigned char* data, PlyType type)
+{
+	switch (type)
+	{
+	case PLY_INT8: return (int8_t)data[0];
+	case PLY_UINT8: return data[0];
+	case PLY_INT16: { int16_t v; memcpy(&v, data, 2); return v; }
+	case PLY_UINT16: { uint16_t v; memcpy(&v, data, 2); return v; }
+	case PLY_INT32: { int32_t v; memcpy(&v, data, 4); return v; }
+	case PLY_UINT32: { uint32_t v; memcpy(&v, data, 4); return v; }
+	case PLY_FLOAT32: { float v; memcpy(&v, data, 4); return v; }
+	case PLY_FLOAT64: { double v; memcpy(&v, data, 8); return v; }
+	default: return 0.0;
+	}
+}
+
+// So o elemento vertex, que precisa ser o primeiro; x, y, z e (opcional) red, green, blue
+inline bool loadPointCloudPly(ifstream& file, PointCloud& cloud)
+{
+	struct Property {
+		string name;
+		PlyType type;
+		size_t offset;
+	};
+	vector<Property> properties;
+	string line, format;
+	size_t vertexCount = 0, stride = 0;
+	bool inVertex = false, vertexSeen = false;
+	while (getline(file, line))
+	{
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		istringstream iss(line);
+		string keyword;
+		iss >> keyword;
+		if (keyword == "format") iss >> format;
+		else if (keyword == "element")
+		{
+			string name;
+			iss >> name;
+			inVertex = name == "vertex" && !vertexSeen;
+			if (inVertex) iss >> vertexCount;
+			else if (!vertexSeen)
+			{
+				cerr << "PLY element before vertex not supported: " << name << endl;
+				return false;
+			}
+			vertexSeen = true;
+		}
+		else if (keyword == "property" && inVertex)
+		{
+			string typeName, name;
+			iss >> typeName >> name;
+			PlyType type = plyType(typeName);
+			if (type == PLY_UNKNOWN)
+			{
+				cerr << "PLY vertex property not supported: " << line << endl;
+				return false;
+			}
+			properties.push_back({ name, type, stride });
+			stride += plyTypeSize(type);
+		}
+		else if (keyword == "end_header") break;
+	}
+	int x = -1, y = -1, z = -1, r = -1, g = -1, b = -1;
+	for (int i = 0; i < (int)properties.size(); i++)
+	{
+		const string& name = properties[i].name;
+		if (name == "x") x = i;
+		else if (name == "y") y = i;
+		else if (name == "z") z = i;
+		else if (name == "red" || name == "r") r = i;
+		else if (name == "green" || name == "g") g = i;
+		else if (name == "blue" || name == "b") b = i;
+	}
+	if (x < 0 || y < 0 || z < 0 || (format != "ascii" && format != "binary_little_endian"))
+	{
+		cerr << "PLY without x/y/z or with unsupported format: " << format << endl;
+		return false;
+	}
+	cloud.hasColors = r >= 0 && g >= 0 && b >= 0;
+	// Cor inteira em 0..255, float em 0..1
+	auto colorScale = [&](int index) { return properties[index].type == PLY_FLOAT32 || properties[index].type == PLY_FLOAT64 ? 1.0f : 1.0f / 255.0f; };
+	cloud.points.reserve(vertexCount);
+	vector<double> values(properties.size());
+	auto addPoint = [&]() {
+		uint32_t color = cloud.hasColors
+			? packPointColor((float)values[r] * colorScale(r), (float)values[g] * colorScale(g), (float)values[b] * colorScale(b))
+			: 0xFFFFFFFFu;
+		cloud.points.push_back({ glm::vec3((float)values[x], (float)values[y], (float)values[z]), color });
+	};
+	if (format == "ascii")
+	{
+		for (size_t i = 0; i < vertexCount && getline(file, line); i++)
+		{
+			const char* cursor = line.c_str();
+			for (double& value : values)
+			{
+				char* next;
+				value = strtod(cursor, &next);
+				cursor = next;
+			}
+			addPoint();
+		}
+	}
+	else
+	{
+		const size_t verticesPerRead = 65536;
+		vector<unsigned char> buffer(verticesPerRead * stride);
+		for (size_t done = 0; done < vertexCount;)
+		{
+			size_t batch = min(verticesPerRead, vertexCount - done);
+			file.read((char*)buffer.data(), batch * stride);
+			if ((size_t)file.gcount() != batch * stride) break;
+			for (size_t v = 0; v < batch; v++)
+			{
+				const unsigned char* vertex = &buffer[v * stride];
+				for (size_t p = 0; p < properties.size(); p++) values[p] = readPlyValue(vertex + properties[p].offset, properties[p].type);
+				addPoint();
+			}
+			done += batch;
+		}
+	}
+	if (cloud.points.size() != vertexCount)
+	{
+		cerr << "PLY truncated: " << cloud.points.size() << " of " << vertexCount << " vertices" << endl;
+		return false;
+	}
+	return true;
+}
+
+// jobs (opcional) interpreta os blocos de um OBJ em paralelo
+inline bool loadPointCloud(const string& path, PointCloud& cloud, JobSystem* jobs = nullptr)
+{
+	cloud = PointCloud();
+	ifstream file(path, ios::binary);
+	if (!file.is_open())
+	{
+		cerr << "Failed to open point cloud: " << path << endl;
+		return false;
+	}
+	char magic[4] = {};
+	file.read(magic, 4);
+	file.clear();
+	file.seekg(0);
+	if (!strncmp(magic, "ply", 3) && (magic[3] == '\n' || magic[3] == '\r')) return loadPointCloudPly(file, cloud);
+	return loadPointCloudObj(file, cloud, jobs);
+}
+
+struct PointNode {
+	// Cubo do no
+	glm::vec3 boundsMin;
+	float size;
+	// Distancia aproximada entre os pontos do no (size / POINT_OCTREE_GRID)
+	float spacing;
+	int depth;
+	int parent;
+	int children[8];
+	// Pontos do proprio no em PointOctree::points
+	size_t first;
+	size_t count;
+};
+
+struct PointLodView {
+	glm::mat4 viewProjection;
+	glm::vec3 cameraPosition;
+	// Pixels por unidade de mundo a distancia 1: altura do viewport / (2 tan(fovy / 2))
+	float projectionFactor;
+};
+
+struct PointLodSettings {
+	size_t pointBudget = 3000000;
+	// Spacing projetado (pixels) a partir do qual os filhos sao visitados
+	float maxScreenError = 1.5f;
+};
+
+struct PointNodeSelection {
+	int node;
+	// Spacing do nivel mais fino selecionado abaixo do no: tamanho do ponto sem buracos entre os niveis
+	float drawSpacing;
+};
+
+class PointOctree
+{
+public:
+	vector<CloudPoint> points;
+	// 0 = raiz; pais sempre antes dos filhos
+	vector<PointNode> nodes;
+	bool hasColors = false;
+
+	// Consome a nuvem; jobs (opcional) constroi as subarvores grandes em paralelo
+	void build(PointCloud&& cloud, JobSystem* jobs = nullptr)
+	{
+		points.swap(cloud.points);
+		hasColors = cloud.hasColors;
+		cloud = PointCloud();
+		nodes.clear();
+		if (points.empty()) return;
+		glm::vec3 low(FLT_MAX), high(-FLT_MAX);
+		mutex boundsMutex;
+		auto bounds = [&](size_t first, size_t last) {
+			glm::vec3 blockLow(FLT_MAX), blockHigh(-FLT_MAX);
+			for (size_t i = first; i < last; i++)
+			{
+				blockLow = glm::min(blockLow, points[i].position);
+				blockHigh = glm::max(blockHigh, points[i].position);
+			}
+			lock_guard<mutex> lock(boundsMutex);
+			low = glm::min(low, blockLow);
+			high = glm::max(high, blockHigh);
+		};
+		if (jobs) jobs->parallelFor(0, points.size(), 1 << 20, bounds);
+		else bounds(0, points.size());
+		// Cubo um pouco maior que a caixa, para o ponto maximo cair dentro da ultima celula
+		float size = max(max(high.x - low.x, high.y - low.y), max(high.z - low.z, 1e-6f)) * 1.0001f;
+
+		BuildNode root;
+		root.boundsMin = low;
+		root.size = size;
+		root.first = 0;
+		root.count = points.size();
+		JobCounter counter;
+		buildNode(&root, jobs, &counter);
+		if (jobs) jobs->wait(counter);
+
+		// Achata em largura: pais antes dos filhos
+		vector<pair<const BuildNode*, int>> pending = { { &root, -1 } };
+		for (size_t i = 0; i < pending.size(); i++)
+		{
+			const BuildNode* source = pending[i].first;
+			PointNode node;
+			node.boundsMin = source->boundsMin;
+			node.size = source->size;
+			node.spacing = source->size / POINT_OCTREE_GRID;
+			node.depth = source->depth;
+			node.parent = pending[i].second;
+			node.first = source->first;
+			node.count = source->own;
+			for (int c = 0; c < 8; c++) node.children[c] = -1;
+			if (node.parent >= 0)
+			{
+				PointNode& parent = nodes[node.parent];
+				for (int c = 0; c < 8; c++)
+				{
+					if (parent.children[c] < 0)
+					{
+						parent.children[c] = (int)i;
+						break;
+					}
+				}
+			}
+			nodes.push_back(node);
+			for (const unique_ptr<BuildNode>& child : source->children)
+			{
+				if (child) pending.push_back({ child.get(), (int)i });
+			}
+		}
+	}
+
+	int maxDepth() const
+	{
+		int depth = 0;
+		for (const PointNode& node : nodes) depth = max(depth, node.depth);
+		return depth;
+	}
+
+	// Nos a desenhar, pais antes dos filhos. Visita por tamanho projetado (o maior primeiro) e para
+	// quando o proximo no passaria do orcamento; so desce onde o spacing projetado passa de maxScreenError
+	void selectNodes(const PointLodView& view, const PointLodSettings& settings, vector<PointNodeSelection>& selected) const
+	{
+		selected.clear();
+		if (nodes.empty()) return;
+		Frustum frustum = Frustum::fromMatrix(view.viewProjection);
+		selectedParents.clear();
+		priority_queue<Candidate> candidates;
+		if (frustum.intersectsAABB(nodes[0].boundsMin, nodes[0].boundsMin + glm::vec3(nodes[0].size))) candidates.push({ FLT_MAX, 0, -1 });
+		size_t selectedPoints = 0;
+		while (!candidates.empty())
+		{
+			Candidate candidate = candidates.top();
+			candidates.pop();
+			const PointNode& node = nodes[candidate.node];
+			if (selectedPoints + node.count > settings.pointBudget) break;
+			selectedPoints += node.count;
+			int selection = (int)selected.size();
+			selected.push_back({ candidate.node, node.spacing });
+			selectedParents.push_back(candidate.parentSelection);
+			if (projectedSize(node, node.spacing, view) <= settings.maxScreenError) continue;
+			for (int child : node.children)
+			{
+				if (child < 0) continue;
+				const PointNode& childNode = nodes[child];
+				if (!frustum.intersectsAABB(childNode.boundsMin, childNode.boundsMin + glm::vec3(childNode.size))) continue;
+				candidates.push({ projectedSize(childNode, childNode.size, view), child, selection });
+			}
+		}
+		// Filhos vem depois dos pais: de tras para frente o spacing mais fino sobe ate a raiz
+		for (size_t i = selected.size(); i-- > 1;)
+		{
+			PointNodeSelection& parent = selected[selectedParents[i]];
+			parent.drawSpacing = min(parent.drawSpacing, selected[i].drawSpacing);
+		}
+	}
+
+private:
+	struct Candidate {
+		float priority;
+		int node;
+		int parentSelection;
+		bool operator<(const Candidate& other) const { return priority < other.priority; }
+	};
+
+	struct BuildNode {
+		glm::vec3 boundsMin;
+		float size;
+		int depth = 0;
+		size_t first = 0, count = 0, own = 0;
+		unique_ptr<BuildNode> children[8];
+	};
+
+	mutable vector<int> selectedParents;
+
+	// Tamanho em pixels de length na distancia do no (a partir da borda da esfera envolvente)
+	static float projectedSize(const PointNode& node, float length, const PointLodView& view)
+	{
+		glm::vec3 center = node.boundsMin + glm::vec3(node.size * 0.5f);
+		float radius = node.size * 0.8660254f;
+		float distance = max(glm::length(center - view.cameraPosition) - radius, node.size * 0.01f);
+		return length * view.projectionFactor / distance;
+	}
+
+	void buildNode(BuildNode* node, JobSystem* jobs, JobCounter* counter)
+	{
+		if (node->count <= POINT_OCTREE_LEAF_CAPACITY || node->depth >= POINT_OCTREE_MAX_DEPTH)
+		{
+			node->own = node->count;
+			return;
+		}
+		CloudPoint* range = &points[node->first];
+		// Amostragem: o primeiro ponto de cada celula da grade fica no no e vai para o inicio do intervalo
+		const int grid = POINT_OCTREE_GRID;
+		vector<uint64_t> occupied(grid * grid * grid / 64);
+		float cellScale = grid / node->size;
+		size_t own = 0;
+		for (size_t i = 0; i < node->count; i++)
+		{
+			glm::ivec3 cell = glm::clamp(glm::ivec3((range[i].position - node->boundsMin) * cellScale), glm::ivec3(0), glm::ivec3(grid - 1));
+			size_t bit = ((size_t)cell.z * grid + cell.y) * grid + cell.x;
+			if (occupied[bit >> 6] & (1ull << (bit & 63))) continue;
+			occupied[bit >> 6] |= 1ull << (bit & 63);
+			swap(range[own++], range[i]);
+		}
+		node->own = own;
+
+		// O resto e separado por octante no lugar (American flag sort de um digito)
+		glm::vec3 center = node->boundsMin + glm::vec3(node->size * 0.5f);
+		auto octant = [&center](const CloudPoint& point) {
+			return (point.position.x >= center.x ? 1 : 0) | (point.position.y >= center.y ? 2 : 0) | (point.position.z >= center.z ? 4 : 0);
+		};
+		size_t counts[8] = {};
+		for (size_t i = own; i < node->count; i++) counts[octant(range[i])]++;
+		size_t heads[8], ends[8];
+		size_t offset = own;
+		for (int o = 0; o < 8; o++)
+		{
+			heads[o] = offset;
+			offset += counts[o];
+			ends[o] = offset;
+		}
+		for (int o = 0; o < 8; o++)
+		{
+			while (heads[o] < ends[o])
+			{
+				int target = octant(range[heads[o]]);
+				if (target == o) heads[o]++;
+				else swap(range[heads[o]], range[heads[target]++]);
+			}
+		}
+
+		float half = node->size * 0.5f;
+		for (int o = 0; o < 8; o++)
+		{
+			size_t first = o == 0 ? own : ends[o - 1];
+			if (counts[o] == 0) continue;
+			BuildNode* child = new BuildNode();
+			node->children[o].reset(child);
+			child->boundsMin = node->boundsMin + glm::vec3(o & 1 ? half : 0.0f, o & 2 ? half : 0.0f, o & 4 ? half : 0.0f);
+			child->size = half;
+			child->depth = node->depth + 1;
+			child->first = node->first + first;
+			child->count = counts[o];
+			if (jobs && child->count > POINT_OCTREE_TASK_POINTS) jobs->run([this, child, jobs, counter]() { buildNode(child, jobs, counter); }, counter);
+			else buildNode(child, jobs, counter);
+		}
+	}
+};
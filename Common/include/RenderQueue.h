@@ -0,0 +1,193 @@
+// Fila de desenho ordenada por chave. Os draws sao gravados como uma chave de 64 bits e um
+// payload (DrawItem); a cada frame as chaves sao ordenadas com radix sort e os draws executados
+// nessa ordem pelo GLStateCache, que descarta os binds repetidos. Layout da chave, do bit mais
+// significativo para o menos:
+//   opacos:       passe (4) | 0 | programa (8) | material (12) | VAO (12) | profundidade (24) | 3 livres
+//   translucidos: passe (4) | 1 | profundidade invertida (24) | programa (8) | material (12) | VAO (12) | 3 livres
+// Opacos agrupam por estado e dentro do grupo vao da frente para tras (early-z); translucidos
+// precisam ir de tras para frente, entao a profundidade sobe para antes do estado. Programa,
+// material e VAO entram na chave so pelos bits baixos dos nomes GL: colisoes so pioram o
+// agrupamento, porque o payload tem os nomes completos.
+// Gravacao em varias threads: cada tarefa grava no seu RenderQueueBucket (sem locks) e sort()
+// junta todos antes de ordenar.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "GLExt.h"
+#include "GLStateCache.h"
+
+using namespace std;
+
+const int RENDER_KEY_PASS_BITS = 4;
+const int RENDER_KEY_PROGRAM_BITS = 8;
+const int RENDER_KEY_MATERIAL_BITS = 12;
+const int RENDER_KEY_VAO_BITS = 12;
+const int RENDER_KEY_DEPTH_BITS = 24;
+
+enum DrawKind { DRAW_ARRAYS, DRAW_ELEMENTS, DRAW_ELEMENTS_INDIRECT };
+
+struct DrawItem {
+	GLuint program = 0, vao = 0;
+	// Textura 2D na unidade 0 (0 deixa a que estiver ligada)
+	GLuint texture = 0;
+	// Uniform da matriz model (-1 nao envia)
+	GLint modelLocation = -1;
+	glm::mat4 model = glm::mat4(1);
+	DrawKind kind = DRAW_ELEMENTS;
+	GLenum mode = GL_TRIANGLES;
+	// Vertices, indices ou, no indireto, comandos
+	GLsizei count = 0;
+	// Primeiro vertice, offset em bytes nos indices ou no buffer de comandos
+	GLintptr first = 0;
+	GLuint indirectBuffer = 0;
+};
+
+inline uint64_t renderKeyField(uint64_t value, int bits)
+{
+	return value & ((1ull << bits) - 1);
+}
+
+// depth: distancia normalizada (0 no near, 1 no far); fora do intervalo e saturada
+inline uint64_t makeRenderKey(int pass, bool translucent, GLuint program, GLuint material, GLuint vao, float depth)
+{
+	const uint64_t depthMax = (1ull << RENDER_KEY_DEPTH_BITS) - 1;
+	uint64_t depthBits = (uint64_t)(min(max(depth, 0.0f), 1.0f) * depthMax);
+	uint64_t state = (renderKeyField(program, RENDER_KEY_PROGRAM_BITS) << (RENDER_KEY_MATERIAL_BITS + RENDER_KEY_VAO_BITS))
+		| (renderKeyField(material, RENDER_KEY_MATERIAL_BITS) << RENDER_KEY_VAO_BITS)
+		| renderKeyField(vao, RENDER_KEY_VAO_BITS);
+	const int stateBits = RENDER_KEY_PROGRAM_BITS + RENDER_KEY_MATERIAL_BITS + RENDER_KEY_VAO_BITS;
+	uint64_t body = translucent
+		? ((depthMax - depthBits) << stateBits) | state
+		: (state << RENDER_KEY_DEPTH_BITS) | depthBits;
+	return (renderKeyField(pass, RENDER_KEY_PASS_BITS) << 60) | ((uint64_t)translucent << 59) | (body << 3);
+}
+
+// Draws gravados por uma tarefa
+class RenderQueueBucket
+{
+public:
+	void submit(uint64_t key, const DrawItem& item)
+	{
+		keys.push_back(key);
+		items.push_back(item);
+	}
+
+	void clear()
+	{
+		keys.clear();
+		items.clear();
+	}
+
+	size_t size() const { return keys.size(); }
+	// Na ordem de gravacao
+	uint64_t key(size_t i) const { return keys[i]; }
+	const DrawItem& item(size_t i) const { return items[i]; }
+
+private:
+	vector<uint64_t> keys;
+	vector<DrawItem> items;
+};
+
+class RenderQueue
+{
+public:
+	// Um bucket por tarefa que vai gravar no frame; os anteriores sao esvaziados
+	void begin(int bucketCount)
+	{
+		if ((int)buckets.size() < bucketCount) buckets.resize(bucketCount);
+		for (RenderQueueBucket& bucket : buckets) bucket.clear();
+		activeBuckets = bucketCount;
+		sorted.clear();
+	}
+
+	RenderQueueBucket& bucket(int index) { return buckets[index]; }
+
+	// Junta os buckets (na ordem dos indices) e ordena por chave; empates mantem a ordem de gravacao
+	void sort()
+	{
+		sorted.clear();
+		for (int b = 0; b < activeBuckets; b++)
+		{
+			const RenderQueueBucket& bucket = buckets[b];
+			for (size_t i = 0; i < bucket.size(); i++)
+			{
+				sorted.push_back({ bucket.key(i), (uint32_t)b, (uint32_t)i });
+			}
+		}
+		radixSort(sorted, scratch);
+	}
+
+	size_t size() const { return sorted.size(); }
+	const DrawItem& item(size_t i) const { return buckets[sorted[i].bucket].item(sorted[i].index); }
+	uint64_t key(size_t i) const { return sorted[i].key; }
+
+	// Executa na ordem da chave; o estado vai pelo cache, entao so as trocas reais chegam ao driver
+	void execute(GLStateCache& state) const
+	{
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			const DrawItem& draw = item(i);
+			state.useProgram(draw.program);
+			state.bindVertexArray(draw.vao);
+			if (draw.texture) state.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, draw.texture);
+			if (draw.modelLocation >= 0) glUniformMatrix4fv(draw.modelLocation, 1, GL_FALSE, glm::value_ptr(draw.model));
+			switch (draw.kind)
+			{
+			case DRAW_ARRAYS:
+				glDrawArrays(draw.mode, (GLint)draw.first, draw.count);
+				break;
+			case DRAW_ELEMENTS:
+				glDrawElements(draw.mode, draw.count, GL_UNSIGNED_INT, (const GLvoid*)draw.first);
+				break;
+			case DRAW_ELEMENTS_INDIRECT:
+				state.bindBuffer(GL_DRAW_INDIRECT_BUFFER, draw.indirectBuffer);
+				glMultiDrawElementsIndirect(draw.mode, GL_UNSIGNED_INT, (const GLvoid*)draw.first, draw.count, 0);
+				break;
+			}
+		}
+	}
+
+	struct Entry {
+		uint64_t key;
+		uint32_t bucket, index;
+	};
+
+	// LSD de 8 bits por passada (estavel); passadas em que todas as chaves tem o mesmo byte sao puladas
+	static void radixSort(vector<Entry>& entries, vector<Entry>& scratch)
+	{
+		scratch.resize(entries.size());
+		size_t counts[8][256] = {};
+		for (const Entry& entry : entries)
+		{
+			for (int digit = 0; digit < 8; digit++) counts[digit][(entry.key >> (digit * 8)) & 255]++;
+		}
+		for (int digit = 0; digit < 8; digit++)
+		{
+			if (counts[digit][(entries.empty() ? 0 : entries[0].key >> (digit * 8)) & 255] == entries.size()) continue;
+			size_t offsets[256];
+			size_t total = 0;
+			for (int value = 0; value < 256; value++)
+			{
+				offsets[value] = total;
+				total += counts[digit][value];
+			}
+			for (const Entry& entry : entries) scratch[offsets[(entry.key >> (digit * 8)) & 255]++] = entry;
+			entries.swap(scratch);
+		}
+	}
+
+private:
+	vector<RenderQueueBucket> buckets;
+	int activeBuckets = 0;
+	vector<Entry> sorted, scratch;
+};
@@ -0,0 +1,114 @@
+// Buffer de streaming para dados que mudam a cada frame (matrizes de modelo, dados de instancia).
+// Usa glBufferStorage com GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT: o buffer fica mapeado
+// a vida toda e e dividido em frameCount regioes (triple buffering por padrao). Cada regiao
+// recebe um glFenceSync quando o frame termina, e so volta a ser escrita quando a GPU passou
+// por esse fence, entao a CPU nunca sobrescreve dados ainda em uso. O tamanho da regiao e
+// arredondado para o alinhamento do construtor, entao todas comecam alinhadas (ex.:
+// GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT para glBindBufferRange).
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "GLExt.h"
+
+using namespace std;
+
+class PersistentRingBuffer
+{
+public:
+	GLuint ID = 0;
+	GLenum target;
+	GLsizeiptr regionSize;
+	int regionCount;
+	// Quantas vezes beginFrame precisou esperar a GPU (deveria ficar em zero)
+	int stalls = 0;
+
+	PersistentRingBuffer(GLenum target, GLsizeiptr size, GLintptr alignment = 1, int regionCount = 3)
+		: target(target), regionSize((size + alignment - 1) / alignment * alignment), regionCount(regionCount), fences(regionCount, (GLsync)0)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glGenBuffers(1, &ID);
+		glBindBuffer(target, ID);
+		glBufferStorage(target, regionSize * regionCount, nullptr, flags);
+		mapped = (unsigned char*)glMapBufferRange(target, 0, regionSize * regionCount, flags);
+		glBindBuffer(target, 0);
+		if (!mapped)
+		{
+			cout << "ERROR::RING_BUFFER::MAP_FAILED" << endl;
+		}
+	}
+
+	PersistentRingBuffer(const PersistentRingBuffer&) = delete;
+	PersistentRingBuffer& operator=(const PersistentRingBuffer&) = delete;
+
+	// Espera (se preciso) a GPU liberar a proxima regiao e reinicia a alocacao dentro dela
+	void beginFrame()
+	{
+		GLsync fence = fences[current];
+		if (fence)
+		{
+			GLenum result = glClientWaitSync(fence, 0, 0);
+			if (result == GL_TIMEOUT_EXPIRED)
+			{
+				stalls++;
+				while (result == GL_TIMEOUT_EXPIRED)
+				{
+					result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+				}
+			}
+			glDeleteSync(fence);
+			fences[current] = 0;
+		}
+		head = 0;
+	}
+
+	// Reserva size bytes na regiao do frame atual; offset e o deslocamento absoluto no buffer,
+	// alinhado a alignment, pronto para glBindBufferRange / glVertexAttribPointer
+	void* allocate(GLsizeiptr size, GLintptr alignment, GLintptr& offset)
+	{
+		GLintptr regionStart = current * regionSize;
+		GLintptr aligned = (regionStart + head + alignment - 1) / alignment * alignment;
+		if (aligned + size > regionStart + regionSize)
+		{
+			cout << "ERROR::RING_BUFFER::REGION_OVERFLOW" << endl;
+			return nullptr;
+		}
+		head = aligned + size - regionStart;
+		offset = aligned;
+		return mapped + offset;
+	}
+
+	// Marca a regiao como em uso pela GPU e avanca para a proxima
+	void endFrame()
+	{
+		fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		current = (current + 1) % regionCount;
+	}
+
+	// Precisa ser chamada com o contexto ainda ativo (antes do glfwTerminate)
+	void release()
+	{
+		for (GLsync& fence : fences)
+		{
+			if (fence) glDeleteSync(fence);
+			fence = 0;
+		}
+		glBindBuffer(target, ID);
+		glUnmapBuffer(target);
+		glBindBuffer(target, 0);
+		glDeleteBuffers(1, &ID);
+		ID = 0;
+		mapped = nullptr;
+	}
+
+private:
+	unsigned char* mapped = nullptr;
+	vector<GLsync> fences;
+	int current = 0;
+	GLintptr head = 0;
+};
@@ -14,43 +14,50 @@
 // GLFW
 #include <GLFW/glfw3.h>
 
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+
 using namespace std;
 
 class Shader
 {
 public:
 	GLuint ID;
+	// Empty shader, compiled later with compile() (e.g. sources read on another thread)
+	Shader() : ID(0)
+	{
+	}
 	// Constructor generates the shader on the fly
 	Shader(const GLchar* vertexPath, const GLchar* fragmentPath)
 	{
 		// 1. Retrieve the vertex/fragment source code from filePath
-		std::string vertexCode;
-		std::string fragmentCode;
-		std::ifstream vShaderFile;
-		std::ifstream fShaderFile;
+		compile(readFile(vertexPath), readFile(fragmentPath));
+	}
+	// Reads a shader source file; needs no OpenGL context, so it can run on any thread
+	static std::string readFile(const GLchar* path)
+	{
+		std::ifstream shaderFile;
 		// ensures ifstream objects can throw exceptions:
-		vShaderFile.exceptions(std::ifstream::badbit);
-		fShaderFile.exceptions(std::ifstream::badbit);
+		shaderFile.exceptions(std::ifstream::badbit);
 		try
 		{
-			// Open files
-			vShaderFile.open(vertexPath);
-			fShaderFile.open(fragmentPath);
-			std::stringstream vShaderStream, fShaderStream;
+			shaderFile.open(path);
+			std::stringstream shaderStream;
 			// Read file's buffer contents into streams
-			vShaderStream << vShaderFile.rdbuf();
-			fShaderStream << fShaderFile.rdbuf();
-			// close file handlers
-			vShaderFile.close();
-			fShaderFile.close();
-			// Convert stream into string
-			vertexCode = vShaderStream.str();
-			fragmentCode = fShaderStream.str();
+			shaderStream << shaderFile.rdbuf();
+			shaderFile.close();
+			return shaderStream.str();
 		}
 		catch (std::ifstream::failure e)
 		{
 			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
 		}
+		return "";
+	}
+	// Compiles and links vertex/fragment sources (context thread only)
+	void compile(const std::string& vertexCode, const std::string& fragmentCode)
+	{
 		const GLchar* vShaderCode = vertexCode.c_str();
 		const GLchar * fShaderCode = fragmentCode.c_str();
 		// 2. Compile shaders
@@ -96,6 +103,47 @@ public:
 		glDeleteShader(fragment);
 
 	}
+	// Constructor for a compute-only program (needs an OpenGL 4.3+ context)
+	Shader(const GLchar* computePath)
+	{
+		std::string computeCode;
+		std::ifstream cShaderFile;
+		cShaderFile.exceptions(std::ifstream::badbit);
+		try
+		{
+			cShaderFile.open(computePath);
+			std::stringstream cShaderStream;
+			cShaderStream << cShaderFile.rdbuf();
+			cShaderFile.close();
+			computeCode = cShaderStream.str();
+		}
+		catch (std::ifstream::failure e)
+		{
+			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+		}
+		const GLchar* cShaderCode = computeCode.c_str();
+		GLint success;
+		GLchar infoLog[512];
+		GLuint compute = glCreateShader(GL_COMPUTE_SHADER);
+		glShaderSource(compute, 1, &cShaderCode, NULL);
+		glCompileShader(compute);
+		glGetShaderiv(compute, GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(compute, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::COMPUTE::COMPILATION_FAILED\n" << infoLog << std::endl;
+		}
+		this->ID = glCreateProgram();
+		glAttachShader(this->ID, compute);
+		glLinkProgram(this->ID);
+		glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
+			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+		}
+		glDeleteShader(compute);
+	}
 	// Uses the current shader
 	void Use()
 	{
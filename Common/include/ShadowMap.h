@@ -0,0 +1,153 @@
+// Shadow map de luz direcional com cache da geometria estatica. Sao duas texturas de profundidade:
+// - staticDepth: so os objetos estaticos, renderizados de novo apenas quando a luz ou algum
+//   objeto estatico muda (invalidate/setLight);
+// - depth: a que o shader amostra. A cada frame recebe uma copia do cache (blit de profundidade,
+//   bem mais barato que redesenhar) e por cima os objetos dinamicos.
+// A projecao e ortografica, ajustada a uma esfera que envolve a cena, olhando da posicao da luz
+// para o centro (luz distante). O shader amostra com sampler2DShadow e PCF de
+// (2 * raio + 1)^2 taps, cada um ja filtrado 2x2 pelo hardware (GL_LINEAR com comparacao).
+
+#pragma once
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+//GLAD
+#include <glad/glad.h>
+
+const int SHADOW_MAP_SIZE = 2048;
+// Raio do kernel de PCF por nivel de qualidade: 1, 9, 25 e 49 taps
+const int SHADOW_PCF_RADIUS[] = { 0, 1, 2, 3 };
+const int SHADOW_PCF_LEVELS = 4;
+
+class CachedShadowMap
+{
+public:
+	GLuint depth = 0, staticDepth = 0;
+	int size = 0;
+	glm::mat4 lightSpace = glm::mat4(1);
+	// Quantas vezes o cache estatico foi refeito (para o relatorio)
+	int staticRenders = 0;
+
+	void init(int mapSize = SHADOW_MAP_SIZE)
+	{
+		size = mapSize;
+		staticDepth = createDepthTexture(false);
+		depth = createDepthTexture(true);
+		glGenFramebuffers(1, &staticFbo);
+		attach(staticFbo, staticDepth);
+		glGenFramebuffers(1, &fbo);
+		attach(fbo, depth);
+	}
+
+	// Recalcula a matriz da luz; se mudou, o cache estatico fica invalido
+	void setLight(const glm::vec3& lightPosition, const glm::vec3& center, float radius)
+	{
+		glm::vec3 direction = glm::normalize(lightPosition - center);
+		glm::vec3 up = fabs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		glm::mat4 view = glm::lookAt(center + direction * radius * 2.0f, center, up);
+		glm::mat4 matrix = glm::ortho(-radius, radius, -radius, radius, radius, radius * 3.0f) * view;
+		if (matrix != lightSpace)
+		{
+			lightSpace = matrix;
+			staticValid = false;
+		}
+	}
+
+	void invalidate() { staticValid = false; }
+	bool needsStaticPass() const { return !staticValid; }
+
+	// Entre beginStaticPass e endPass: desenhar os objetos estaticos com lightSpace * model
+	void beginStaticPass()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, staticFbo);
+		inStaticPass = true;
+		beginPass();
+		glClear(GL_DEPTH_BUFFER_BIT);
+	}
+
+	// Copia o cache e deixa depth pronta para os objetos dinamicos
+	void beginDynamicPass()
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, staticFbo);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+		glBlitFramebuffer(0, 0, size, size, 0, 0, size, size, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		beginPass();
+	}
+
+	// Volta para o framebuffer padrao; o viewport fica por conta de quem chama
+	void endPass()
+	{
+		if (inStaticPass)
+		{
+			staticValid = true;
+			staticRenders++;
+		}
+		inStaticPass = false;
+		glDisable(GL_POLYGON_OFFSET_FILL);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void bind(GLenum unit) const
+	{
+		glActiveTexture(unit);
+		glBindTexture(GL_TEXTURE_2D, depth);
+	}
+
+	void release()
+	{
+		glDeleteFramebuffers(1, &staticFbo);
+		glDeleteFramebuffers(1, &fbo);
+		glDeleteTextures(1, &staticDepth);
+		glDeleteTextures(1, &depth);
+		staticFbo = fbo = staticDepth = depth = 0;
+	}
+
+private:
+	GLuint fbo = 0, staticFbo = 0;
+	bool staticValid = false, inStaticPass = false;
+
+	GLuint createDepthTexture(bool compare)
+	{
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size, size, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, compare ? GL_LINEAR : GL_NEAREST);
+		// Fora do mapa conta como iluminado
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		float border[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border);
+		if (compare)
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+
+	void attach(GLuint framebuffer, GLuint texture)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void beginPass()
+	{
+		glViewport(0, 0, size, size);
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		// Offset na profundidade contra acne nas superficies inclinadas em relacao a luz
+		glEnable(GL_POLYGON_OFFSET_FILL);
+		glPolygonOffset(2.0f, 4.0f);
+	}
+};
@@ -0,0 +1,517 @@
+// Rasterizador em CPU para rodar sem GPU (servidores de render e testes de regressao).
+// Consome o mesmo array intercalado de parseObjFile (OBJ_VERTEX_STRIDE floats por vertice)
+// e reproduz o pipeline de sprite.vs/sprite.fs: Phong + textura, correcao de perspectiva
+// nas coordenadas de textura e teste de profundidade GL_LESS.
+//
+// Organizacao:
+//  1. geometria: cada thread transforma, recorta (plano near) e monta uma faixa de triangulos,
+//     distribuindo-os em bins por tile (64x64) - um conjunto de bins por thread, sem locks;
+//  2. rasterizacao: as threads pegam tiles de um contador atomico e percorrem os bins de todas
+//     as threads na ordem original; funcoes de aresta e shading sao avaliados 8 pixels por vez.
+// As duas etapas rodam no JobSystem do rasterizador, com threadCount - 1 workers criados uma vez.
+// Os vetores de 8 lanes usam dois registradores SSE2 (disponivel em qualquer x86/x64).
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+#include <cstdint>
+
+#include <emmintrin.h>
+
+//GLM
+#include <glm/glm.hpp>
+
+#include "JobSystem.h"
+
+using namespace std;
+
+struct F8
+{
+	__m128 lo, hi;
+	F8() {}
+	F8(__m128 l, __m128 h) : lo(l), hi(h) {}
+	explicit F8(float v) : lo(_mm_set1_ps(v)), hi(_mm_set1_ps(v)) {}
+	static F8 load(const float* p) { return F8(_mm_loadu_ps(p), _mm_loadu_ps(p + 4)); }
+	void store(float* p) const { _mm_storeu_ps(p, lo); _mm_storeu_ps(p + 4, hi); }
+};
+
+inline F8 operator+(F8 a, F8 b) { return F8(_mm_add_ps(a.lo, b.lo), _mm_add_ps(a.hi, b.hi)); }
+inline F8 operator-(F8 a, F8 b) { return F8(_mm_sub_ps(a.lo, b.lo), _mm_sub_ps(a.hi, b.hi)); }
+inline F8 operator*(F8 a, F8 b) { return F8(_mm_mul_ps(a.lo, b.lo), _mm_mul_ps(a.hi, b.hi)); }
+inline F8 operator/(F8 a, F8 b) { return F8(_mm_div_ps(a.lo, b.lo), _mm_div_ps(a.hi, b.hi)); }
+inline F8 operator&(F8 a, F8 b) { return F8(_mm_and_ps(a.lo, b.lo), _mm_and_ps(a.hi, b.hi)); }
+inline F8 min8(F8 a, F8 b) { return F8(_mm_min_ps(a.lo, b.lo), _mm_min_ps(a.hi, b.hi)); }
+inline F8 max8(F8 a, F8 b) { return F8(_mm_max_ps(a.lo, b.lo), _mm_max_ps(a.hi, b.hi)); }
+inline F8 sqrt8(F8 a) { return F8(_mm_sqrt_ps(a.lo), _mm_sqrt_ps(a.hi)); }
+inline F8 cmpgt8(F8 a, F8 b) { return F8(_mm_cmpgt_ps(a.lo, b.lo), _mm_cmpgt_ps(a.hi, b.hi)); }
+inline F8 cmpge8(F8 a, F8 b) { return F8(_mm_cmpge_ps(a.lo, b.lo), _mm_cmpge_ps(a.hi, b.hi)); }
+inline F8 cmplt8(F8 a, F8 b) { return F8(_mm_cmplt_ps(a.lo, b.lo), _mm_cmplt_ps(a.hi, b.hi)); }
+inline F8 select8(F8 mask, F8 a, F8 b)
+{
+	return F8(_mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo)),
+		_mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi)));
+}
+inline int movemask8(F8 mask) { return _mm_movemask_ps(mask.lo) | (_mm_movemask_ps(mask.hi) << 4); }
+
+// log2/exp2 aproximados por polinomios de grau 5 (erro relativo ~1e-5), usados no pow do especular
+inline __m128 log2Approx(__m128 x)
+{
+	__m128i bits = _mm_castps_si128(x);
+	__m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	__m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+	__m128 p = _mm_set1_ps(-3.4436006e-2f);
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(3.1821337e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-1.2315303f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(2.5988452f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-3.3241990f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(3.1157899f));
+	return _mm_add_ps(_mm_mul_ps(p, _mm_sub_ps(m, _mm_set1_ps(1.0f))), e);
+}
+
+inline __m128 exp2Approx(__m128 x)
+{
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.99999f)), _mm_set1_ps(129.0f));
+	__m128i ipart = _mm_cvtps_epi32(_mm_sub_ps(x, _mm_set1_ps(0.5f)));
+	__m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(ipart));
+	__m128 expi = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(ipart, _mm_set1_epi32(127)), 23));
+	__m128 p = _mm_set1_ps(1.8775767e-3f);
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(8.9893397e-3f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.5826318e-2f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.4015361e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.9315308e-1f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.9999994e-1f));
+	return _mm_mul_ps(expi, p);
+}
+
+// pow(x, q) para x >= 0; lanes com x == 0 resultam em 0
+inline F8 pow8(F8 x, float q)
+{
+	F8 positive = cmpgt8(x, F8(0.0f));
+	__m128 qq = _mm_set1_ps(q);
+	F8 r(exp2Approx(_mm_mul_ps(qq, log2Approx(x.lo))), exp2Approx(_mm_mul_ps(qq, log2Approx(x.hi))));
+	return r & positive;
+}
+
+struct SoftwareTexture
+{
+	int width = 0, height = 0, channels = 0;
+	const unsigned char* data = nullptr;
+};
+
+// Equivalente aos uniforms de sprite.vs/sprite.fs
+struct SoftwareUniforms
+{
+	glm::mat4 model = glm::mat4(1);
+	glm::mat4 view = glm::mat4(1);
+	glm::mat4 projection = glm::mat4(1);
+	glm::vec3 ka, kd, ks;
+	float q = 1.0f;
+	glm::vec3 lightPosition, lightColor;
+	glm::vec3 cameraPos;
+	glm::vec3 clearColor = glm::vec3(0.08f, 0.08f, 0.08f);
+};
+
+class SoftwareRasterizer
+{
+public:
+	static const int TILE_SIZE = 64;
+	// Atributos interpolados: u, v, normal (3), posicao no mundo (3)
+	static const int ATTRIBUTE_COUNT = 8;
+
+	int width, height, threadCount;
+	// Largura de cada linha nos buffers, multipla de 8 para que um bloco de 8 pixels
+	// nunca invada o tile (e a thread) vizinho
+	int pitch;
+	// RGBA8, linha 0 no topo da imagem
+	vector<uint32_t> color;
+	vector<float> depth;
+	double lastGeometryMs = 0.0, lastRasterMs = 0.0;
+	size_t lastTriangleCount = 0;
+
+	SoftwareRasterizer(int width, int height, int threadCount = 0)
+		: width(width), height(height), threadCount(threadCount)
+	{
+		if (this->threadCount <= 0) this->threadCount = max(1, (int)thread::hardware_concurrency());
+		tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+		tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+		pitch = (width + 7) & ~7;
+		color.assign(pitch * height, 0);
+		depth.assign(pitch * height, 1.0f);
+		setups.resize(this->threadCount);
+		bins.resize(this->threadCount, vector<vector<uint32_t>>(tilesX * tilesY));
+		jobs.reset(new JobSystem(this->threadCount - 1));
+	}
+
+	// Limpa os buffers e desenha uma malha (glDrawArrays(GL_TRIANGLES, ...) equivalente)
+	void renderFrame(const vector<float>& vertices, int stride, const SoftwareUniforms& uniforms, const SoftwareTexture& texture)
+	{
+		auto start = chrono::steady_clock::now();
+		size_t triangleCount = vertices.size() / stride / 3;
+		runParallel([&](int worker)
+		{
+			size_t first = triangleCount * worker / threadCount;
+			size_t last = triangleCount * (worker + 1) / threadCount;
+			processGeometry(worker, vertices, stride, first, last, uniforms);
+		});
+		auto middle = chrono::steady_clock::now();
+		atomic<int> nextTile(0);
+		runParallel([&](int)
+		{
+			int tile;
+			while ((tile = nextTile.fetch_add(1)) < tilesX * tilesY)
+			{
+				rasterTile(tile, uniforms, texture);
+			}
+		});
+		auto end = chrono::steady_clock::now();
+		lastTriangleCount = 0;
+		for (const auto& s : setups) lastTriangleCount += s.size();
+		lastGeometryMs = chrono::duration<double, milli>(middle - start).count();
+		lastRasterMs = chrono::duration<double, milli>(end - middle).count();
+	}
+
+	bool writePPM(const string& path) const
+	{
+		ofstream file(path, ios::binary);
+		if (!file.is_open()) return false;
+		file << "P6\n" << width << " " << height << "\n255\n";
+		vector<unsigned char> row(width * 3);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				uint32_t c = color[y * pitch + x];
+				row[x * 3 + 0] = c & 0xFF;
+				row[x * 3 + 1] = (c >> 8) & 0xFF;
+				row[x * 3 + 2] = (c >> 16) & 0xFF;
+			}
+			file.write((const char*)row.data(), row.size());
+		}
+		return true;
+	}
+
+private:
+	struct ClipVertex
+	{
+		glm::vec4 clip;
+		float attributes[ATTRIBUTE_COUNT];
+	};
+
+	struct RasterTriangle
+	{
+		// Funcoes de aresta E(x, y) = A x + B y + C, positivas no interior
+		float A[3], B[3], C[3];
+		bool topLeft[3];
+		float invArea;
+		float z[3], invW[3];
+		float attributes[3][ATTRIBUTE_COUNT]; // ja divididos por w
+		int minX, minY, maxX, maxY;
+	};
+
+	int tilesX, tilesY;
+	vector<vector<RasterTriangle>> setups;
+	vector<vector<vector<uint32_t>>> bins;
+
+	unique_ptr<JobSystem> jobs;
+
+	// function(indice) para cada indice em [0, threadCount), uma tarefa por indice
+	template <typename Function>
+	void runParallel(Function function)
+	{
+		jobs->parallelFor(0, threadCount, 1, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++) function((int)i);
+		});
+	}
+
+	void processGeometry(int worker, const vector<float>& vertices, int stride, size_t first, size_t last, const SoftwareUniforms& uniforms)
+	{
+		vector<RasterTriangle>& setup = setups[worker];
+		setup.clear();
+		for (auto& bin : bins[worker]) bin.clear();
+		glm::mat4 viewProjection = uniforms.projection * uniforms.view;
+		glm::mat3 normalMatrix(uniforms.model);
+		for (size_t t = first; t < last; t++)
+		{
+			ClipVertex triangle[3];
+			for (int k = 0; k < 3; k++)
+			{
+				const float* v = &vertices[(t * 3 + k) * stride];
+				glm::vec4 world = uniforms.model * glm::vec4(v[0], v[1], v[2], 1.0f);
+				ClipVertex& out = triangle[k];
+				out.clip = viewProjection * world;
+				// sprite.vs: textureCoord = (u, 1 - v); scaledNormal = mat3(model) * normal
+				glm::vec3 normal = normalMatrix * glm::vec3(v[8], v[9], v[10]);
+				out.attributes[0] = v[6];
+				out.attributes[1] = 1.0f - v[7];
+				out.attributes[2] = normal.x;
+				out.attributes[3] = normal.y;
+				out.attributes[4] = normal.z;
+				out.attributes[5] = world.x;
+				out.attributes[6] = world.y;
+				out.attributes[7] = world.z;
+			}
+			clipAndSetup(worker, triangle);
+		}
+	}
+
+	static bool outside(const ClipVertex* v, int axis, float sign)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			if (sign * v[k].clip[axis] <= v[k].clip.w) return false;
+		}
+		return true;
+	}
+
+	static ClipVertex lerpVertex(const ClipVertex& a, const ClipVertex& b, float t)
+	{
+		ClipVertex r;
+		r.clip = a.clip + (b.clip - a.clip) * t;
+		for (int i = 0; i < ATTRIBUTE_COUNT; i++)
+		{
+			r.attributes[i] = a.attributes[i] + (b.attributes[i] - a.attributes[i]) * t;
+		}
+		return r;
+	}
+
+	void clipAndSetup(int worker, const ClipVertex* triangle)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (outside(triangle, axis, 1.0f) || outside(triangle, axis, -1.0f)) return;
+		}
+		// Recorte apenas contra o plano near (z >= -w); os demais ficam a cargo do bounding box
+		ClipVertex polygon[4];
+		int count = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			const ClipVertex& a = triangle[k];
+			const ClipVertex& b = triangle[(k + 1) % 3];
+			float da = a.clip.z + a.clip.w;
+			float db = b.clip.z + b.clip.w;
+			if (da >= 0.0f) polygon[count++] = a;
+			if ((da >= 0.0f) != (db >= 0.0f)) polygon[count++] = lerpVertex(a, b, da / (da - db));
+		}
+		for (int k = 1; k + 1 < count; k++)
+		{
+			setupTriangle(worker, polygon[0], polygon[k], polygon[k + 1]);
+		}
+	}
+
+	void setupTriangle(int worker, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2)
+	{
+		const ClipVertex* v[3] = { &v0, &v1, &v2 };
+		RasterTriangle tri;
+		float x[3], y[3];
+		for (int k = 0; k < 3; k++)
+		{
+			float invW = 1.0f / v[k]->clip.w;
+			x[k] = (v[k]->clip.x * invW * 0.5f + 0.5f) * width;
+			y[k] = (0.5f - v[k]->clip.y * invW * 0.5f) * height;
+			tri.z[k] = v[k]->clip.z * invW * 0.5f + 0.5f;
+			tri.invW[k] = invW;
+			for (int i = 0; i < ATTRIBUTE_COUNT; i++) tri.attributes[k][i] = v[k]->attributes[i] * invW;
+		}
+		// Aresta k e a oposta ao vertice k
+		for (int k = 0; k < 3; k++)
+		{
+			int a = (k + 1) % 3, b = (k + 2) % 3;
+			tri.A[k] = y[a] - y[b];
+			tri.B[k] = x[b] - x[a];
+			tri.C[k] = x[a] * y[b] - y[a] * x[b];
+		}
+		float area = tri.C[0] + tri.C[1] + tri.C[2];
+		if (area == 0.0f) return;
+		// Sem GL_CULL_FACE: triangulos nas duas orientacoes sao desenhados
+		if (area < 0.0f)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				tri.A[k] = -tri.A[k];
+				tri.B[k] = -tri.B[k];
+				tri.C[k] = -tri.C[k];
+			}
+			area = -area;
+		}
+		for (int k = 0; k < 3; k++)
+		{
+			tri.topLeft[k] = tri.A[k] > 0.0f || (tri.A[k] == 0.0f && tri.B[k] > 0.0f);
+		}
+		tri.invArea = 1.0f / area;
+		tri.minX = max(0, (int)floor(min(x[0], min(x[1], x[2]))));
+		tri.minY = max(0, (int)floor(min(y[0], min(y[1], y[2]))));
+		tri.maxX = min(width - 1, (int)ceil(max(x[0], max(x[1], x[2]))));
+		tri.maxY = min(height - 1, (int)ceil(max(y[0], max(y[1], y[2]))));
+		if (tri.minX > tri.maxX || tri.minY > tri.maxY) return;
+
+		uint32_t index = (uint32_t)setups[worker].size();
+		setups[worker].push_back(tri);
+		for (int ty = tri.minY / TILE_SIZE; ty <= tri.maxY / TILE_SIZE; ty++)
+		{
+			for (int tx = tri.minX / TILE_SIZE; tx <= tri.maxX / TILE_SIZE; tx++)
+			{
+				bins[worker][ty * tilesX + tx].push_back(index);
+			}
+		}
+	}
+
+	void rasterTile(int tile, const SoftwareUniforms& uniforms, const SoftwareTexture& texture)
+	{
+		int tx0 = (tile % tilesX) * TILE_SIZE;
+		int ty0 = (tile / tilesX) * TILE_SIZE;
+		int tx1 = min(tx0 + TILE_SIZE, width);
+		int ty1 = min(ty0 + TILE_SIZE, height);
+		uint32_t clear = packColor(uniforms.clearColor.r, uniforms.clearColor.g, uniforms.clearColor.b);
+		for (int y = ty0; y < ty1; y++)
+		{
+			fill(color.begin() + y * pitch + tx0, color.begin() + y * pitch + tx1, clear);
+			fill(depth.begin() + y * pitch + tx0, depth.begin() + y * pitch + tx1, 1.0f);
+		}
+		for (int worker = 0; worker < threadCount; worker++)
+		{
+			for (uint32_t index : bins[worker][tile])
+			{
+				rasterTriangle(setups[worker][index], tx0, ty0, tx1, ty1, uniforms, texture);
+			}
+		}
+	}
+
+	static uint32_t packColor(float r, float g, float b)
+	{
+		auto toByte = [](float c) { return (uint32_t)(min(max(c, 0.0f), 1.0f) * 255.0f + 0.5f); };
+		return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | 0xFF000000u;
+	}
+
+	void rasterTriangle(const RasterTriangle& tri, int tx0, int ty0, int tx1, int ty1, const SoftwareUniforms& uniforms, const SoftwareTexture& texture)
+	{
+		int x0 = max(tri.minX, tx0), x1 = min(tri.maxX + 1, tx1);
+		int y0 = max(tri.minY, ty0), y1 = min(tri.maxY + 1, ty1);
+		if (x0 >= x1 || y0 >= y1) return;
+		// Blocos alinhados em 8 dentro do tile
+		x0 &= ~7;
+		const F8 laneOffsets = F8(_mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f), _mm_setr_ps(4.5f, 5.5f, 6.5f, 7.5f));
+		for (int y = y0; y < y1; y++)
+		{
+			F8 py((float)y + 0.5f);
+			for (int x = x0; x < x1; x += 8)
+			{
+				F8 px = F8((float)x) + laneOffsets;
+				F8 mask = cmplt8(px, F8((float)x1));
+				F8 e[3];
+				for (int k = 0; k < 3; k++)
+				{
+					e[k] = F8(tri.A[k]) * px + F8(tri.B[k]) * py + F8(tri.C[k]);
+					mask = mask & (tri.topLeft[k] ? cmpge8(e[k], F8(0.0f)) : cmpgt8(e[k], F8(0.0f)));
+				}
+				if (!movemask8(mask)) continue;
+
+				F8 invArea(tri.invArea);
+				F8 l0 = e[0] * invArea, l1 = e[1] * invArea, l2 = e[2] * invArea;
+				F8 z = l0 * F8(tri.z[0]) + l1 * F8(tri.z[1]) + l2 * F8(tri.z[2]);
+				float* depthRow = &depth[y * pitch + x];
+				F8 oldDepth = F8::load(depthRow);
+				mask = mask & cmplt8(z, oldDepth);
+				int bits = movemask8(mask);
+				if (!bits) continue;
+				select8(mask, z, oldDepth).store(depthRow);
+
+				F8 w = F8(1.0f) / (l0 * F8(tri.invW[0]) + l1 * F8(tri.invW[1]) + l2 * F8(tri.invW[2]));
+				F8 attributes[ATTRIBUTE_COUNT];
+				for (int i = 0; i < ATTRIBUTE_COUNT; i++)
+				{
+					attributes[i] = (l0 * F8(tri.attributes[0][i]) + l1 * F8(tri.attributes[1][i]) + l2 * F8(tri.attributes[2][i])) * w;
+				}
+				shade(attributes, bits, &color[y * pitch + x], uniforms, texture);
+			}
+		}
+	}
+
+	static void sampleBilinear(const SoftwareTexture& texture, float u, float v, float* rgb)
+	{
+		if (!texture.data)
+		{
+			rgb[0] = rgb[1] = rgb[2] = 1.0f;
+			return;
+		}
+		// GL_REPEAT + GL_LINEAR; a linha 0 da imagem corresponde a t = 0
+		float fx = u * texture.width - 0.5f;
+		float fy = v * texture.height - 0.5f;
+		float floorX = floor(fx), floorY = floor(fy);
+		float ax = fx - floorX, ay = fy - floorY;
+		int ix = (int)floorX, iy = (int)floorY;
+		auto wrap = [](int i, int n) { i %= n; return i < 0 ? i + n : i; };
+		int xs[2] = { wrap(ix, texture.width), wrap(ix + 1, texture.width) };
+		int ys[2] = { wrap(iy, texture.height), wrap(iy + 1, texture.height) };
+		float weights[4] = { (1 - ax) * (1 - ay), ax * (1 - ay), (1 - ax) * ay, ax * ay };
+		rgb[0] = rgb[1] = rgb[2] = 0.0f;
+		for (int s = 0; s < 4; s++)
+		{
+			const unsigned char* texel = texture.data + (ys[s / 2] * texture.width + xs[s % 2]) * texture.channels;
+			for (int c = 0; c < 3; c++) rgb[c] += weights[s] * texel[c];
+		}
+		for (int c = 0; c < 3; c++) rgb[c] *= 1.0f / 255.0f;
+	}
+
+	// sprite.fs para 8 fragmentos; bits indica as lanes cobertas
+	static void shade(const F8* attributes, int bits, uint32_t* out, const SoftwareUniforms& uniforms, const SoftwareTexture& texture)
+	{
+		F8 nx = attributes[2], ny = attributes[3], nz = attributes[4];
+		F8 invN = F8(1.0f) / sqrt8(nx * nx + ny * ny + nz * nz);
+		nx = nx * invN; ny = ny * invN; nz = nz * invN;
+
+		F8 lx = F8(uniforms.lightPosition.x) - attributes[5];
+		F8 ly = F8(uniforms.lightPosition.y) - attributes[6];
+		F8 lz = F8(uniforms.lightPosition.z) - attributes[7];
+		F8 invL = F8(1.0f) / sqrt8(lx * lx + ly * ly + lz * lz);
+		lx = lx * invL; ly = ly * invL; lz = lz * invL;
+		F8 nDotL = nx * lx + ny * ly + nz * lz;
+		F8 diff = max8(nDotL, F8(0.0f));
+
+		F8 vx = F8(uniforms.cameraPos.x) - attributes[5];
+		F8 vy = F8(uniforms.cameraPos.y) - attributes[6];
+		F8 vz = F8(uniforms.cameraPos.z) - attributes[7];
+		F8 invV = F8(1.0f) / sqrt8(vx * vx + vy * vy + vz * vz);
+		vx = vx * invV; vy = vy * invV; vz = vz * invV;
+
+		// reflect(-L, N) = 2 dot(N, L) N - L
+		F8 twoNDotL = nDotL + nDotL;
+		F8 rx = twoNDotL * nx - lx, ry = twoNDotL * ny - ly, rz = twoNDotL * nz - lz;
+		F8 invR = F8(1.0f) / sqrt8(rx * rx + ry * ry + rz * rz);
+		F8 spec = pow8(max8((rx * vx + ry * vy + rz * vz) * invR, F8(0.0f)), uniforms.q);
+
+		float u[8], v[8], tex[3][8];
+		attributes[0].store(u);
+		attributes[1].store(v);
+		for (int lane = 0; lane < 8; lane++)
+		{
+			float rgb[3] = { 0.0f, 0.0f, 0.0f };
+			if (bits & (1 << lane)) sampleBilinear(texture, u[lane], v[lane], rgb);
+			tex[0][lane] = rgb[0];
+			tex[1][lane] = rgb[1];
+			tex[2][lane] = rgb[2];
+		}
+
+		float channels[3][8];
+		for (int c = 0; c < 3; c++)
+		{
+			F8 light(uniforms.lightColor[c]);
+			F8 ambientDiffuse = F8(uniforms.ka[c]) * light + F8(uniforms.kd[c]) * diff * light;
+			F8 result = ambientDiffuse * F8::load(tex[c]) + F8(uniforms.ks[c]) * spec * light;
+			result = min8(max8(result, F8(0.0f)), F8(1.0f)) * F8(255.0f) + F8(0.5f);
+			result.store(channels[c]);
+		}
+		for (int lane = 0; lane < 8; lane++)
+		{
+			if (!(bits & (1 << lane))) continue;
+			out[lane] = (uint32_t)channels[0][lane] | ((uint32_t)channels[1][lane] << 8) | ((uint32_t)channels[2][lane] << 16) | 0xFF000000u;
+		}
+	}
+};
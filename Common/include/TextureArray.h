@@ -0,0 +1,124 @@
+// Junta varias texturas em um GL_TEXTURE_2D_ARRAY, uma por camada, para que objetos com
+// materiais diferentes saiam na mesma chamada de desenho: o shader recebe o indice da camada
+// por instancia e amostra com texture(sampler2DArray, vec3(uv, camada)).
+// Todas as camadas tem o mesmo tamanho (o da primeira textura); as de outro tamanho sao
+// reamostradas (bilinear) na carga, com um aviso.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+
+//GLAD
+#include <glad/glad.h>
+
+#include "stb_image.h"
+
+using namespace std;
+
+class TextureArray
+{
+public:
+	GLuint ID = 0;
+	int width = 0, height = 0;
+
+	// Devolve a camada da textura (a mesma se o arquivo ja foi adicionado) ou -1 se falhar
+	int add(const string& path)
+	{
+		auto found = layerByPath.find(path);
+		if (found != layerByPath.end()) return found->second;
+		int imageWidth, imageHeight, channels;
+		unsigned char* data = stbi_load(path.c_str(), &imageWidth, &imageHeight, &channels, 4);
+		if (!data)
+		{
+			cout << "Failed to load texture " << path << endl;
+			return -1;
+		}
+		int layer = add(data, imageWidth, imageHeight);
+		stbi_image_free(data);
+		if (layer != 0 && (imageWidth != width || imageHeight != height))
+		{
+			cout << path << ": " << imageWidth << "x" << imageHeight << " resampled to " << width << "x" << height << endl;
+		}
+		layerByPath[path] = layer;
+		return layer;
+	}
+
+	// Pixels RGBA8; a copia fica na CPU ate o upload
+	int add(const unsigned char* rgba, int imageWidth, int imageHeight)
+	{
+		if (layers.empty())
+		{
+			width = imageWidth;
+			height = imageHeight;
+		}
+		if (imageWidth == width && imageHeight == height)
+		{
+			layers.emplace_back(rgba, rgba + (size_t)width * height * 4);
+		}
+		else
+		{
+			layers.push_back(resample(rgba, imageWidth, imageHeight));
+		}
+		return (int)layers.size() - 1;
+	}
+
+	int layerCount() const { return (int)layers.size(); }
+
+	// Cria a textura com todas as camadas e gera os mipmaps; libera as copias da CPU
+	void upload()
+	{
+		glGenTextures(1, &ID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, ID);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, (GLsizei)layers.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		for (size_t layer = 0; layer < layers.size(); layer++)
+		{
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint)layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, layers[layer].data());
+		}
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		layers.clear();
+		layers.shrink_to_fit();
+	}
+
+	void release()
+	{
+		glDeleteTextures(1, &ID);
+		ID = 0;
+	}
+
+private:
+	vector<vector<unsigned char>> layers;
+	map<string, int> layerByPath;
+
+	vector<unsigned char> resample(const unsigned char* rgba, int imageWidth, int imageHeight) const
+	{
+		vector<unsigned char> out((size_t)width * height * 4);
+		for (int y = 0; y < height; y++)
+		{
+			float sy = max(0.0f, (y + 0.5f) * imageHeight / height - 0.5f);
+			int y0 = min((int)sy, imageHeight - 1), y1 = min(y0 + 1, imageHeight - 1);
+			float fy = sy - y0;
+			for (int x = 0; x < width; x++)
+			{
+				float sx = max(0.0f, (x + 0.5f) * imageWidth / width - 0.5f);
+				int x0 = min((int)sx, imageWidth - 1), x1 = min(x0 + 1, imageWidth - 1);
+				float fx = sx - x0;
+				for (int c = 0; c < 4; c++)
+				{
+					float top = rgba[((size_t)y0 * imageWidth + x0) * 4 + c] * (1.0f - fx) + rgba[((size_t)y0 * imageWidth + x1) * 4 + c] * fx;
+					float bottom = rgba[((size_t)y1 * imageWidth + x0) * 4 + c] * (1.0f - fx) + rgba[((size_t)y1 * imageWidth + x1) * 4 + c] * fx;
+					out[((size_t)y * width + x) * 4 + c] = (unsigned char)(top * (1.0f - fy) + bottom * fy + 0.5f);
+				}
+			}
+		}
+		return out;
+	}
+};
@@ -0,0 +1,337 @@
+// Atualizacao de transformacoes em lote para muitos objetos.
+// Entrada em SoA (posicao, rotacao em quaternion, escala e AABB local); em uma unica passada o
+// kernel compoe T * R * S na matriz de mundo, multiplica pela view-projection e leva a AABB
+// para o espaco do mundo (metodo de Arvo). Ha versoes escalar, SSE (4 objetos por iteracao) e
+// AVX2 com FMA (8 objetos); a melhor suportada pela CPU e escolhida em tempo de execucao.
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+using namespace std;
+
+#if defined(_MSC_VER)
+#define TRANSFORM_AVX2_TARGET
+#else
+#define TRANSFORM_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+struct TransformBatch
+{
+	vector<float> px, py, pz;
+	vector<float> qx, qy, qz, qw;
+	vector<float> sx, sy, sz;
+	// AABB local como centro e meia-extensao
+	vector<float> cx, cy, cz, ex, ey, ez;
+
+	size_t size() const { return px.size(); }
+
+	void resize(size_t count)
+	{
+		for (vector<float>* v : { &px, &py, &pz, &qx, &qy, &qz, &sx, &sy, &sz, &cx, &cy, &cz, &ex, &ey, &ez })
+		{
+			v->resize(count, 0.0f);
+		}
+		qw.resize(count, 1.0f);
+	}
+
+	void set(size_t i, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale,
+		const glm::vec3& aabbMin, const glm::vec3& aabbMax)
+	{
+		px[i] = position.x; py[i] = position.y; pz[i] = position.z;
+		qx[i] = rotation.x; qy[i] = rotation.y; qz[i] = rotation.z; qw[i] = rotation.w;
+		sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+		glm::vec3 center = (aabbMin + aabbMax) * 0.5f;
+		glm::vec3 extent = (aabbMax - aabbMin) * 0.5f;
+		cx[i] = center.x; cy[i] = center.y; cz[i] = center.z;
+		ex[i] = extent.x; ey[i] = extent.y; ez[i] = extent.z;
+	}
+};
+
+// Saidas opcionais: ponteiros nulos desligam a etapa correspondente
+struct TransformBatchOutputs
+{
+	// Matrizes de mundo; worldStride permite escrever direto dentro de structs maiores
+	glm::mat4* world = nullptr;
+	size_t worldStride = sizeof(glm::mat4);
+	glm::mat4* worldViewProjection = nullptr;
+	// AABB no espaco do mundo, em SoA
+	float* minX = nullptr; float* minY = nullptr; float* minZ = nullptr;
+	float* maxX = nullptr; float* maxY = nullptr; float* maxZ = nullptr;
+};
+
+enum class TransformKernel { Scalar, SSE, AVX2 };
+
+inline bool cpuHasAVX2()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+	if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// FMA3 veio junto com o AVX2 nas CPUs atuais, mas sao bits de CPUID separados
+inline bool cpuHasFMA()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool osxsave = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+	if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+	return (info[2] & (1 << 12)) != 0;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("fma");
+#else
+	return false;
+#endif
+}
+
+// O kernel AVX2 usa _mm256_fmadd_ps: precisa dos dois
+inline bool cpuHasTransformAVX2()
+{
+	return cpuHasAVX2() && cpuHasFMA();
+}
+
+inline TransformKernel bestTransformKernel()
+{
+	static const TransformKernel kernel = cpuHasTransformAVX2() ? TransformKernel::AVX2 : TransformKernel::SSE;
+	return kernel;
+}
+
+inline const char* transformKernelName(TransformKernel kernel)
+{
+	switch (kernel)
+	{
+	case TransformKernel::Scalar: return "scalar";
+	case TransformKernel::SSE: return "SSE";
+	default: return "AVX2";
+	}
+}
+
+inline glm::mat4& worldAt(const TransformBatchOutputs& out, size_t i)
+{
+	return *(glm::mat4*)((char*)out.world + i * out.worldStride);
+}
+
+inline void updateTransformsScalar(const TransformBatch& in, const glm::mat4& viewProjection,
+	const TransformBatchOutputs& out, size_t first, size_t last)
+{
+	for (size_t i = first; i < last; i++)
+	{
+		float x = in.qx[i], y = in.qy[i], z = in.qz[i], w = in.qw[i];
+		glm::mat4 m;
+		m[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y), 0) * in.sx[i];
+		m[1] = glm::vec4(2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x), 0) * in.sy[i];
+		m[2] = glm::vec4(2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y), 0) * in.sz[i];
+		m[3] = glm::vec4(in.px[i], in.py[i], in.pz[i], 1);
+		if (out.world) worldAt(out, i) = m;
+		if (out.worldViewProjection) out.worldViewProjection[i] = viewProjection * m;
+		if (out.minX)
+		{
+			glm::vec3 c = glm::vec3(m * glm::vec4(in.cx[i], in.cy[i], in.cz[i], 1.0f));
+			glm::vec3 e = glm::abs(glm::vec3(m[0])) * in.ex[i] + glm::abs(glm::vec3(m[1])) * in.ey[i] + glm::abs(glm::vec3(m[2])) * in.ez[i];
+			out.minX[i] = c.x - e.x; out.minY[i] = c.y - e.y; out.minZ[i] = c.z - e.z;
+			out.maxX[i] = c.x + e.x; out.maxY[i] = c.y + e.y; out.maxZ[i] = c.z + e.z;
+		}
+	}
+}
+
+// Grava 4 colunas em SoA (x, y, z, w de 4 objetos) como vec4 de cada objeto
+inline void storeColumns4(__m128 x, __m128 y, __m128 z, __m128 w, float* o0, float* o1, float* o2, float* o3)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(o0, x);
+	_mm_storeu_ps(o1, y);
+	_mm_storeu_ps(o2, z);
+	_mm_storeu_ps(o3, w);
+}
+
+inline __m128 abs4(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+inline void updateTransformsSSE(const TransformBatch& in, const glm::mat4& viewProjection,
+	const TransformBatchOutputs& out, size_t first, size_t last)
+{
+	size_t i = first;
+	for (; i + 4 <= last; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(&in.qx[i]), y = _mm_loadu_ps(&in.qy[i]), z = _mm_loadu_ps(&in.qz[i]), w = _mm_loadu_ps(&in.qw[i]);
+		__m128 sx = _mm_loadu_ps(&in.sx[i]), sy = _mm_loadu_ps(&in.sy[i]), sz = _mm_loadu_ps(&in.sz[i]);
+		__m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+		__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+		__m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+		__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+		// m[coluna][linha], cada elemento com 4 objetos
+		__m128 m[4][4];
+		m[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+		m[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+		m[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+		m[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+		m[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+		m[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+		m[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+		m[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+		m[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+		m[3][0] = _mm_loadu_ps(&in.px[i]);
+		m[3][1] = _mm_loadu_ps(&in.py[i]);
+		m[3][2] = _mm_loadu_ps(&in.pz[i]);
+		m[0][3] = m[1][3] = m[2][3] = zero;
+		m[3][3] = one;
+
+		if (out.world)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				storeColumns4(m[c][0], m[c][1], m[c][2], m[c][3],
+					&worldAt(out, i)[c][0], &worldAt(out, i + 1)[c][0], &worldAt(out, i + 2)[c][0], &worldAt(out, i + 3)[c][0]);
+			}
+		}
+		if (out.worldViewProjection)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				__m128 r[4];
+				for (int row = 0; row < 4; row++)
+				{
+					r[row] = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(_mm_set1_ps(viewProjection[0][row]), m[c][0]), _mm_mul_ps(_mm_set1_ps(viewProjection[1][row]), m[c][1])),
+						_mm_add_ps(_mm_mul_ps(_mm_set1_ps(viewProjection[2][row]), m[c][2]), _mm_mul_ps(_mm_set1_ps(viewProjection[3][row]), m[c][3])));
+				}
+				storeColumns4(r[0], r[1], r[2], r[3],
+					&out.worldViewProjection[i][c][0], &out.worldViewProjection[i + 1][c][0], &out.worldViewProjection[i + 2][c][0], &out.worldViewProjection[i + 3][c][0]);
+			}
+		}
+		if (out.minX)
+		{
+			__m128 cx = _mm_loadu_ps(&in.cx[i]), cy = _mm_loadu_ps(&in.cy[i]), cz = _mm_loadu_ps(&in.cz[i]);
+			__m128 ex = _mm_loadu_ps(&in.ex[i]), ey = _mm_loadu_ps(&in.ey[i]), ez = _mm_loadu_ps(&in.ez[i]);
+			float* mins[3] = { out.minX, out.minY, out.minZ };
+			float* maxs[3] = { out.maxX, out.maxY, out.maxZ };
+			for (int row = 0; row < 3; row++)
+			{
+				__m128 center = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][row], cx), _mm_mul_ps(m[1][row], cy)),
+					_mm_add_ps(_mm_mul_ps(m[2][row], cz), m[3][row]));
+				__m128 extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abs4(m[0][row]), ex), _mm_mul_ps(abs4(m[1][row]), ey)),
+					_mm_mul_ps(abs4(m[2][row]), ez));
+				_mm_storeu_ps(&mins[row][i], _mm_sub_ps(center, extent));
+				_mm_storeu_ps(&maxs[row][i], _mm_add_ps(center, extent));
+			}
+		}
+	}
+	updateTransformsScalar(in, viewProjection, out, i, last);
+}
+
+TRANSFORM_AVX2_TARGET inline __m256 abs8(__m256 v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+
+// Mesma coisa que storeColumns4, para 8 objetos (duas transposicoes 4x4)
+TRANSFORM_AVX2_TARGET inline void storeColumns8(__m256 x, __m256 y, __m256 z, __m256 w, float** outputs)
+{
+	storeColumns4(_mm256_castps256_ps128(x), _mm256_castps256_ps128(y), _mm256_castps256_ps128(z), _mm256_castps256_ps128(w),
+		outputs[0], outputs[1], outputs[2], outputs[3]);
+	storeColumns4(_mm256_extractf128_ps(x, 1), _mm256_extractf128_ps(y, 1), _mm256_extractf128_ps(z, 1), _mm256_extractf128_ps(w, 1),
+		outputs[4], outputs[5], outputs[6], outputs[7]);
+}
+
+TRANSFORM_AVX2_TARGET inline void updateTransformsAVX2(const TransformBatch& in, const glm::mat4& viewProjection,
+	const TransformBatchOutputs& out, size_t first, size_t last)
+{
+	size_t i = first;
+	for (; i + 8 <= last; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(&in.qx[i]), y = _mm256_loadu_ps(&in.qy[i]), z = _mm256_loadu_ps(&in.qz[i]), w = _mm256_loadu_ps(&in.qw[i]);
+		__m256 sx = _mm256_loadu_ps(&in.sx[i]), sy = _mm256_loadu_ps(&in.sy[i]), sz = _mm256_loadu_ps(&in.sz[i]);
+		__m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f), zero = _mm256_setzero_ps();
+		__m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+		__m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+		__m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+		__m256 m[4][4];
+		m[0][0] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+		m[0][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+		m[0][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+		m[1][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+		m[1][1] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+		m[1][2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+		m[2][0] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+		m[2][1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+		m[2][2] = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+		m[3][0] = _mm256_loadu_ps(&in.px[i]);
+		m[3][1] = _mm256_loadu_ps(&in.py[i]);
+		m[3][2] = _mm256_loadu_ps(&in.pz[i]);
+		m[0][3] = m[1][3] = m[2][3] = zero;
+		m[3][3] = one;
+
+		float* outputs[8];
+		if (out.world)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				for (int k = 0; k < 8; k++) outputs[k] = &worldAt(out, i + k)[c][0];
+				storeColumns8(m[c][0], m[c][1], m[c][2], m[c][3], outputs);
+			}
+		}
+		if (out.worldViewProjection)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				__m256 r[4];
+				for (int row = 0; row < 4; row++)
+				{
+					r[row] = _mm256_mul_ps(_mm256_set1_ps(viewProjection[3][row]), m[c][3]);
+					r[row] = _mm256_fmadd_ps(_mm256_set1_ps(viewProjection[2][row]), m[c][2], r[row]);
+					r[row] = _mm256_fmadd_ps(_mm256_set1_ps(viewProjection[1][row]), m[c][1], r[row]);
+					r[row] = _mm256_fmadd_ps(_mm256_set1_ps(viewProjection[0][row]), m[c][0], r[row]);
+				}
+				for (int k = 0; k < 8; k++) outputs[k] = &out.worldViewProjection[i + k][c][0];
+				storeColumns8(r[0], r[1], r[2], r[3], outputs);
+			}
+		}
+		if (out.minX)
+		{
+			__m256 cx = _mm256_loadu_ps(&in.cx[i]), cy = _mm256_loadu_ps(&in.cy[i]), cz = _mm256_loadu_ps(&in.cz[i]);
+			__m256 ex = _mm256_loadu_ps(&in.ex[i]), ey = _mm256_loadu_ps(&in.ey[i]), ez = _mm256_loadu_ps(&in.ez[i]);
+			float* mins[3] = { out.minX, out.minY, out.minZ };
+			float* maxs[3] = { out.maxX, out.maxY, out.maxZ };
+			for (int row = 0; row < 3; row++)
+			{
+				__m256 center = _mm256_fmadd_ps(m[0][row], cx, _mm256_fmadd_ps(m[1][row], cy, _mm256_fmadd_ps(m[2][row], cz, m[3][row])));
+				__m256 extent = _mm256_fmadd_ps(abs8(m[0][row]), ex, _mm256_fmadd_ps(abs8(m[1][row]), ey, _mm256_mul_ps(abs8(m[2][row]), ez)));
+				_mm256_storeu_ps(&mins[row][i], _mm256_sub_ps(center, extent));
+				_mm256_storeu_ps(&maxs[row][i], _mm256_add_ps(center, extent));
+			}
+		}
+	}
+	updateTransformsScalar(in, viewProjection, out, i, last);
+}
+
+// Processa os objetos [first, last); intervalos disjuntos podem rodar em threads diferentes
+inline void updateTransforms(const TransformBatch& in, const glm::mat4& viewProjection, const TransformBatchOutputs& out,
+	size_t first, size_t last, TransformKernel kernel = bestTransformKernel())
+{
+	switch (kernel)
+	{
+	case TransformKernel::Scalar: updateTransformsScalar(in, viewProjection, out, first, last); break;
+	case TransformKernel::SSE: updateTransformsSSE(in, viewProjection, out, first, last); break;
+	case TransformKernel::AVX2: updateTransformsAVX2(in, viewProjection, out, first, last); break;
+	}
+}
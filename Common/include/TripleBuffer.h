@@ -0,0 +1,50 @@
+// Troca lock-free de dados entre um produtor e um consumidor (por exemplo simulacao -> render).
+// Sao tres copias de T: o produtor escreve sempre na sua, o consumidor le sempre a sua, e a
+// terceira fica no meio. publish() troca a copia do produtor com a do meio e consume() troca a
+// do consumidor com a do meio se ela tiver algo novo. Nenhum lado espera pelo outro: o
+// consumidor sempre ve o snapshot completo mais recente e snapshots intermediarios sao
+// descartados se o produtor for mais rapido.
+
+#pragma once
+
+#include <atomic>
+
+template<typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() : middle(2) {}
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Copia do produtor; so pode ser usada pela thread que chama publish()
+	T& writeBuffer() { return buffers[writeIndex]; }
+
+	// Entrega o que foi escrito em writeBuffer() e pega outra copia para o proximo snapshot
+	void publish()
+	{
+		int previous = middle.exchange(writeIndex | NEW_DATA, std::memory_order_acq_rel);
+		writeIndex = previous & INDEX_MASK;
+	}
+
+	// Pega o snapshot mais recente, se houver um novo desde a ultima chamada
+	bool consume()
+	{
+		if (!(middle.load(std::memory_order_relaxed) & NEW_DATA)) return false;
+		int previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+		readIndex = previous & INDEX_MASK;
+		return true;
+	}
+
+	// Copia do consumidor; valida ate o proximo consume()
+	const T& readBuffer() const { return buffers[readIndex]; }
+
+private:
+	static const int INDEX_MASK = 3;
+	static const int NEW_DATA = 4;
+
+	T buffers[3];
+	std::atomic<int> middle;
+	int writeIndex = 0;
+	int readIndex = 1;
+};
@@ -0,0 +1,223 @@
+// Solido + arestas + vertices em uma passada so (Baerentzen et al., "Single-pass wireframe
+// rendering"): o geometry shader calcula em pixels a altura de cada vertice do triangulo ate a
+// aresta oposta e passa como atributo noperspective (um componente por vertice, zero nos outros),
+// entao no fragment o menor componente e a distancia ate a aresta mais proxima. As posicoes dos
+// cantos na tela vao flat e a distancia ate elas desenha os vertices como discos. Substitui o
+// segundo glDrawArrays(GL_POINTS) dos modulos, que processava todos os vertices de novo, e
+// funciona com qualquer largura de linha (no core profile glLineWidth > 1 nao e garantido).
+// Linhas e discos so aparecem dentro dos triangulos: na silhueta ficam com metade da largura.
+// Mesmo layout de vertice dos modulos: posicao (location 0) e cor (location 1), uniform model.
+
+#pragma once
+
+#include <iostream>
+#include <functional>
+
+//GLAD
+#include <glad/glad.h>
+
+//GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+using namespace std;
+
+#ifndef GL_GEOMETRY_SHADER
+#define GL_GEOMETRY_SHADER 0x8DD9
+#endif
+
+// Bits de overlayMode
+const int WIREFRAME_EDGES = 1;
+const int WIREFRAME_VERTICES = 2;
+
+const GLchar* const wireframeVertexSource = "#version 450\n"
+"layout (location = 0) in vec3 position;\n"
+"layout (location = 1) in vec3 color;\n"
+"uniform mat4 model;\n"
+"out vec4 vertexColor;\n"
+"void main()\n"
+"{\n"
+"gl_Position = model * vec4(position, 1.0);\n"
+"vertexColor = vec4(color, 1.0);\n"
+"}\0";
+
+const GLchar* const wireframeGeometrySource = "#version 450\n"
+"layout (triangles) in;\n"
+"layout (triangle_strip, max_vertices = 3) out;\n"
+"uniform vec2 viewportSize;\n"
+"in vec4 vertexColor[];\n"
+"out vec4 finalColor;\n"
+"noperspective out vec3 edgeDistance;\n"
+"flat out vec2 corner0;\n"
+"flat out vec2 corner1;\n"
+"flat out vec2 corner2;\n"
+"void main()\n"
+"{\n"
+"vec2 p[3];\n"
+"for (int i = 0; i < 3; i++) p[i] = (gl_in[i].gl_Position.xy / gl_in[i].gl_Position.w * 0.5 + 0.5) * viewportSize;\n"
+// Dobro da area na tela dividido pela aresta oposta = altura do vertice
+"float area = abs((p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x));\n"
+"vec3 heights = vec3(area / length(p[2] - p[1]), area / length(p[2] - p[0]), area / length(p[1] - p[0]));\n"
+"for (int i = 0; i < 3; i++)\n"
+"{\n"
+"gl_Position = gl_in[i].gl_Position;\n"
+"finalColor = vertexColor[i];\n"
+"edgeDistance = vec3(0.0);\n"
+"edgeDistance[i] = heights[i];\n"
+"corner0 = p[0];\n"
+"corner1 = p[1];\n"
+"corner2 = p[2];\n"
+"EmitVertex();\n"
+"}\n"
+"EndPrimitive();\n"
+"}\0";
+
+const GLchar* const wireframeFragmentSource = "#version 450\n"
+"in vec4 finalColor;\n"
+"noperspective in vec3 edgeDistance;\n"
+"flat in vec2 corner0;\n"
+"flat in vec2 corner1;\n"
+"flat in vec2 corner2;\n"
+"uniform int overlayMode;\n"
+"uniform float lineWidth;\n"
+"uniform float pointSize;\n"
+"uniform vec3 lineColor;\n"
+"uniform vec3 pointColor;\n"
+"out vec4 color;\n"
+"void main()\n"
+"{\n"
+"vec3 result = finalColor.rgb;\n"
+// Borda suavizada em 1 pixel
+"float edge = min(min(edgeDistance.x, edgeDistance.y), edgeDistance.z);\n"
+"if ((overlayMode & 1) != 0) result = mix(lineColor, result, smoothstep(lineWidth * 0.5 - 0.5, lineWidth * 0.5 + 0.5, edge));\n"
+"float corner = min(min(distance(gl_FragCoord.xy, corner0), distance(gl_FragCoord.xy, corner1)), distance(gl_FragCoord.xy, corner2));\n"
+"if ((overlayMode & 2) != 0) result = mix(pointColor, result, smoothstep(pointSize * 0.5 - 0.5, pointSize * 0.5 + 0.5, corner));\n"
+"color = vec4(result, finalColor.a);\n"
+"}\n\0";
+
+inline GLuint compileWireframeStage(GLenum type, const GLchar* source, const char* name)
+{
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, NULL);
+	glCompileShader(shader);
+	GLint success;
+	GLchar infoLog[512];
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(shader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::" << name << "::COMPILATION_FAILED\n" << infoLog << endl;
+	}
+	return shader;
+}
+
+class WireframeOverlay
+{
+public:
+	GLuint program = 0;
+	GLint modelLoc = -1;
+	// Em pixels
+	float lineWidth = 3.0f;
+	float pointSize = 20.0f;
+	glm::vec3 lineColor = glm::vec3(0.05f);
+	glm::vec3 pointColor = glm::vec3(0.2f);
+	int mode = WIREFRAME_EDGES | WIREFRAME_VERTICES;
+
+	void init()
+	{
+		GLuint vertex = compileWireframeStage(GL_VERTEX_SHADER, wireframeVertexSource, "VERTEX");
+		GLuint geometry = compileWireframeStage(GL_GEOMETRY_SHADER, wireframeGeometrySource, "GEOMETRY");
+		GLuint fragment = compileWireframeStage(GL_FRAGMENT_SHADER, wireframeFragmentSource, "FRAGMENT");
+		program = glCreateProgram();
+		glAttachShader(program, vertex);
+		glAttachShader(program, geometry);
+		glAttachShader(program, fragment);
+		glLinkProgram(program);
+		GLint success;
+		GLchar infoLog[512];
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			glGetProgramInfoLog(program, 512, NULL, infoLog);
+			cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << endl;
+		}
+		glDeleteShader(vertex);
+		glDeleteShader(geometry);
+		glDeleteShader(fragment);
+		modelLoc = glGetUniformLocation(program, "model");
+		viewportLoc = glGetUniformLocation(program, "viewportSize");
+		modeLoc = glGetUniformLocation(program, "overlayMode");
+		lineWidthLoc = glGetUniformLocation(program, "lineWidth");
+		pointSizeLoc = glGetUniformLocation(program, "pointSize");
+		lineColorLoc = glGetUniformLocation(program, "lineColor");
+		pointColorLoc = glGetUniformLocation(program, "pointColor");
+	}
+
+	// Com o programa em uso; viewport em pixels (o do framebuffer)
+	void applyUniforms(int viewportWidth, int viewportHeight) const
+	{
+		glUniform2f(viewportLoc, (float)viewportWidth, (float)viewportHeight);
+		glUniform1i(modeLoc, mode);
+		glUniform1f(lineWidthLoc, lineWidth);
+		glUniform1f(pointSizeLoc, pointSize);
+		glUniform3f(lineColorLoc, lineColor.r, lineColor.g, lineColor.b);
+		glUniform3f(pointColorLoc, pointColor.r, pointColor.g, pointColor.b);
+	}
+
+	void release()
+	{
+		glDeleteProgram(program);
+		program = 0;
+	}
+
+private:
+	GLint viewportLoc = -1, modeLoc = -1, lineWidthLoc = -1, pointSizeLoc = -1, lineColorLoc = -1, pointColorLoc = -1;
+};
+
+// Vertices por segundo de uma medicao: vertexCount vertices processados em ms
+inline double verticesPerSecond(double vertexCount, double ms)
+{
+	return ms > 0.0 ? vertexCount * 1000.0 / ms : 0.0;
+}
+
+// Tempo de GPU de draw (GL_TIME_ELAPSED, espera o resultado); para medicoes pontuais, nao por frame
+inline double measureGpuMs(const function<void()>& draw)
+{
+	GLuint query;
+	glGenQueries(1, &query);
+	glFinish();
+	glBeginQuery(GL_TIME_ELAPSED, query);
+	draw();
+	glEndQuery(GL_TIME_ELAPSED);
+	GLuint64 elapsed = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+	glDeleteQueries(1, &query);
+	return elapsed / 1e6;
+}
+
+// Desenha o VAO ligado instances vezes (instanciado, para o custo de CPU nao entrar) pelos dois
+// caminhos: GL_TRIANGLES + GL_POINTS com o programa do modulo e a passada unica do overlay.
+// Imprime o tempo de GPU e os vertices da malha por segundo; os dois draws processam cada vertice duas
+// vezes no vertex shader, o overlay uma vez mais uma invocacao do geometry shader por triangulo.
+// Troca o programa direto no GL: quem usa GLStateCache deve chamar invalidate() depois.
+inline void compareOverlayThroughput(GLuint program, GLint modelLoc, const WireframeOverlay& overlay, const glm::mat4& model,
+	GLsizei vertexCount, int viewportWidth, int viewportHeight, int instances = 10000)
+{
+	glUseProgram(program);
+	glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+	double twoDrawsMs = measureGpuMs([vertexCount, instances]() {
+		glDrawArraysInstanced(GL_TRIANGLES, 0, vertexCount, instances);
+		glDrawArraysInstanced(GL_POINTS, 0, vertexCount, instances);
+	});
+	glUseProgram(overlay.program);
+	glUniformMatrix4fv(overlay.modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+	overlay.applyUniforms(viewportWidth, viewportHeight);
+	double singlePassMs = measureGpuMs([vertexCount, instances]() {
+		glDrawArraysInstanced(GL_TRIANGLES, 0, vertexCount, instances);
+	});
+	double meshVertices = (double)vertexCount * instances;
+	cout << instances << " x " << vertexCount << " vertices: two draws " << twoDrawsMs << " ms ("
+		<< verticesPerSecond(meshVertices, twoDrawsMs) / 1e6 << " M mesh vertices/s, " << verticesPerSecond(2.0 * meshVertices, twoDrawsMs) / 1e6
+		<< " M vertex invocations/s), single pass " << singlePassMs << " ms (" << verticesPerSecond(meshVertices, singlePassMs) / 1e6
+		<< " M mesh vertices/s), " << (singlePassMs > 0.0 ? twoDrawsMs / singlePassMs : 0.0) << "x" << endl;
+}
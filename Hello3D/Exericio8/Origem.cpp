@@ -24,6 +24,9 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Cache de estado do OpenGL
+#include "GLStateCache.h"
+
 
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
@@ -101,7 +104,9 @@ int main()
 	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
+	// Binds e estado fixo do loop passam pelo cache, que descarta as chamadas redundantes
+	GLStateCache glState;
+	glState.viewport(0, 0, width, height);
 
 
 	// Compilando e buildando o programa de shader
@@ -111,7 +116,7 @@ int main()
 	GLuint VAO = setupGeometry();
 
 
-	glUseProgram(shaderID);
+	glState.useProgram(shaderID);
 
 	glm::mat4 model = glm::mat4(1); //matriz identidade;
 	GLint modelLoc = glGetUniformLocation(shaderID, "model");
@@ -119,7 +124,7 @@ int main()
 	model = glm::rotate(model, /*(GLfloat)glfwGetTime()*/glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 	glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
 
-	glEnable(GL_DEPTH_TEST);
+	glState.enable(GL_DEPTH_TEST);
 
 
 	// Loop da aplicação - "game loop"
@@ -129,11 +134,11 @@ int main()
 		glfwPollEvents();
 
 		// Limpa o buffer de cor
-		glClearColor(1.0f, 1.0f, 1.0f, 1.0f); //cor de fundo
+		glState.clearColor(1.0f, 1.0f, 1.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glState.lineWidth(10);
+		glState.pointSize(20);
 
 		float angle = (GLfloat)glfwGetTime();
 
@@ -158,17 +163,18 @@ int main()
 		// Chamada de desenho - drawcall
 		// Poligono Preenchido - GL_TRIANGLES
 		
-		glBindVertexArray(VAO);
+		glState.bindVertexArray(VAO);
 		glDrawArrays(GL_TRIANGLES, 0, 18);
 
 		// Chamada de desenho - drawcall
 		// CONTORNO - GL_LINE_LOOP
 		
 		glDrawArrays(GL_POINTS, 0, 18);
-		glBindVertexArray(0);
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		glState.endFrame();
+		glState.reportIfDue();
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
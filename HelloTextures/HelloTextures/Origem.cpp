@@ -22,6 +22,15 @@ using namespace std;
 //stb_image
 #include "stb_image.h"
 
+// Renderizacao sob demanda
+#include "FrameScheduler.h"
+
+// Cache de estado do OpenGL
+#include "GLStateCache.h"
+
+// Arquivo de assets empacotados
+#include "AssetArchive.h"
+
 
 struct Vertex {
 	float x, y, z;
@@ -46,8 +55,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 int setupShader();
 int setupGeometry();
 int loadTexture(string path);
-string getTextureFileName(const string& filePath);
-vector<float> parseObjFile(const string& filename);
+string getTextureFileName(istream& file);
+vector<float> parseObjFile(istream& file);
+
+// Com assets.pak (AssetPacker HelloTextures/assets.pak --base HelloTextures HelloTextures/textures/suzanne/*)
+// OBJ, MTL e textura vem de um unico arquivo mapeado; sem ele, dos arquivos soltos
+const string archiveFile = "../assets.pak";
+AssetArchive archive;
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -89,6 +103,9 @@ float verticesQty;
 random_device rd;
 mt19937 gen(rd());
 uniform_real_distribution<float> dis(0.0f, 1.0f);
+// Limite usado quando o limitador esta ligado (tecla T); O alterna entre sob demanda e continuo
+const double FRAME_LIMIT_FPS = 30.0;
+FrameScheduler scheduler;
 // Função MAIN
 int main()
 {
@@ -102,6 +119,9 @@ int main()
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 
+	// Callbacks de refresh e tamanho da janela marcam o frame como sujo
+	scheduler.attach(window);
+
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
 	{
@@ -118,35 +138,47 @@ int main()
 	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
+	// Binds e estado fixo do loop passam pelo cache, que descarta as chamadas redundantes
+	GLStateCache glState;
+	glState.viewport(0, 0, width, height);
 
+	cout << (archive.open(archiveFile) ? "Loading assets from " + archiveFile : string("Loading loose asset files")) << endl;
 	GLuint shaderID = setupShader();
-	string fileName = "../textures/suzanne/SuzanneTriTextured.mtl";
-  string textureFileName = getTextureFileName(fileName);
+	AssetData mtl;
+	readAsset(archive, "../textures/suzanne/SuzanneTriTextured.mtl", mtl);
+	MemoryStreamBuffer mtlBuffer(mtl.data, mtl.size);
+	istream mtlStream(&mtlBuffer);
+	string textureFileName = getTextureFileName(mtlStream);
 	GLuint textureId = loadTexture(textureFileName);
 	GLuint VAO = setupGeometry();
 
-	glUseProgram(shaderID);
+	glState.useProgram(shaderID);
 
 	glm::mat4 model = glm::mat4(1); //matriz identidade;
 	GLint modelLoc = glGetUniformLocation(shaderID, "model");
 	model = glm::rotate(model, /*(GLfloat)glfwGetTime()*/glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 	glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
 
-	glEnable(GL_DEPTH_TEST);
+	glState.enable(GL_DEPTH_TEST);
 
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
-		glfwPollEvents();
+		// Sem rotacao e sem input o frame seria igual ao anterior: bloqueia ate o proximo evento
+		scheduler.waitEvents();
+		scheduler.setAnimating(rotateX || rotateY || rotateZ);
+		scheduler.reportIfDue();
+		glState.reportIfDue();
+		if (!scheduler.shouldRender()) continue;
+		if (scheduler.dirtyFlags() & DIRTY_WINDOW) glState.viewport(0, 0, scheduler.framebufferWidth, scheduler.framebufferHeight);
 
 		// Limpa o buffer de cor
-		glClearColor(1.0f, 1.0f, 1.0f, 1.0f); //cor de fundo
+		glState.clearColor(1.0f, 1.0f, 1.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glState.lineWidth(10);
+		glState.pointSize(20);
 
 		float angle = (GLfloat)glfwGetTime();
 
@@ -170,19 +202,17 @@ int main()
 
 		glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textureId);
+		glState.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, textureId);
 
 		// Chamada de desenho - drawcall
 		// Poligono Preenchido - GL_TRIANGLES
-		glBindVertexArray(VAO);
+		glState.bindVertexArray(VAO);
 		glDrawArrays(GL_TRIANGLES, 0, verticesQty);
 
-		glBindVertexArray(0);
-		glBindTexture(GL_TEXTURE_2D, 0);
-
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		scheduler.frameRendered();
+		glState.endFrame();
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
@@ -199,8 +229,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GL_TRUE);
 
+	if (action == GLFW_PRESS) scheduler.markDirty(DIRTY_INPUT);
+	if (key == GLFW_KEY_O && action == GLFW_PRESS) scheduler.onDemand = !scheduler.onDemand;
+	if (key == GLFW_KEY_T && action == GLFW_PRESS) scheduler.frameLimit = scheduler.frameLimit > 0.0 ? 0.0 : FRAME_LIMIT_FPS;
+
 	if (key == GLFW_KEY_X && action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_TRANSFORM);
 		rotateX = true;
 		rotateY = false;
 		rotateZ = false;
@@ -208,6 +243,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 	if (key == GLFW_KEY_Y && action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_TRANSFORM);
 		rotateX = false;
 		rotateY = true;
 		rotateZ = false;
@@ -215,6 +251,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 	if (key == GLFW_KEY_Z && action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_TRANSFORM);
 		rotateX = false;
 		rotateY = false;
 		rotateZ = true;
@@ -280,7 +317,11 @@ int setupGeometry()
 	// sequencial, já visando mandar para o VBO (Vertex Buffer Objects)
 	// Cada atributo do vértice (coordenada, cores, coordenadas de textura, normal, etc)
 	// Pode ser arazenado em um VBO único ou em VBOs separados
-	vector<float> vertices = parseObjFile("../textures/suzanne/SuzanneTriTextured.obj");
+	AssetData obj;
+	readAsset(archive, "../textures/suzanne/SuzanneTriTextured.obj", obj);
+	MemoryStreamBuffer objBuffer(obj.data, obj.size);
+	istream objStream(&objBuffer);
+	vector<float> vertices = parseObjFile(objStream);
 	verticesQty = vertices.size() / 8;
 
 	GLuint VBO, VAO;
@@ -331,9 +372,8 @@ int setupGeometry()
 	return VAO;
 }
 
-vector<float> parseObjFile(const string& filename)
+vector<float> parseObjFile(istream& file)
 {
-	ifstream file(filename);
 	string line;
 	while (getline(file, line)) {
 		if (line.empty() || line[0] == '#') {
@@ -417,7 +457,8 @@ int loadTexture(string path)
 
 	//Carregamento da imagem
 	int width, height, nrChannels;
-	unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+	AssetData asset;
+	unsigned char* data = readAsset(archive, path, asset) ? stbi_load_from_memory(asset.data, (int)asset.size, &width, &height, &nrChannels, 0) : nullptr;
 	bool isPng = nrChannels != 3;
 	if (!data) {
 		std::cout << "Failed to load texture" << endl;
@@ -434,9 +475,8 @@ int loadTexture(string path)
 	return texID;
 }
 
-string getTextureFileName(const string& filePath)
+string getTextureFileName(istream& file)
 {
-    ifstream file(filePath);
     string line;
     string textureFileName;
 
@@ -447,6 +487,5 @@ string getTextureFileName(const string& filePath)
         }
     }
 
-    file.close();
     return textureFileName;
 }
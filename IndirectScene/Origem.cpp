@@ -0,0 +1,295 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "Shader.h"
+#include "stb_image.h"
+#include "GLExt.h"
+#include "ObjLoader.h"
+#include "MeshArena.h"
+#include "Frustum.h"
+#include "RingBuffer.h"
+#include "TransformBatch.h"
+#include "CameraController.h"
+#include "JobSystem.h"
+#include "TextureArray.h"
+
+using namespace std;
+
+// Mesmo layout std430 de ObjectData em scene.vs/cull.cs
+struct ObjectData {
+	glm::mat4 model;
+	glm::uvec4 info;
+};
+
+struct MeshInfo {
+	GLuint indexCount;
+	GLuint firstIndex;
+	GLint baseVertex;
+	GLuint padding;
+	glm::vec4 boundingSphere;
+};
+
+// Mesmo layout std430 de MaterialData em scene.fs; w de ks = expoente especular
+struct MaterialData {
+	glm::vec4 ka;
+	glm::vec4 kd;
+	glm::vec4 ks;
+};
+
+// Arquivos de cada tipo de objeto da cena (malha, material e textura)
+struct SceneMesh {
+	string objFile;
+	string mtlFile;
+	string texture;
+};
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
+vector<ObjectData> setupObjects(const MeshArena& arena, const vector<GLuint>& textureLayers, TransformBatch& transforms, vector<float>& baseAngles, vector<float>& spinSpeeds);
+GLuint createStorageBuffer(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+
+const SceneMesh sceneMeshes[] = {
+	{ "../Camera/textures/suzanne/SuzanneTriTextured.obj", "../Camera/textures/suzanne/SuzanneTriTextured.mtl", "../Camera/textures/suzanne/Suzanne.png" },
+	{ "../Camera/textures/cube/CubeTextured.obj", "../Camera/textures/cube/CubeTextured.mtl", "../Camera/textures/cube/Cube.png" },
+};
+const GLuint WIDTH = 1000, HEIGHT = 1000;
+// 224 x 224 = 50176 objetos
+const int GRID_SIZE = 224;
+const float GRID_SPACING = 2.5f;
+bool cullingEnabled = true,
+animate = true;
+CameraController camera(glm::vec3(0.0, 8.0, 20.0), -90.0f, -20.0f);
+
+int main()
+{
+	glfwInit();
+	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Indirect Scene -- Rafael!", nullptr, nullptr);
+	glfwMakeContextCurrent(window);
+	glfwSetKeyCallback(window, key_callback);
+	glfwSetCursorPos(window, WIDTH / 2, HEIGHT / 2);
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+	}
+	if (!loadGLExtensions())
+	{
+		glfwTerminate();
+		return -1;
+	}
+	const GLubyte* renderer = glGetString(GL_RENDERER);
+	const GLubyte* version = glGetString(GL_VERSION);
+	cout << "Renderer: " << renderer << endl;
+	cout << "OpenGL version supported " << version << endl;
+	cout << "Transform kernel: " << transformKernelName(bestTransformKernel()) << endl;
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+
+	Shader shader("./shaders/scene.vs", "./shaders/scene.fs");
+	Shader cullShader("./shaders/cull.cs");
+
+	// Cada malha da arena tem o seu material (id = id da malha) e a sua camada no texture array,
+	// entao a cena continua saindo em um unico glMultiDrawElementsIndirect
+	MeshArena arena;
+	TextureArray textures;
+	vector<GLuint> textureLayers;
+	vector<MaterialData> materials;
+	for (const SceneMesh& sceneMesh : sceneMeshes)
+	{
+		arena.addMesh(parseObjFile(sceneMesh.objFile));
+		textureLayers.push_back((GLuint)max(0, textures.add(sceneMesh.texture)));
+		Material material = parseMTL(sceneMesh.mtlFile);
+		materials.push_back({ glm::vec4(material.Ka[0], material.Ka[1], material.Ka[2], 0.0f),
+			glm::vec4(material.Ke[0], material.Ke[1], material.Ke[2], 0.0f),
+			glm::vec4(material.Ks[0], material.Ks[1], material.Ks[2], material.Ns) });
+	}
+	arena.upload();
+	cout << "Texture array: " << textures.layerCount() << " layers of " << textures.width << "x" << textures.height << endl;
+	textures.upload();
+
+	JobSystem jobs;
+	cout << "Job system: " << jobs.threadCount() << " threads" << endl;
+	TransformBatch transforms;
+	vector<float> baseAngles, spinSpeeds;
+	vector<ObjectData> objects = setupObjects(arena, textureLayers, transforms, baseAngles, spinSpeeds);
+	GLuint objectCount = (GLuint)objects.size();
+	GLsizeiptr objectDataSize = objects.size() * sizeof(ObjectData);
+	vector<MeshInfo> meshInfos;
+	for (const MeshRange& range : arena.meshes)
+	{
+		meshInfos.push_back({ range.indexCount, range.firstIndex, range.baseVertex, 0, range.boundingSphere });
+	}
+	// As transformacoes mudam todo frame: vao para um ring buffer persistente com 3 regioes
+	GLint storageAlignment;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	PersistentRingBuffer objectRing(GL_SHADER_STORAGE_BUFFER, objectDataSize, storageAlignment);
+	GLuint meshBuffer = createStorageBuffer(GL_SHADER_STORAGE_BUFFER, meshInfos.size() * sizeof(MeshInfo), meshInfos.data(), GL_STATIC_DRAW);
+	GLuint materialBuffer = createStorageBuffer(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(MaterialData), materials.data(), GL_STATIC_DRAW);
+	GLuint commandBuffer = createStorageBuffer(GL_DRAW_INDIRECT_BUFFER, objects.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_COPY);
+
+	// Atributo instanciado com o indice do objeto: com instanceCount = 1 e baseInstance = i,
+	// o vertex shader recebe objectIndex = i sem precisar de gl_DrawID
+	vector<GLuint> objectIndices(objectCount);
+	for (GLuint i = 0; i < objectCount; i++) objectIndices[i] = i;
+	GLuint objectIndexBuffer = createStorageBuffer(GL_ARRAY_BUFFER, objectIndices.size() * sizeof(GLuint), objectIndices.data(), GL_STATIC_DRAW);
+	glBindVertexArray(arena.VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, objectIndexBuffer);
+	glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(GLuint), (GLvoid*)0);
+	glEnableVertexAttribArray(4);
+	glVertexAttribDivisor(4, 1);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glUseProgram(shader.ID);
+	glUniform1i(glGetUniformLocation(shader.ID, "textures"), 0);
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 300.0f);
+	shader.setMat4("projection", glm::value_ptr(projection));
+	shader.setVec3("lightPosition", 15.0f, 50.0f, 2.0f);
+	shader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
+
+	glUseProgram(cullShader.ID);
+	glUniform1ui(glGetUniformLocation(cullShader.ID, "objectCount"), objectCount);
+	GLint frustumLoc = glGetUniformLocation(cullShader.ID, "frustumPlanes");
+	GLint cullingLoc = glGetUniformLocation(cullShader.ID, "cullingEnabled");
+
+	glEnable(GL_DEPTH_TEST);
+	double lastReport = glfwGetTime();
+	int framesSinceReport = 0;
+	double lastFrameTime = glfwGetTime();
+	camera.maxSpeed = 15.0f;
+	camera.acceleration = 60.0f;
+	while (!glfwWindowShouldClose(window))
+	{
+		glfwPollEvents();
+		double currentTime = glfwGetTime();
+		camera.update(window, (float)(currentTime - lastFrameTime));
+		lastFrameTime = currentTime;
+		glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		glm::mat4 view = camera.viewMatrix();
+		Frustum frustum = Frustum::fromMatrix(projection * view);
+
+		objectRing.beginFrame();
+		GLintptr objectOffset;
+		ObjectData* frameObjects = (ObjectData*)objectRing.allocate(objectDataSize, storageAlignment, objectOffset);
+		float angle = animate ? (GLfloat)glfwGetTime() : 0.0f;
+		// Matrizes de mundo compostas em lote (SSE/AVX2) direto na regiao mapeada do ring buffer,
+		// em blocos distribuidos entre as threads do JobSystem
+		TransformBatchOutputs outputs;
+		outputs.world = &frameObjects[0].model;
+		outputs.worldStride = sizeof(ObjectData);
+		glm::mat4 viewProjection = projection * view;
+		jobs.parallelFor(0, objectCount, 4096, [&](size_t first, size_t last) {
+			for (size_t i = first; i < last; i++)
+			{
+				float halfAngle = 0.5f * (baseAngles[i] + angle * spinSpeeds[i]);
+				transforms.qy[i] = sin(halfAngle);
+				transforms.qw[i] = cos(halfAngle);
+				frameObjects[i].info = objects[i].info;
+			}
+			updateTransforms(transforms, viewProjection, outputs, first, last);
+		});
+
+		// Passo 1: culling na GPU escreve um DrawElementsIndirectCommand por objeto
+		glUseProgram(cullShader.ID);
+		glUniform4fv(frustumLoc, 6, glm::value_ptr(frustum.planes[0]));
+		glUniform1i(cullingLoc, cullingEnabled);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, objectRing.ID, objectOffset, objectDataSize);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, meshBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, commandBuffer);
+		glDispatchCompute((objectCount + 63) / 64, 1, 1);
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+		// Passo 2: a cena inteira em uma unica chamada de desenho
+		glUseProgram(shader.ID);
+		shader.setMat4("view", glm::value_ptr(view));
+		shader.setVec3("cameraPos", camera.position.x, camera.position.y, camera.position.z);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, materialBuffer);
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, textures.ID);
+		glBindVertexArray(arena.VAO);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (GLvoid*)0, objectCount, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		glBindVertexArray(0);
+		objectRing.endFrame();
+		glfwSwapBuffers(window);
+
+		framesSinceReport++;
+		double now = glfwGetTime();
+		if (now - lastReport >= 1.0)
+		{
+			cout << objectCount << " objects, culling " << (cullingEnabled ? "on" : "off")
+				<< ", " << (now - lastReport) * 1000.0 / framesSinceReport << " ms/frame"
+				<< ", ring buffer stalls " << objectRing.stalls << endl;
+			lastReport = now;
+			framesSinceReport = 0;
+		}
+	}
+	objectRing.release();
+	glDeleteBuffers(1, &meshBuffer);
+	glDeleteBuffers(1, &materialBuffer);
+	glDeleteBuffers(1, &commandBuffer);
+	glDeleteBuffers(1, &objectIndexBuffer);
+	arena.release();
+	textures.release();
+	glfwTerminate();
+	return 0;
+}
+
+vector<ObjectData> setupObjects(const MeshArena& arena, const vector<GLuint>& textureLayers, TransformBatch& transforms, vector<float>& baseAngles, vector<float>& spinSpeeds)
+{
+	mt19937 gen(42);
+	uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+	uniform_real_distribution<float> speed(-2.0f, 2.0f);
+	vector<ObjectData> objects;
+	objects.reserve(GRID_SIZE * GRID_SIZE);
+	transforms.resize(GRID_SIZE * GRID_SIZE);
+	float offset = (GRID_SIZE - 1) * GRID_SPACING * 0.5f;
+	for (int z = 0; z < GRID_SIZE; z++)
+	{
+		for (int x = 0; x < GRID_SIZE; x++)
+		{
+			GLuint meshId = (GLuint)((x + z) % arena.meshes.size());
+			const MeshRange& mesh = arena.meshes[meshId];
+			glm::vec3 position(x * GRID_SPACING - offset, 0.0f, z * GRID_SPACING - offset);
+			float baseAngle = angle(gen);
+			glm::quat rotation = glm::angleAxis(baseAngle, glm::vec3(0.0f, 1.0f, 0.0f));
+			transforms.set(objects.size(), position, rotation, glm::vec3(0.5f), mesh.aabbMin, mesh.aabbMax);
+			objects.push_back({ glm::mat4(1), glm::uvec4(meshId, textureLayers[meshId], meshId, 0u) });
+			baseAngles.push_back(baseAngle);
+			spinSpeeds.push_back(speed(gen));
+		}
+	}
+	return objects;
+}
+
+GLuint createStorageBuffer(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+	GLuint buffer;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+	glBufferData(target, size, data, usage);
+	glBindBuffer(target, 0);
+	return buffer;
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode)
+{
+	if (action == GLFW_PRESS)
+	{
+		if (key == GLFW_KEY_ESCAPE) glfwSetWindowShouldClose(window, GL_TRUE);
+		if (key == GLFW_KEY_C) cullingEnabled = !cullingEnabled;
+		if (key == GLFW_KEY_R) animate = !animate;
+	}
+}
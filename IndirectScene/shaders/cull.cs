@@ -0,0 +1,69 @@
+#version 450
+
+layout (local_size_x = 64) in;
+
+struct ObjectData
+{
+	mat4 model;
+	uvec4 info; // x = id da malha na arena
+};
+
+struct MeshInfo
+{
+	uint indexCount;
+	uint firstIndex;
+	int baseVertex;
+	uint padding;
+	vec4 boundingSphere;
+};
+
+struct DrawCommand
+{
+	uint count;
+	uint instanceCount;
+	uint firstIndex;
+	int baseVertex;
+	uint baseInstance;
+};
+
+layout (std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+layout (std430, binding = 1) readonly buffer Meshes { MeshInfo meshes[]; };
+layout (std430, binding = 2) writeonly buffer Commands { DrawCommand commands[]; };
+
+uniform vec4 frustumPlanes[6];
+uniform uint objectCount;
+uniform bool cullingEnabled;
+
+void main()
+{
+	uint i = gl_GlobalInvocationID.x;
+	if (i >= objectCount) return;
+
+	mat4 model = objects[i].model;
+	MeshInfo mesh = meshes[objects[i].info.x];
+
+	// Esfera envolvente levada para o mundo; o raio acompanha a maior escala do modelo
+	vec3 center = vec3(model * vec4(mesh.boundingSphere.xyz, 1.0));
+	float scale = max(length(model[0].xyz), max(length(model[1].xyz), length(model[2].xyz)));
+	float radius = mesh.boundingSphere.w * scale;
+
+	bool visible = true;
+	if (cullingEnabled)
+	{
+		for (int p = 0; p < 6; p++)
+		{
+			if (dot(frustumPlanes[p].xyz, center) + frustumPlanes[p].w < -radius)
+			{
+				visible = false;
+				break;
+			}
+		}
+	}
+
+	// baseInstance = indice do objeto, lido no vertex shader pelo atributo instanciado
+	commands[i].count = mesh.indexCount;
+	commands[i].instanceCount = visible ? 1u : 0u;
+	commands[i].firstIndex = mesh.firstIndex;
+	commands[i].baseVertex = mesh.baseVertex;
+	commands[i].baseInstance = i;
+}
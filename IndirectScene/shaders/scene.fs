@@ -0,0 +1,52 @@
+#version 450
+
+in vec3 finalColor;
+in vec3 scaledNormal;
+in vec2 textureCoord;
+in vec3 fragmentPosition;
+flat in uint textureLayer;
+flat in uint materialId;
+
+uniform vec3 lightColor;
+uniform vec3 lightPosition;
+
+struct MaterialData
+{
+	vec4 ka;
+	vec4 kd;
+	vec4 ks; // w = expoente especular
+};
+
+layout (std430, binding = 3) readonly buffer Materials { MaterialData materials[]; };
+
+uniform vec3 cameraPos;
+uniform sampler2DArray textures;
+
+out vec4 color;
+
+void main()
+{
+	MaterialData material = materials[materialId];
+	vec3 ka = material.ka.xyz;
+	vec3 kd = material.kd.xyz;
+	vec3 ks = material.ks.xyz;
+	float q = material.ks.w;
+
+	vec3 ambient = ka * lightColor;
+
+	vec3 N = normalize(scaledNormal);
+	vec3 L = normalize(lightPosition - fragmentPosition);
+	float diff = max(dot(N,L),0.0);
+	vec3 diffuse = kd * diff * lightColor;
+
+	vec3 V = normalize(cameraPos - fragmentPosition);
+	vec3 R = normalize(reflect(-L,N));
+	float spec = max(dot(R,V),0.0);
+	spec = pow(spec, q);
+	vec3 specular = ks * spec * lightColor;
+
+	vec3 texColor = texture(textures, vec3(textureCoord, float(textureLayer))).xyz;
+	vec3 result = (ambient + diffuse) * texColor + specular;
+
+	color = vec4(result, 1.0f);
+}
@@ -0,0 +1,38 @@
+#version 450
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec2 tex_coord;
+layout (location = 3) in vec3 normal;
+layout (location = 4) in uint objectIndex;
+
+struct ObjectData
+{
+	mat4 model;
+	uvec4 info; // x = malha, y = camada do texture array, z = material
+};
+
+layout (std430, binding = 0) readonly buffer Objects { ObjectData objects[]; };
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 finalColor;
+out vec3 scaledNormal;
+out vec2 textureCoord;
+out vec3 fragmentPosition;
+flat out uint textureLayer;
+flat out uint materialId;
+
+void main()
+{
+    mat4 model = objects[objectIndex].model;
+    vec4 worldPosition = model * vec4(position, 1.0);
+    gl_Position = projection * view * worldPosition;
+    finalColor = color;
+    scaledNormal = mat3(model) * normal;
+    textureCoord = vec2(tex_coord.x, 1 - tex_coord.y);
+    fragmentPosition = vec3(worldPosition);
+    textureLayer = objects[objectIndex].info.y;
+    materialId = objects[objectIndex].info.z;
+}
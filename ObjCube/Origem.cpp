@@ -4,6 +4,7 @@
 #include <sstream>
 #include <vector>
 #include <random>
+#include <algorithm>
 #include <assert.h>
 
 using namespace std;
@@ -19,6 +20,12 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// Cache de estado do OpenGL
+#include "GLStateCache.h"
+
+// Solido + arestas + vertices em uma passada
+#include "WireframeOverlay.h"
+
 // Protótipo da função de callback de teclado
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 
@@ -53,6 +60,11 @@ const GLchar* fragmentShaderSource = "#version 450\n"
 "color = finalColor;\n"
 "}\n\0";
 
+// M alterna entre a passada unica do overlay e os dois draws (GL_TRIANGLES + GL_POINTS);
+// , e . mudam a largura das arestas em pixels; B compara a vazao de vertices dos dois caminhos
+WireframeOverlay overlay;
+bool singlePassOverlay = true;
+bool measureOverlay = false;
 bool rotateX,
 		 rotateY,
 		 rotateZ = false;
@@ -96,7 +108,9 @@ int main()
 	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
+	// Binds e estado fixo do loop passam pelo cache, que descarta as chamadas redundantes
+	GLStateCache glState;
+	glState.viewport(0, 0, width, height);
 
 
 	// Compilando e buildando o programa de shader
@@ -104,9 +118,10 @@ int main()
 
 	// Gerando um buffer simples, com a geometria de um triângulo
 	GLuint VAO = setupGeometry();
+	overlay.init();
 
 
-	glUseProgram(shaderID);
+	glState.useProgram(shaderID);
 
 	glm::mat4 model = glm::mat4(1); //matriz identidade;
 	GLint modelLoc = glGetUniformLocation(shaderID, "model");
@@ -114,7 +129,7 @@ int main()
 	model = glm::rotate(model, /*(GLfloat)glfwGetTime()*/glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 	glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
 
-	glEnable(GL_DEPTH_TEST);
+	glState.enable(GL_DEPTH_TEST);
 
 
 	// Loop da aplicação - "game loop"
@@ -124,11 +139,11 @@ int main()
 		glfwPollEvents();
 
 		// Limpa o buffer de cor
-		glClearColor(1.0f, 1.0f, 1.0f, 1.0f); //cor de fundo
+		glState.clearColor(1.0f, 1.0f, 1.0f, 1.0f); //cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glState.lineWidth(10);
+		glState.pointSize(20);
 
 		float angle = (GLfloat)glfwGetTime();
 
@@ -149,23 +164,38 @@ int main()
 
 		}
 
-		glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
-		// Chamada de desenho - drawcall
-		// Poligono Preenchido - GL_TRIANGLES
-		
-		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, 36);
-
-		// Chamada de desenho - drawcall
-		// CONTORNO - GL_LINE_LOOP
-		
-		glDrawArrays(GL_POINTS, 0, 36);
-		glBindVertexArray(0);
+		glState.bindVertexArray(VAO);
+		if (measureOverlay)
+		{
+			compareOverlayThroughput(shaderID, modelLoc, overlay, model, 36, width, height);
+			glState.invalidate();
+			glState.bindVertexArray(VAO);
+			measureOverlay = false;
+		}
+		if (singlePassOverlay)
+		{
+			glState.useProgram(overlay.program);
+			glUniformMatrix4fv(overlay.modelLoc, 1, FALSE, glm::value_ptr(model));
+			overlay.applyUniforms(width, height);
+			glDrawArrays(GL_TRIANGLES, 0, 36);
+		}
+		else
+		{
+			glState.useProgram(shaderID);
+			glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
+			// Poligono Preenchido - GL_TRIANGLES
+			glDrawArrays(GL_TRIANGLES, 0, 36);
+			// Vertices - GL_POINTS (processa todos os vertices de novo)
+			glDrawArrays(GL_POINTS, 0, 36);
+		}
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		glState.endFrame();
+		glState.reportIfDue();
 	}
 	// Pede pra OpenGL desalocar os buffers
+	overlay.release();
 	glDeleteVertexArrays(1, &VAO);
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
@@ -200,6 +230,18 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 		rotateY = false;
 		rotateZ = true;
 	}
+
+	if (key == GLFW_KEY_M && action == GLFW_PRESS)
+		singlePassOverlay = !singlePassOverlay;
+
+	if (key == GLFW_KEY_COMMA && action == GLFW_PRESS)
+		overlay.lineWidth = max(1.0f, overlay.lineWidth - 1.0f);
+
+	if (key == GLFW_KEY_PERIOD && action == GLFW_PRESS)
+		overlay.lineWidth += 1.0f;
+
+	if (key == GLFW_KEY_B && action == GLFW_PRESS)
+		measureOverlay = true;
 }
 
 //Esta função está basntante hardcoded - objetivo é compilar e "buildar" um programa de
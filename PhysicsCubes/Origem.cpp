@@ -0,0 +1,340 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <box2d/box2d.h>
+#include "Shader.h"
+#include "GLExt.h"
+#include "RingBuffer.h"
+#include "TripleBuffer.h"
+#include "CameraController.h"
+
+using namespace std;
+
+// Estado de um corpo como o shader le: x, y, angulo (w sem uso)
+struct BodyState {
+	float x, y, angle, padding;
+};
+
+// O que a thread de fisica entrega a cada passo: os dois ultimos estados de todos os corpos
+// para o render interpolar, e as medidas do passo
+struct PhysicsSnapshot {
+	vector<BodyState> previous;
+	vector<BodyState> current;
+	double currentTime = 0.0;
+	unsigned stepCount = 0;
+	double stepMsTotal = 0.0;
+};
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
+int setupGeometry();
+void setupWorld(b2World& world, vector<b2Body*>& bodies);
+void physicsLoop(b2World& world, const vector<b2Body*>& bodies, TripleBuffer<PhysicsSnapshot>& snapshots, atomic<bool>& running);
+double secondsSince(chrono::steady_clock::time_point start);
+
+const GLuint WIDTH = 1000, HEIGHT = 1000;
+const int BODY_COUNT = 20000;
+const int COLUMNS = 200;
+const float CUBE_HALF_SIZE = 0.25f;
+const float CONTAINER_HALF_WIDTH = 60.0f;
+const float TIME_STEP = 1.0f / 60.0f;
+// Limite de passos por iteracao quando a fisica fica para tras (evita a espiral de atraso)
+const int MAX_STEPS_PER_UPDATE = 4;
+chrono::steady_clock::time_point simulationStart;
+CameraController camera(glm::vec3(0.0, 40.0, 110.0), -90.0f, -10.0f);
+
+int main()
+{
+	glfwInit();
+	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Physics Cubes -- Rafael!", nullptr, nullptr);
+	glfwMakeContextCurrent(window);
+	glfwSetKeyCallback(window, key_callback);
+	glfwSetCursorPos(window, WIDTH / 2, HEIGHT / 2);
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+	}
+	if (!loadGLExtensions())
+	{
+		return -1;
+	}
+	const GLubyte* renderer = glGetString(GL_RENDERER);
+	const GLubyte* version = glGetString(GL_VERSION);
+	cout << "Renderer: " << renderer << endl;
+	cout << "OpenGL version supported " << version << endl;
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+	Shader shader("./shaders/cubes.vs", "./shaders/cubes.fs");
+	GLuint VAO = setupGeometry();
+	glUseProgram(shader.ID);
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (float)height, 0.1f, 500.0f);
+	shader.setMat4("projection", glm::value_ptr(projection));
+	shader.setVec3("lightPosition", 0.0f, 150.0f, 100.0f);
+	shader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
+	camera.maxSpeed = 30.0f;
+	camera.acceleration = 120.0f;
+
+	// b2World nao e thread-safe: depois de criado so a thread de fisica toca nele
+	b2World world(b2Vec2(0.0f, -10.0f));
+	vector<b2Body*> bodies;
+	setupWorld(world, bodies);
+	TripleBuffer<PhysicsSnapshot> snapshots;
+	atomic<bool> running(true);
+	simulationStart = chrono::steady_clock::now();
+	thread physicsThread(physicsLoop, ref(world), cref(bodies), ref(snapshots), ref(running));
+
+	GLint storageAlignment;
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	GLsizeiptr instanceDataSize = BODY_COUNT * sizeof(BodyState);
+	PersistentRingBuffer instanceRing(GL_SHADER_STORAGE_BUFFER, instanceDataSize, storageAlignment);
+
+	glEnable(GL_DEPTH_TEST);
+	double lastFrameTime = glfwGetTime();
+	double lastReport = lastFrameTime;
+	int framesSinceReport = 0;
+	unsigned lastStepCount = 0;
+	double lastStepMsTotal = 0.0;
+	while (!glfwWindowShouldClose(window))
+	{
+		glfwPollEvents();
+		double currentTime = glfwGetTime();
+		camera.update(window, (float)(currentTime - lastFrameTime));
+		lastFrameTime = currentTime;
+		glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// Interpola entre os dois ultimos passos e copia tudo de uma vez para o ring buffer,
+		// sem nenhuma chamada ao Box2D nesta thread
+		snapshots.consume();
+		const PhysicsSnapshot& physics = snapshots.readBuffer();
+		instanceRing.beginFrame();
+		GLintptr instanceOffset;
+		BodyState* instances = (BodyState*)instanceRing.allocate(instanceDataSize, storageAlignment, instanceOffset);
+		size_t bodyCount = physics.current.size();
+		if (instances && bodyCount > 0)
+		{
+			float alpha = (float)glm::clamp((secondsSince(simulationStart) - physics.currentTime) / TIME_STEP, 0.0, 1.0);
+			for (size_t i = 0; i < bodyCount; i++)
+			{
+				const BodyState& a = physics.previous[i];
+				const BodyState& b = physics.current[i];
+				instances[i].x = a.x + (b.x - a.x) * alpha;
+				instances[i].y = a.y + (b.y - a.y) * alpha;
+				instances[i].angle = a.angle + (b.angle - a.angle) * alpha;
+				instances[i].padding = 0.0f;
+			}
+		}
+
+		glUseProgram(shader.ID);
+		glm::mat4 view = camera.viewMatrix();
+		shader.setMat4("view", glm::value_ptr(view));
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, instanceRing.ID, instanceOffset, instanceDataSize);
+		glBindVertexArray(VAO);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)bodyCount);
+		glBindVertexArray(0);
+		instanceRing.endFrame();
+		glfwSwapBuffers(window);
+
+		framesSinceReport++;
+		double now = glfwGetTime();
+		if (now - lastReport >= 1.0)
+		{
+			unsigned steps = physics.stepCount - lastStepCount;
+			double stepMs = steps > 0 ? (physics.stepMsTotal - lastStepMsTotal) / steps : 0.0;
+			cout << bodyCount << " bodies, step " << stepMs << " ms (" << steps << " steps/s, "
+				<< (stepMs > 0.0 ? bodyCount * 1000.0 / stepMs : 0.0) << " bodies/s), render "
+				<< (now - lastReport) * 1000.0 / framesSinceReport << " ms/frame" << endl;
+			lastStepCount = physics.stepCount;
+			lastStepMsTotal = physics.stepMsTotal;
+			lastReport = now;
+			framesSinceReport = 0;
+		}
+	}
+	running = false;
+	physicsThread.join();
+	instanceRing.release();
+	glDeleteVertexArrays(1, &VAO);
+	glfwTerminate();
+	return 0;
+}
+
+// Passo fixo de TIME_STEP no relogio real; depois de cada passo copia posicao e angulo de todos
+// os corpos para o snapshot e publica no triple buffer
+void physicsLoop(b2World& world, const vector<b2Body*>& bodies, TripleBuffer<PhysicsSnapshot>& snapshots, atomic<bool>& running)
+{
+	vector<BodyState> last(bodies.size());
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		const b2Vec2& position = bodies[i]->GetPosition();
+		last[i] = { position.x, position.y, bodies[i]->GetAngle(), 0.0f };
+	}
+	double simulatedTime = 0.0;
+	unsigned stepCount = 0;
+	double stepMsTotal = 0.0;
+	while (running.load())
+	{
+		int steps = 0;
+		while (simulatedTime + TIME_STEP <= secondsSince(simulationStart) && steps < MAX_STEPS_PER_UPDATE)
+		{
+			auto start = chrono::steady_clock::now();
+			world.Step(TIME_STEP, 8, 3);
+			stepMsTotal += secondsSince(start) * 1000.0;
+			stepCount++;
+			simulatedTime += TIME_STEP;
+			steps++;
+
+			PhysicsSnapshot& snapshot = snapshots.writeBuffer();
+			snapshot.previous = last;
+			snapshot.current.resize(bodies.size());
+			for (size_t i = 0; i < bodies.size(); i++)
+			{
+				// GetAngle e o angulo continuo do corpo (nao volta para [-pi, pi]), entao a interpolacao nao salta
+				const b2Vec2& position = bodies[i]->GetPosition();
+				snapshot.current[i] = { position.x, position.y, bodies[i]->GetAngle(), 0.0f };
+			}
+			last = snapshot.current;
+			snapshot.currentTime = simulatedTime;
+			snapshot.stepCount = stepCount;
+			snapshot.stepMsTotal = stepMsTotal;
+			snapshots.publish();
+		}
+		if (steps == MAX_STEPS_PER_UPDATE)
+		{
+			// Nao deu conta do tempo real: descarta o atraso em vez de acumular
+			simulatedTime = max(simulatedTime, secondsSince(simulationStart) - TIME_STEP);
+		}
+		else
+		{
+			this_thread::sleep_for(chrono::milliseconds(1));
+		}
+	}
+}
+
+void setupWorld(b2World& world, vector<b2Body*>& bodies)
+{
+	b2BodyDef groundDef;
+	b2Body* ground = world.CreateBody(&groundDef);
+	b2EdgeShape edge;
+	edge.SetTwoSided(b2Vec2(-CONTAINER_HALF_WIDTH, 0.0f), b2Vec2(CONTAINER_HALF_WIDTH, 0.0f));
+	ground->CreateFixture(&edge, 0.0f);
+	edge.SetTwoSided(b2Vec2(-CONTAINER_HALF_WIDTH, 0.0f), b2Vec2(-CONTAINER_HALF_WIDTH, 200.0f));
+	ground->CreateFixture(&edge, 0.0f);
+	edge.SetTwoSided(b2Vec2(CONTAINER_HALF_WIDTH, 0.0f), b2Vec2(CONTAINER_HALF_WIDTH, 200.0f));
+	ground->CreateFixture(&edge, 0.0f);
+
+	mt19937 gen(42);
+	uniform_real_distribution<float> jitter(-0.1f, 0.1f);
+	uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+	b2PolygonShape box;
+	box.SetAsBox(CUBE_HALF_SIZE, CUBE_HALF_SIZE);
+	b2FixtureDef fixture;
+	fixture.shape = &box;
+	fixture.density = 1.0f;
+	fixture.friction = 0.3f;
+	float spacing = 2.0f * CONTAINER_HALF_WIDTH / COLUMNS;
+	bodies.reserve(BODY_COUNT);
+	for (int i = 0; i < BODY_COUNT; i++)
+	{
+		b2BodyDef def;
+		def.type = b2_dynamicBody;
+		int column = i % COLUMNS;
+		int row = i / COLUMNS;
+		def.position.Set(-CONTAINER_HALF_WIDTH + (column + 0.5f) * spacing + jitter(gen), 2.0f + row * 0.8f);
+		def.angle = angle(gen);
+		b2Body* body = world.CreateBody(&def);
+		body->CreateFixture(&fixture);
+		bodies.push_back(body);
+	}
+}
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Cubo #1 do RotatingCubes centralizado na origem, com normais para a iluminacao
+int setupGeometry()
+{
+	GLfloat vertices[] = {
+		// Front Face
+		-0.25, -0.25, 0.25,		1.0, 0.0, 0.0,		0.0, 0.0, 1.0,
+		-0.25, 0.25, 0.25,		1.0, 0.0, 0.0,		0.0, 0.0, 1.0,
+		0.25, -0.25, 0.25,		1.0, 0.0, 0.0,		0.0, 0.0, 1.0,
+		-0.25, 0.25, 0.25,		1.0, 0.0, 0.0,		0.0, 0.0, 1.0,
+		0.25, 0.25, 0.25,		1.0, 0.0, 0.0,		0.0, 0.0, 1.0,
+		0.25, -0.25, 0.25,		1.0, 0.0, 0.0,		0.0, 0.0, 1.0,
+
+		// Back Face
+		-0.25, -0.25, -0.25,	0.0, 1.0, 0.0,		0.0, 0.0, -1.0,
+		-0.25, 0.25, -0.25,		0.0, 1.0, 0.0,		0.0, 0.0, -1.0,
+		0.25, -0.25, -0.25,		0.0, 1.0, 0.0,		0.0, 0.0, -1.0,
+		-0.25, 0.25, -0.25,		0.0, 1.0, 0.0,		0.0, 0.0, -1.0,
+		0.25, 0.25, -0.25,		0.0, 1.0, 0.0,		0.0, 0.0, -1.0,
+		0.25, -0.25, -0.25,		0.0, 1.0, 0.0,		0.0, 0.0, -1.0,
+
+		// Left Face
+		-0.25, -0.25, 0.25,		0.0, 0.0, 1.0,		-1.0, 0.0, 0.0,
+		-0.25, 0.25, 0.25,		0.0, 0.0, 1.0,		-1.0, 0.0, 0.0,
+		-0.25, -0.25, -0.25,	0.0, 0.0, 1.0,		-1.0, 0.0, 0.0,
+		-0.25, 0.25, 0.25,		0.0, 0.0, 1.0,		-1.0, 0.0, 0.0,
+		-0.25, 0.25, -0.25,		0.0, 0.0, 1.0,		-1.0, 0.0, 0.0,
+		-0.25, -0.25, -0.25,	0.0, 0.0, 1.0,		-1.0, 0.0, 0.0,
+
+		// Right Face
+		0.25, -0.25, 0.25,		1.0, 1.0, 0.0,		1.0, 0.0, 0.0,
+		0.25, 0.25, 0.25,		1.0, 1.0, 0.0,		1.0, 0.0, 0.0,
+		0.25, -0.25, -0.25,		1.0, 1.0, 0.0,		1.0, 0.0, 0.0,
+		0.25, 0.25, 0.25,		1.0, 1.0, 0.0,		1.0, 0.0, 0.0,
+		0.25, 0.25, -0.25,		1.0, 1.0, 0.0,		1.0, 0.0, 0.0,
+		0.25, -0.25, -0.25,		1.0, 1.0, 0.0,		1.0, 0.0, 0.0,
+
+		// Top Face
+		-0.25, 0.25, 0.25,		1.0, 0.0, 1.0,		0.0, 1.0, 0.0,
+		0.25, 0.25, 0.25,		1.0, 0.0, 1.0,		0.0, 1.0, 0.0,
+		-0.25, 0.25, -0.25,		1.0, 0.0, 1.0,		0.0, 1.0, 0.0,
+		0.25, 0.25, 0.25,		1.0, 0.0, 1.0,		0.0, 1.0, 0.0,
+		0.25, 0.25, -0.25,		1.0, 0.0, 1.0,		0.0, 1.0, 0.0,
+		-0.25, 0.25, -0.25,		1.0, 0.0, 1.0,		0.0, 1.0, 0.0,
+
+		// Bottom Face
+		-0.25, -0.25, 0.25,		0.0, 1.0, 1.0,		0.0, -1.0, 0.0,
+		0.25, -0.25, 0.25,		0.0, 1.0, 1.0,		0.0, -1.0, 0.0,
+		-0.25, -0.25, -0.25,	0.0, 1.0, 1.0,		0.0, -1.0, 0.0,
+		0.25, -0.25, 0.25,		0.0, 1.0, 1.0,		0.0, -1.0, 0.0,
+		0.25, -0.25, -0.25,		0.0, 1.0, 1.0,		0.0, -1.0, 0.0,
+		-0.25, -0.25, -0.25,	0.0, 1.0, 1.0,		0.0, -1.0, 0.0,
+	};
+	GLuint VBO, VAO;
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(GLfloat), (GLvoid*)(6 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(2);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	return VAO;
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode)
+{
+	if (action == GLFW_PRESS && key == GLFW_KEY_ESCAPE) glfwSetWindowShouldClose(window, GL_TRUE);
+}
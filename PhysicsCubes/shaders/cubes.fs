@@ -0,0 +1,22 @@
+#version 450
+
+in vec3 finalColor;
+in vec3 scaledNormal;
+in vec3 fragmentPosition;
+
+uniform vec3 lightColor;
+uniform vec3 lightPosition;
+
+out vec4 color;
+
+void main()
+{
+	vec3 ambient = 0.3 * lightColor;
+
+	vec3 N = normalize(scaledNormal);
+	vec3 L = normalize(lightPosition - fragmentPosition);
+	float diff = max(dot(N,L),0.0);
+	vec3 diffuse = 0.7 * diff * lightColor;
+
+	color = vec4((ambient + diffuse) * finalColor, 1.0f);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec3 normal;
+
+// x, y e angulo do corpo interpolados na CPU; w sem uso
+layout (std430, binding = 0) readonly buffer Bodies { vec4 bodies[]; };
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec3 finalColor;
+out vec3 scaledNormal;
+out vec3 fragmentPosition;
+
+void main()
+{
+    vec4 body = bodies[gl_InstanceID];
+    float c = cos(body.z);
+    float s = sin(body.z);
+    mat3 rotation = mat3(c, s, 0.0, -s, c, 0.0, 0.0, 0.0, 1.0);
+    vec3 worldPosition = rotation * position + vec3(body.xy, 0.0);
+    gl_Position = projection * view * vec4(worldPosition, 1.0);
+    finalColor = color;
+    scaledNormal = rotation * normal;
+    fragmentPosition = worldPosition;
+}
@@ -0,0 +1,249 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cfloat>
+#include <cstddef>
+#include <thread>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "Shader.h"
+#include "CameraController.h"
+#include "JobSystem.h"
+#include "PointOctree.h"
+
+using namespace std;
+
+// Nos da octree na GPU: um VBO/VAO por no, enviado quando o no e selecionado pela primeira vez
+struct GpuNode {
+	GLuint VAO = 0, VBO = 0;
+	uint64_t lastUsed = 0;
+};
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
+void uploadNode(const PointOctree& octree, int index, GpuNode& gpuNode);
+
+// Uso: PointCloud [arquivo OBJ/PLY]; sem argumento usa os vertices da Suzanne
+const string defaultCloudFile = "../Camera/textures/suzanne/SuzanneTriTextured.obj";
+const GLuint WIDTH = 1000, HEIGHT = 1000;
+const float FOVY = glm::radians(45.0f);
+// Pontos mantidos na GPU, em multiplos do orcamento de pontos (nos fora da selecao ficam como cache)
+const size_t GPU_CAPACITY_BUDGETS = 2;
+// Pontos enviados por frame, para uma selecao nova nao travar o desenho
+const size_t UPLOAD_POINTS_PER_FRAME = 1000000;
+PointLodSettings lodSettings;
+// Multiplica o tamanho dos pontos (teclas K e L)
+float pointScale = 1.0f;
+bool freezeLod = false;
+CameraController camera(glm::vec3(0.0f, 0.0f, 3.0f));
+
+int main(int argc, char** argv)
+{
+	glfwInit();
+	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Point Cloud -- Rafael!", nullptr, nullptr);
+	glfwMakeContextCurrent(window);
+	glfwSetKeyCallback(window, key_callback);
+	glfwSetCursorPos(window, WIDTH / 2, HEIGHT / 2);
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+	}
+	const GLubyte* renderer = glGetString(GL_RENDERER);
+	const GLubyte* version = glGetString(GL_VERSION);
+	cout << "Renderer: " << renderer << endl;
+	cout << "OpenGL version supported " << version << endl;
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	glViewport(0, 0, width, height);
+	Shader shader("./shaders/point.vs", "./shaders/point.fs");
+
+	// Leitura e construcao da octree nos workers; a janela continua respondendo enquanto isso
+	JobSystem jobs(max(2, (int)thread::hardware_concurrency() - 1));
+	string cloudFile = argc > 1 ? argv[1] : defaultCloudFile;
+	PointOctree octree;
+	JobCounter built;
+	bool loaded = false;
+	auto buildStart = chrono::steady_clock::now();
+	jobs.run([&octree, &jobs, &cloudFile, &loaded]() {
+		PointCloud cloud;
+		loaded = loadPointCloud(cloudFile, cloud, &jobs);
+		if (loaded) octree.build(move(cloud), &jobs);
+	}, &built);
+	while (!built.done() && !glfwWindowShouldClose(window))
+	{
+		glfwWaitEventsTimeout(0.05);
+		glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glfwSwapBuffers(window);
+	}
+	jobs.wait(built);
+	if (!loaded || octree.nodes.empty())
+	{
+		glfwTerminate();
+		return -1;
+	}
+	cout << cloudFile << ": " << octree.points.size() << " points, " << octree.nodes.size() << " nodes, depth " << octree.maxDepth()
+		<< ", built in " << chrono::duration<double>(chrono::steady_clock::now() - buildStart).count() << " s" << endl;
+
+	// Camera, velocidade e planos proporcionais ao cubo da raiz
+	const PointNode& root = octree.nodes[0];
+	glm::vec3 center = root.boundsMin + glm::vec3(root.size * 0.5f);
+	camera.position = center + glm::vec3(0.0f, 0.0f, root.size * 1.2f);
+	camera.maxSpeed = root.size * 0.25f;
+	camera.acceleration = camera.maxSpeed * 4.0f;
+	glm::mat4 projection = glm::perspective(FOVY, (float)width / (float)height, root.size * 0.0005f, root.size * 10.0f);
+	// Faixa de altura para colorir nuvens sem cor, pela amostra da raiz
+	glm::vec2 heightRange(FLT_MAX, -FLT_MAX);
+	for (size_t i = root.first; i < root.first + root.count; i++)
+	{
+		heightRange.x = min(heightRange.x, octree.points[i].position.y);
+		heightRange.y = max(heightRange.y, octree.points[i].position.y);
+	}
+
+	glUseProgram(shader.ID);
+	shader.setMat4("projection", glm::value_ptr(projection));
+	glUniform1f(glGetUniformLocation(shader.ID, "projectionFactor"), height / (2.0f * tan(FOVY * 0.5f)));
+	glUniform1f(glGetUniformLocation(shader.ID, "minPointSize"), 1.0f);
+	glUniform1f(glGetUniformLocation(shader.ID, "maxPointSize"), 32.0f);
+	glUniform1i(glGetUniformLocation(shader.ID, "useColors"), octree.hasColors);
+	glUniform2f(glGetUniformLocation(shader.ID, "heightRange"), heightRange.x, heightRange.y);
+	GLint spacingLoc = glGetUniformLocation(shader.ID, "pointSpacing");
+	glEnable(GL_DEPTH_TEST);
+	// Tamanho do ponto vem do vertex shader (gl_PointSize) em vez do glPointSize fixo
+	glEnable(GL_PROGRAM_POINT_SIZE);
+
+	vector<GpuNode> gpuNodes(octree.nodes.size());
+	vector<int> residentNodes;
+	size_t residentPoints = 0;
+	vector<PointNodeSelection> selected;
+	uint64_t frame = 0;
+	size_t uploadsSinceReport = 0, evictionsSinceReport = 0;
+	double lastReport = glfwGetTime();
+	int framesSinceReport = 0;
+	double lastFrameTime = glfwGetTime();
+	while (!glfwWindowShouldClose(window))
+	{
+		glfwPollEvents();
+		double currentTime = glfwGetTime();
+		camera.update(window, (float)(currentTime - lastFrameTime));
+		lastFrameTime = currentTime;
+		frame++;
+		glm::mat4 view = camera.viewMatrix();
+		if (!freezeLod)
+		{
+			PointLodView lodView;
+			lodView.viewProjection = projection * view;
+			lodView.cameraPosition = camera.position;
+			lodView.projectionFactor = height / (2.0f * tan(FOVY * 0.5f));
+			octree.selectNodes(lodView, lodSettings, selected);
+		}
+
+		// Envia os nos que faltam (pais primeiro, na ordem da selecao) ate o limite do frame
+		size_t uploadedPoints = 0;
+		for (const PointNodeSelection& selection : selected)
+		{
+			GpuNode& gpuNode = gpuNodes[selection.node];
+			gpuNode.lastUsed = frame;
+			if (gpuNode.VAO || uploadedPoints >= UPLOAD_POINTS_PER_FRAME) continue;
+			uploadNode(octree, selection.node, gpuNode);
+			residentNodes.push_back(selection.node);
+			uploadedPoints += octree.nodes[selection.node].count;
+			residentPoints += octree.nodes[selection.node].count;
+			uploadsSinceReport++;
+		}
+		// Acima da capacidade, descarta os nos usados ha mais tempo (nunca os deste frame)
+		size_t capacity = GPU_CAPACITY_BUDGETS * lodSettings.pointBudget;
+		if (residentPoints > capacity)
+		{
+			sort(residentNodes.begin(), residentNodes.end(), [&gpuNodes](int a, int b) { return gpuNodes[a].lastUsed > gpuNodes[b].lastUsed; });
+			while (residentPoints > capacity && gpuNodes[residentNodes.back()].lastUsed != frame)
+			{
+				GpuNode& gpuNode = gpuNodes[residentNodes.back()];
+				glDeleteVertexArrays(1, &gpuNode.VAO);
+				glDeleteBuffers(1, &gpuNode.VBO);
+				gpuNode = GpuNode();
+				residentPoints -= octree.nodes[residentNodes.back()].count;
+				residentNodes.pop_back();
+				evictionsSinceReport++;
+			}
+		}
+
+		glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glUseProgram(shader.ID);
+		shader.setMat4("view", glm::value_ptr(view));
+		size_t drawnPoints = 0;
+		for (const PointNodeSelection& selection : selected)
+		{
+			const GpuNode& gpuNode = gpuNodes[selection.node];
+			if (!gpuNode.VAO) continue;
+			glUniform1f(spacingLoc, selection.drawSpacing * pointScale);
+			glBindVertexArray(gpuNode.VAO);
+			glDrawArrays(GL_POINTS, 0, (GLsizei)octree.nodes[selection.node].count);
+			drawnPoints += octree.nodes[selection.node].count;
+		}
+		glBindVertexArray(0);
+		glfwSwapBuffers(window);
+
+		framesSinceReport++;
+		double now = glfwGetTime();
+		if (now - lastReport >= 1.0)
+		{
+			cout << selected.size() << " nodes, " << drawnPoints << " points drawn (budget " << lodSettings.pointBudget << ", error "
+				<< lodSettings.maxScreenError << " px" << (freezeLod ? ", frozen" : "") << "), " << residentPoints * sizeof(CloudPoint) / (1024 * 1024)
+				<< " MB on GPU, " << uploadsSinceReport << " uploads, " << evictionsSinceReport << " evictions, "
+				<< (now - lastReport) * 1000.0 / framesSinceReport << " ms/frame" << endl;
+			lastReport = now;
+			framesSinceReport = 0;
+			uploadsSinceReport = evictionsSinceReport = 0;
+		}
+	}
+	for (GpuNode& gpuNode : gpuNodes)
+	{
+		if (!gpuNode.VAO) continue;
+		glDeleteVertexArrays(1, &gpuNode.VAO);
+		glDeleteBuffers(1, &gpuNode.VBO);
+	}
+	glfwTerminate();
+	return 0;
+}
+
+// Os pontos do no ja estao contiguos em octree.points: posicao (3 floats) e cor RGBA8
+void uploadNode(const PointOctree& octree, int index, GpuNode& gpuNode)
+{
+	const PointNode& node = octree.nodes[index];
+	glGenBuffers(1, &gpuNode.VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, gpuNode.VBO);
+	glBufferData(GL_ARRAY_BUFFER, node.count * sizeof(CloudPoint), &octree.points[node.first], GL_STATIC_DRAW);
+	glGenVertexArrays(1, &gpuNode.VAO);
+	glBindVertexArray(gpuNode.VAO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CloudPoint), (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(CloudPoint), (GLvoid*)offsetof(CloudPoint, color));
+	glEnableVertexAttribArray(1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode)
+{
+	if (action != GLFW_PRESS) return;
+	if (key == GLFW_KEY_ESCAPE) glfwSetWindowShouldClose(window, GL_TRUE);
+	// Orcamento de pontos
+	if (key == GLFW_KEY_EQUAL || key == GLFW_KEY_KP_ADD) lodSettings.pointBudget *= 2;
+	if ((key == GLFW_KEY_MINUS || key == GLFW_KEY_KP_SUBTRACT) && lodSettings.pointBudget > 100000) lodSettings.pointBudget /= 2;
+	// Erro maximo em pixels
+	if (key == GLFW_KEY_LEFT_BRACKET) lodSettings.maxScreenError = max(0.25f, lodSettings.maxScreenError * 0.5f);
+	if (key == GLFW_KEY_RIGHT_BRACKET) lodSettings.maxScreenError *= 2.0f;
+	if (key == GLFW_KEY_K) pointScale = max(0.25f, pointScale * 0.8f);
+	if (key == GLFW_KEY_L) pointScale *= 1.25f;
+	// Congela a selecao para ver o que foi carregado de outro ponto de vista
+	if (key == GLFW_KEY_F) freezeLod = !freezeLod;
+}
@@ -0,0 +1,13 @@
+#version 450
+
+in vec3 finalColor;
+
+out vec4 color;
+
+void main()
+{
+    // Sprite redondo: descarta os cantos do quadrado do GL_POINTS
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    if (dot(offset, offset) > 1.0) discard;
+    color = vec4(finalColor, 1.0);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec4 color;
+
+uniform mat4 view;
+uniform mat4 projection;
+// Pixels por unidade de mundo a distancia 1 (altura do viewport / (2 tan(fovy / 2)))
+uniform float projectionFactor;
+// Spacing do nivel mais fino desenhado nesta regiao, vezes a escala escolhida nas teclas
+uniform float pointSpacing;
+uniform float minPointSize;
+uniform float maxPointSize;
+// Nuvem sem cor: colore pela altura normalizada
+uniform bool useColors;
+uniform vec2 heightRange;
+
+out vec3 finalColor;
+
+void main()
+{
+    vec4 viewPosition = view * vec4(position, 1.0);
+    gl_Position = projection * viewPosition;
+    // Atenuacao: o ponto cobre o spacing do no projetado na sua distancia
+    gl_PointSize = clamp(pointSpacing * projectionFactor / max(-viewPosition.z, 1e-4), minPointSize, maxPointSize);
+    float height = clamp((position.y - heightRange.x) / max(heightRange.y - heightRange.x, 1e-6), 0.0, 1.0);
+    finalColor = useColors ? color.rgb : mix(vec3(0.1, 0.3, 0.9), vec3(1.0, 0.9, 0.3), height);
+}
@@ -15,6 +15,11 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "JobSystem.h"
+#include "FrameCapture.h"
+#include "GLStateCache.h"
+#include "WireframeOverlay.h"
+
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 int setupShader();
 int setupGeometry();
@@ -37,11 +42,18 @@ const GLchar* fragmentShaderSource = "#version 450\n"
 "{\n"
 "color = finalColor;\n"
 "}\n\0";
+// M alterna entre a passada unica do overlay e os dois draws (GL_TRIANGLES + GL_POINTS);
+// , e . mudam a largura das arestas em pixels; B compara a vazao de vertices dos dois caminhos
+WireframeOverlay overlay;
+bool singlePassOverlay = true;
+bool measureOverlay = false;
 bool rotateX,
 		 rotateY,
 		 rotateZ = false;
 float scale = 0.7f;
 glm::vec3 translation(0.0f, 0.0f, 0.0f);
+// P grava uma sequencia PNG e G um GIF animado; a mesma tecla encerra
+FrameCapture capture;
 
 int main()
 {
@@ -64,29 +76,36 @@ int main()
 
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
+	// Binds e estado fixo do loop passam pelo cache, que descarta as chamadas redundantes
+	GLStateCache glState;
+	glState.viewport(0, 0, width, height);
+
+	// Pelo menos dois workers, senao os encoders so rodariam quando a thread principal esperasse
+	JobSystem jobs(max(2, (int)thread::hardware_concurrency() - 1));
+	capture.init(width, height, jobs);
 
 	GLuint shaderID = setupShader();
 	GLuint VAO = setupGeometry();
+	overlay.init();
 
-	glUseProgram(shaderID);
+	glState.useProgram(shaderID);
 
 	glm::mat4 model = glm::mat4(1);
 	GLint modelLoc = glGetUniformLocation(shaderID, "model");
 	model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 	glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
 
-	glEnable(GL_DEPTH_TEST);
+	glState.enable(GL_DEPTH_TEST);
 
 	while (!glfwWindowShouldClose(window))
 	{
 		glfwPollEvents();
 
-		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glState.clearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glLineWidth(10);
-		glPointSize(20);
+		glState.lineWidth(10);
+		glState.pointSize(20);
 
 		float angle = (GLfloat)glfwGetTime();
 
@@ -107,14 +126,36 @@ int main()
 			model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
 		}
 
-		glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
-		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, 72);
-		glDrawArrays(GL_POINTS, 0, 72);
-		glBindVertexArray(0);
+		glState.bindVertexArray(VAO);
+		if (measureOverlay)
+		{
+			compareOverlayThroughput(shaderID, modelLoc, overlay, model, 72, width, height);
+			glState.invalidate();
+			glState.bindVertexArray(VAO);
+			measureOverlay = false;
+		}
+		if (singlePassOverlay)
+		{
+			glState.useProgram(overlay.program);
+			glUniformMatrix4fv(overlay.modelLoc, 1, FALSE, glm::value_ptr(model));
+			overlay.applyUniforms(width, height);
+			glDrawArrays(GL_TRIANGLES, 0, 72);
+		}
+		else
+		{
+			glState.useProgram(shaderID);
+			glUniformMatrix4fv(modelLoc, 1, FALSE, glm::value_ptr(model));
+			glDrawArrays(GL_TRIANGLES, 0, 72);
+			glDrawArrays(GL_POINTS, 0, 72);
+		}
 
+		capture.captureFrame();
 		glfwSwapBuffers(window);
+		glState.endFrame();
+		glState.reportIfDue();
 	}
+	capture.release();
+	overlay.release();
 	glDeleteVertexArrays(1, &VAO);
 	glfwTerminate();
 	return 0;
@@ -168,6 +209,26 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 		case GLFW_KEY_D:
 			translation.z -= 0.1f;
 			break;
+		case GLFW_KEY_P:
+			if (capture.recording()) capture.stop();
+			else capture.start(CAPTURE_PNG_SEQUENCE, "frame");
+			break;
+		case GLFW_KEY_G:
+			if (capture.recording()) capture.stop();
+			else capture.start(CAPTURE_GIF, "RotatingCubes_capture.gif");
+			break;
+		case GLFW_KEY_M:
+			singlePassOverlay = !singlePassOverlay;
+			break;
+		case GLFW_KEY_COMMA:
+			overlay.lineWidth = max(1.0f, overlay.lineWidth - 1.0f);
+			break;
+		case GLFW_KEY_PERIOD:
+			overlay.lineWidth += 1.0f;
+			break;
+		case GLFW_KEY_B:
+			measureOverlay = true;
+			break;
 	}
 }
 
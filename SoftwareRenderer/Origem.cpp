@@ -0,0 +1,117 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "stb_image.h"
+#include "ObjLoader.h"
+#include "SoftwareRasterizer.h"
+
+using namespace std;
+
+bool readPPM(const string& path, int& width, int& height, vector<unsigned char>& pixels);
+
+const string objFile = "../Camera/textures/suzanne/SuzanneTriTextured.obj";
+const string mtlFile = "../Camera/textures/suzanne/SuzanneTriTextured.mtl";
+const string textureFile = "../Camera/textures/suzanne/Suzanne.png";
+const int WIDTH = 1000, HEIGHT = 1000;
+
+// Uso: SoftwareRenderer [frames] [threads] [referencia (PNG ou PPM) ou -] [saida.ppm]
+// Com uma referencia, compara o ultimo frame e retorna 1 se a diferenca passar do limite.
+// reference.png e o ultimo frame com os 100 frames padrao: SoftwareRenderer 100 0 reference.png
+int main(int argc, char** argv)
+{
+	int frames = argc > 1 ? atoi(argv[1]) : 100;
+	int threads = argc > 2 ? atoi(argv[2]) : 0;
+	string reference = argc > 3 && string(argv[3]) != "-" ? argv[3] : "";
+	string outputFile = argc > 4 ? argv[4] : "output.ppm";
+
+	vector<float> vertices = parseObjFile(objFile);
+	Material material = parseMTL(mtlFile);
+	SoftwareTexture texture;
+	unsigned char* data = stbi_load(textureFile.c_str(), &texture.width, &texture.height, &texture.channels, 0);
+	if (!data) {
+		cout << "Failed to load texture" << endl;
+	}
+	texture.data = data;
+
+	SoftwareRasterizer rasterizer(WIDTH, HEIGHT, threads);
+	SoftwareUniforms uniforms;
+	uniforms.view = glm::lookAt(glm::vec3(0.0, 0.0, 3.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
+	uniforms.projection = glm::perspective(glm::radians(45.0f), (float)WIDTH / (float)HEIGHT, 0.1f, 100.0f);
+	uniforms.ka = glm::vec3(material.Ka[0], material.Ka[1], material.Ka[2]);
+	uniforms.kd = glm::vec3(material.Ke[0], material.Ke[1], material.Ke[2]);
+	uniforms.ks = glm::vec3(material.Ks[0], material.Ks[1], material.Ks[2]);
+	uniforms.q = material.Ns;
+	uniforms.lightPosition = glm::vec3(15.0f, 15.0f, 2.0f);
+	uniforms.lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	uniforms.cameraPos = glm::vec3(0.0, 0.0, 3.0);
+
+	cout << "Software renderer: " << WIDTH << "x" << HEIGHT << ", " << rasterizer.threadCount << " threads, "
+		<< vertices.size() / OBJ_VERTEX_STRIDE / 3 << " triangles" << endl;
+	double geometryMs = 0.0, rasterMs = 0.0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		// Mesmo movimento do rotateY do modulo Camera, com passo fixo para ser deterministico
+		float angle = frame * 0.05f;
+		glm::mat4 model = glm::mat4(1);
+		model = glm::rotate(model, angle, glm::vec3(0.0f, 1.0f, 0.0f));
+		model = glm::scale(model, glm::vec3(0.5, 0.5, 0.5));
+		uniforms.model = model;
+		rasterizer.renderFrame(vertices, OBJ_VERTEX_STRIDE, uniforms, texture);
+		geometryMs += rasterizer.lastGeometryMs;
+		rasterMs += rasterizer.lastRasterMs;
+	}
+	if (frames > 0)
+	{
+		double frameMs = (geometryMs + rasterMs) / frames;
+		cout << "Average: " << frameMs << " ms/frame (" << 1000.0 / frameMs << " fps) - geometry "
+			<< geometryMs / frames << " ms, raster " << rasterMs / frames << " ms" << endl;
+	}
+	rasterizer.writePPM(outputFile);
+	cout << "Last frame written to " << outputFile << endl;
+	stbi_image_free(data);
+
+	if (reference.empty()) return 0;
+	int refWidth, refHeight, refChannels;
+	unsigned char* refPixels = stbi_load(reference.c_str(), &refWidth, &refHeight, &refChannels, 3);
+	vector<unsigned char> expected, actual;
+	if (refPixels) expected.assign(refPixels, refPixels + (size_t)refWidth * refHeight * 3);
+	stbi_image_free(refPixels);
+	int outWidth, outHeight;
+	if (!refPixels || !readPPM(outputFile, outWidth, outHeight, actual) || refWidth != outWidth || refHeight != outHeight)
+	{
+		cout << "Failed to compare with reference " << reference << endl;
+		return 1;
+	}
+	int maxDiff = 0;
+	double sumDiff = 0.0;
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		int diff = abs((int)expected[i] - (int)actual[i]);
+		maxDiff = max(maxDiff, diff);
+		sumDiff += diff;
+	}
+	double meanDiff = sumDiff / expected.size();
+	bool passed = meanDiff < 0.5 && maxDiff < 64;
+	cout << "Reference diff: mean " << meanDiff << ", max " << maxDiff << (passed ? " - OK" : " - FAILED") << endl;
+	return passed ? 0 : 1;
+}
+
+bool readPPM(const string& path, int& width, int& height, vector<unsigned char>& pixels)
+{
+	ifstream file(path, ios::binary);
+	string magic;
+	int maxValue;
+	file >> magic >> width >> height >> maxValue;
+	if (!file || magic != "P6" || maxValue != 255) return false;
+	file.get();
+	pixels.resize((size_t)width * height * 3);
+	file.read((char*)pixels.data(), pixels.size());
+	return (bool)file;
+}
@@ -2,6 +2,8 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <chrono>
+#include <cfloat>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -11,57 +13,54 @@
 #include <GLFW/glfw3.h>
 #include "Shader.h"
 #include "stb_image.h"
+#include "ObjLoader.h"
+#include "ObjStreamLoader.h"
+#include "FrameScheduler.h"
+#include "GLStateCache.h"
+#include "AssetArchive.h"
 
 using namespace std;
 
-struct Vertex {
-	float x, y, z;
-};
-
-struct Normal {
-	float nx, ny, nz;
-};
-
-struct TextureCoordinate {
-	float u, v;
-};
-
-struct FaceVertex {
-	int vertexIndex, uvIndex, normalIndex;
-};
-
-struct Material {
-	string name;
-	float Ns;
-	float Ka[3];
-	float Ks[3];
-	float Ke[3];
-	float Ni;
-	float d;
-	int illum;
-	string map_Kd;
-};
-
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
-Material parseMTL(const string& filename);
 int setupGeometry();
+GLuint createVertexArray(GLuint VBO);
+void uploadStreamBatch(const vector<float>& batch);
 int loadTexture(string path);
-vector<float> parseObjFile(const string& filename);
 
-const string objFile = "../../3D_Models/Suzanne/SuzanneTriTextured.obj";
-const string mtlFile = "../../3D_Models/Suzanne/SuzanneTriTextured.mtl";
+const string objFile = "../files/SuzanneTriTextured.obj";
+const string mtlFile = "../files/SuzanneTriTextured.mtl";
+// Com assets.pak (AssetPacker SuzannePhong/assets.pak --base SuzannePhong SuzannePhong/files/* SuzannePhong/shaders/*)
+// tudo vem de um unico arquivo mapeado; sem ele, dos arquivos soltos
+const string archiveFile = "../assets.pak";
+AssetArchive archive;
 const GLuint WIDTH = 1000, HEIGHT = 1000;
 bool rotateX,
 rotateY,
 rotateZ = false;
 int verticesQty;
+// Limite usado quando o limitador esta ligado (tecla T); O alterna entre sob demanda e continuo
+const double FRAME_LIMIT_FPS = 30.0;
+FrameScheduler scheduler;
+// Malha grande passada na linha de comando (Uso: SuzannePhong [arquivo OBJ] [orcamento MB]): lida
+// pelo ObjStreamLoader e desenhada enquanto chega, em segmentos de VBO de tamanho fixo
+const GLsizeiptr STREAM_SEGMENT_BYTES = (GLsizeiptr)64 << 20;
+// Lotes enviados por frame, para o upload nao travar o desenho
+const int STREAM_BATCHES_PER_FRAME = 2;
+struct StreamSegment {
+	GLuint VAO, VBO;
+	GLsizeiptr capacity;
+	GLsizei vertexCount;
+};
+vector<StreamSegment> streamSegments;
+glm::vec3 streamMin(FLT_MAX), streamMax(-FLT_MAX);
 
-int main()
+int main(int argc, char** argv)
 {
 	glfwInit();
 	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Iluminacao -- Rafael!", nullptr, nullptr);
 	glfwMakeContextCurrent(window);
 	glfwSetKeyCallback(window, key_callback);
+	scheduler.attach(window);
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
 	{
 		cout << "Failed to initialize GLAD" << endl;
@@ -72,10 +71,28 @@ int main()
 	cout << "OpenGL version supported " << version << endl;
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
-	glViewport(0, 0, width, height);
-	Shader shader("../shaders/shader.vs", "../shaders/shader.fs");
-	GLuint VAO = setupGeometry();
-	glUseProgram(shader.ID);
+	// Binds e estado fixo do loop passam pelo cache, que descarta as chamadas redundantes
+	GLStateCache glState;
+	glState.viewport(0, 0, width, height);
+	cout << (archive.open(archiveFile) ? "Loading assets from " + archiveFile : string("Loading loose asset files")) << endl;
+	AssetData vertexSource, fragmentSource;
+	readAsset(archive, "../shaders/shader.vs", vertexSource);
+	readAsset(archive, "../shaders/shader.fs", fragmentSource);
+	Shader shader;
+	shader.compile(vertexSource.text(), fragmentSource.text());
+	ObjStreamLoader streamLoader;
+	bool streaming = argc > 1;
+	GLuint VAO = 0;
+	if (streaming)
+	{
+		ObjStreamOptions options;
+		if (argc > 2) options.memoryBudget = (size_t)atoll(argv[2]) << 20;
+		options.batchTriangles = objStreamBatchTrianglesForBudget(options);
+		streamLoader.start(argv[1], options);
+	}
+	else VAO = setupGeometry();
+	auto streamStart = chrono::steady_clock::now();
+	glState.useProgram(shader.ID);
 	glUniform1i(glGetUniformLocation(shader.ID, "tex_buffer"), 0);
 	glm::mat4 view = glm::lookAt(glm::vec3(0.0, 0.0, 3.0), glm::vec3(0.0, 0.0, 0.0), glm::vec3(0.0, 1.0, 0.0));
 	shader.setMat4("view", value_ptr(view));
@@ -84,22 +101,54 @@ int main()
 	glm::mat4 model = glm::mat4(1);
 	model = glm::rotate(model, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 	shader.setMat4("model", glm::value_ptr(model));
-	Material material = parseMTL(mtlFile);
-	GLuint textureId = loadTexture(material.map_Kd);
+	AssetData mtl;
+	readAsset(archive, mtlFile, mtl);
+	MemoryStreamBuffer mtlBuffer(mtl.data, mtl.size);
+	istream mtlStream(&mtlBuffer);
+	Material material = parseMTL(mtlStream);
+	// map_Kd e relativo a pasta do MTL
+	GLuint textureId = loadTexture(mtlFile.substr(0, mtlFile.find_last_of('/') + 1) + material.map_Kd);
 	shader.setVec3("ka", material.Ka[0], material.Ka[1], material.Ka[2]);
 	shader.setVec3("kd", material.Ke[0], material.Ke[1], material.Ke[2]);
 	shader.setVec3("ks", material.Ks[0], material.Ks[1], material.Ks[2]);
 	shader.setFloat("q", material.Ns);
 	shader.setVec3("lightPosition", 15.0f, 15.0f, 2.0f);
 	shader.setVec3("lightColor", 1.0f, 1.0f, 1.0f);
-	glEnable(GL_DEPTH_TEST);
+	glState.enable(GL_DEPTH_TEST);
 	while (!glfwWindowShouldClose(window))
 	{
-		glfwPollEvents();
-		glClearColor(0.08f, 0.08f, 0.08f, 1.0f);
+		// Parado (sem rotacao nem input) espera eventos em vez de redesenhar o mesmo frame
+		scheduler.waitEvents();
+		bool loading = streaming && !streamLoader.finished();
+		scheduler.setAnimating(rotateX || rotateY || rotateZ || loading);
+		scheduler.reportIfDue();
+		glState.reportIfDue();
+		if (!scheduler.shouldRender()) continue;
+		if (loading)
+		{
+			vector<float> batch;
+			int uploaded = 0;
+			while (uploaded < STREAM_BATCHES_PER_FRAME && streamLoader.poll(batch))
+			{
+				uploadStreamBatch(batch);
+				uploaded++;
+			}
+			// O upload liga buffers e VAOs direto no GL
+			if (uploaded > 0) glState.invalidate();
+			if (streamLoader.finished())
+			{
+				const ObjStreamStats& stats = streamLoader.stats();
+				if (streamLoader.failed()) cout << "Streaming of " << argv[1] << " failed" << endl;
+				else cout << "Streamed " << stats.triangles << " triangles (" << (stats.fileBytes >> 20) << " MB) in "
+					<< chrono::duration<double>(chrono::steady_clock::now() - streamStart).count() << " s, " << stats.pagesSpilled
+					<< " pages spilled, " << stats.pageLoads << " page loads, loader peak " << (stats.peakTrackedBytes >> 20) << " MB" << endl;
+			}
+		}
+		if (scheduler.dirtyFlags() & DIRTY_WINDOW) glState.viewport(0, 0, scheduler.framebufferWidth, scheduler.framebufferHeight);
+		glState.clearColor(0.08f, 0.08f, 0.08f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		glLineWidth(10);
-		glPointSize(20);
+		glState.lineWidth(10);
+		glState.pointSize(20);
 		float angle = (GLfloat)glfwGetTime();
 		model = glm::mat4(1);
 		model = glm::scale(model, glm::vec3(0.5, 0.5, 0.5));
@@ -115,13 +164,38 @@ int main()
 		{
 			model = glm::rotate(model, angle, glm::vec3(0.0f, 0.0f, 1.0f));
 		}
+		if (streaming && !streamSegments.empty())
+		{
+			// Enquadra o que ja chegou: centro na origem e raio 2 (o da Suzanne)
+			glm::vec3 center = (streamMin + streamMax) * 0.5f;
+			float radius = max(glm::length(streamMax - streamMin) * 0.5f, 1e-6f);
+			model = glm::scale(model, glm::vec3(2.0f / radius));
+			model = glm::translate(model, -center);
+		}
 		shader.setMat4("model", glm::value_ptr(model));
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, textureId);
-		glBindVertexArray(VAO);
-		glDrawArrays(GL_TRIANGLES, 0, verticesQty);
-		glBindVertexArray(0);
+		glState.bindTexture(GL_TEXTURE0, GL_TEXTURE_2D, textureId);
+		if (streaming)
+		{
+			for (const StreamSegment& segment : streamSegments)
+			{
+				glState.bindVertexArray(segment.VAO);
+				glDrawArrays(GL_TRIANGLES, 0, segment.vertexCount);
+			}
+		}
+		else
+		{
+			glState.bindVertexArray(VAO);
+			glDrawArrays(GL_TRIANGLES, 0, verticesQty);
+		}
 		glfwSwapBuffers(window);
+		scheduler.frameRendered();
+		glState.endFrame();
+	}
+	streamLoader.cancel();
+	for (const StreamSegment& segment : streamSegments)
+	{
+		glDeleteVertexArrays(1, &segment.VAO);
+		glDeleteBuffers(1, &segment.VBO);
 	}
 	glDeleteVertexArrays(1, &VAO);
 	glfwTerminate();
@@ -130,12 +204,24 @@ int main()
 
 int setupGeometry()
 {
-	vector<float> vertices = parseObjFile(objFile);
+	AssetData obj;
+	readAsset(archive, objFile, obj);
+	MemoryStreamBuffer objBuffer(obj.data, obj.size);
+	istream objStream(&objBuffer);
+	vector<float> vertices = parseObjFile(objStream);
 	verticesQty = vertices.size() / 11;
-	GLuint VBO, VAO;
+	GLuint VBO;
 	glGenBuffers(1, &VBO);
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+	return createVertexArray(VBO);
+}
+
+// Layout do parseObjFile sobre o VBO ja preenchido
+GLuint createVertexArray(GLuint VBO)
+{
+	GLuint VAO;
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glGenVertexArrays(1, &VAO);
 	glBindVertexArray(VAO);
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(GLfloat), (GLvoid*)0);
@@ -151,106 +237,31 @@ int setupGeometry()
 	return VAO;
 }
 
-vector<float> parseObjFile(const string& filename)
+// Anexa o lote ao segmento atual; um segmento cheio fica como esta e outro e criado
+void uploadStreamBatch(const vector<float>& batch)
 {
-	vector<Vertex> vertices;
-	vector<Normal> normals;
-	vector<TextureCoordinate> textures;
-	vector<vector<FaceVertex>> faces;
-	ifstream file(filename);
-	string line;
-	while (getline(file, line))
+	GLsizeiptr bytes = (GLsizeiptr)(batch.size() * sizeof(float));
+	GLsizeiptr vertexBytes = OBJ_VERTEX_STRIDE * sizeof(float);
+	if (streamSegments.empty() || (streamSegments.back().vertexCount * vertexBytes + bytes > streamSegments.back().capacity))
 	{
-		cout << line << endl;
-		if (line.empty() || line[0] == '#') continue;
-		istringstream iss(line);
-		string keyword;
-		iss >> keyword;
-		if (keyword == "v")
-		{
-			Vertex vertex;
-			iss >> vertex.x >> vertex.y >> vertex.z;
-			vertices.push_back(vertex);
-		}
-		else if (keyword == "vn")
-		{
-			Normal normal;
-			iss >> normal.nx >> normal.ny >> normal.nz;
-			normals.push_back(normal);
-		}
-		else if (keyword == "vt")
-		{
-			TextureCoordinate texture;
-			iss >> texture.u >> texture.v;
-			textures.push_back(texture);
-		}
-		else if (keyword == "f")
-		{
-			vector<FaceVertex> faceVertices;
-			string faceVertexStr;
-			while (iss >> faceVertexStr)
-			{
-				istringstream fvIss(faceVertexStr);
-				string vertexIndexStr, uvIndexStr, normalIndexStr;
-				getline(fvIss, vertexIndexStr, '/');
-				getline(fvIss, uvIndexStr, '/');
-				getline(fvIss, normalIndexStr, '/');
-				int vertexIndex = stoi(vertexIndexStr) - 1;
-				int uvIndex = stoi(uvIndexStr) - 1;
-				int normalIndex = stoi(normalIndexStr) - 1;
-				faceVertices.push_back({ vertexIndex, uvIndex, normalIndex });
-			}
-			faces.push_back(faceVertices);
-		}
+		StreamSegment segment = { 0, 0, max(STREAM_SEGMENT_BYTES, bytes), 0 };
+		glGenBuffers(1, &segment.VBO);
+		glBindBuffer(GL_ARRAY_BUFFER, segment.VBO);
+		glBufferData(GL_ARRAY_BUFFER, segment.capacity, nullptr, GL_STATIC_DRAW);
+		segment.VAO = createVertexArray(segment.VBO);
+		streamSegments.push_back(segment);
 	}
-	vector<float> vertexArray;
-	for (const auto& faceVertices : faces)
+	StreamSegment& segment = streamSegments.back();
+	glBindBuffer(GL_ARRAY_BUFFER, segment.VBO);
+	glBufferSubData(GL_ARRAY_BUFFER, segment.vertexCount * vertexBytes, bytes, batch.data());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	segment.vertexCount += (GLsizei)(batch.size() / OBJ_VERTEX_STRIDE);
+	for (size_t i = 0; i < batch.size(); i += OBJ_VERTEX_STRIDE)
 	{
-		for (const auto& fv : faceVertices)
-		{
-			const Vertex& vertex = vertices[fv.vertexIndex];
-			const TextureCoordinate& texture = textures[fv.uvIndex];
-			const Normal& normal = normals[fv.normalIndex];
-			vertexArray.push_back(vertex.x);
-			vertexArray.push_back(vertex.y);
-			vertexArray.push_back(vertex.z);
-			vertexArray.push_back(0.0f);// r
-			vertexArray.push_back(0.0f);// g
-			vertexArray.push_back(0.0f);// b
-			vertexArray.push_back(texture.u);
-			vertexArray.push_back(texture.v);
-			vertexArray.push_back(normal.nx);
-			vertexArray.push_back(normal.ny);
-			vertexArray.push_back(normal.nz);
-		}
+		glm::vec3 position(batch[i], batch[i + 1], batch[i + 2]);
+		streamMin = glm::min(streamMin, position);
+		streamMax = glm::max(streamMax, position);
 	}
-	return vertexArray;
-}
-
-Material parseMTL(const string& filename)
-{
-	ifstream file(filename);
-	if (!file.is_open()) {
-		cerr << "Failed to open MTL file: " << filename << endl;
-		return {};
-	}
-	Material material;
-	string line;
-	while (getline(file, line)) {
-		istringstream iss(line);
-		string token;
-		iss >> token;
-		if (token == "newmtl") iss >> material.name;
-		if (token == "Ns") iss >> material.Ns;
-		if (token == "Ka") iss >> material.Ka[0] >> material.Ka[1] >> material.Ka[2];
-		if (token == "Ks") iss >> material.Ks[0] >> material.Ks[1] >> material.Ks[2];
-		if (token == "Ke") iss >> material.Ke[0] >> material.Ke[1] >> material.Ke[2];
-		if (token == "Ni") iss >> material.Ni;
-		if (token == "d") iss >> material.d;
-		if (token == "illum") iss >> material.illum;
-		if (token == "map_Kd") iss >> material.map_Kd;
-	}
-	return material;
 }
 
 int loadTexture(string path)
@@ -263,7 +274,8 @@ int loadTexture(string path)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	int width, height, nrChannels;
-	unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+	AssetData asset;
+	unsigned char* data = readAsset(archive, path, asset) ? stbi_load_from_memory(asset.data, (int)asset.size, &width, &height, &nrChannels, 0) : nullptr;
 	bool isPng = nrChannels != 3;
 	if (!data) {
 		cout << "Failed to load texture" << endl;
@@ -283,8 +295,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, GL_TRUE);
 
+	if (action == GLFW_PRESS) scheduler.markDirty(DIRTY_INPUT);
+	if (key == GLFW_KEY_O && action == GLFW_PRESS) scheduler.onDemand = !scheduler.onDemand;
+	if (key == GLFW_KEY_T && action == GLFW_PRESS) scheduler.frameLimit = scheduler.frameLimit > 0.0 ? 0.0 : FRAME_LIMIT_FPS;
+
 	if (key == GLFW_KEY_X && action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_TRANSFORM);
 		rotateX = true;
 		rotateY = false;
 		rotateZ = false;
@@ -292,6 +309,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 	if (key == GLFW_KEY_Y && action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_TRANSFORM);
 		rotateX = false;
 		rotateY = true;
 		rotateZ = false;
@@ -299,6 +317,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 	if (key == GLFW_KEY_Z && action == GLFW_PRESS)
 	{
+		scheduler.markDirty(DIRTY_TRANSFORM);
 		rotateX = false;
 		rotateY = false;
 		rotateZ = true;
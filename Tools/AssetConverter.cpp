@@ -0,0 +1,342 @@
+// Converte uma pasta de assets (.obj, .mtl, .png/.jpg) nos binarios de AssetFormats.h, rodando
+// o pipeline inteiro de cada arquivo (parse/decode, indexacao, otimizacao, mipmaps, compressao,
+// escrita) como um job do JobSystem. A pasta de saida repete a estrutura da de entrada.
+// Uso:
+//   AssetConverter <pasta de entrada> <pasta de saida> [--lz4] [--threads N]
+// Ex., da raiz do repositorio:
+//   AssetConverter Camera/textures Camera/converted --lz4
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <cfloat>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "stb_image.h"
+
+#include "ObjLoader.h"
+#include "MeshOptimizer.h"
+#include "AssetFormats.h"
+#include "JobSystem.h"
+
+using namespace std;
+
+enum ConversionStage { STAGE_LOAD, STAGE_INDEX, STAGE_OPTIMIZE, STAGE_COMPRESS, STAGE_WRITE, STAGE_COUNT };
+const char* STAGE_NAMES[STAGE_COUNT] = { "load", "index", "optimize", "encode", "write" };
+
+struct ConversionResult {
+	string input;
+	string output;
+	bool ok = false;
+	string error;
+	size_t inputBytes = 0;
+	size_t outputBytes = 0;
+	double stageMs[STAGE_COUNT] = {};
+	double totalMs = 0.0;
+	// So para malhas
+	size_t sourceVertices = 0, uniqueVertices = 0;
+	float acmrBefore = 0.0f, acmrAfter = 0.0f;
+};
+
+class StageTimer {
+public:
+	StageTimer(ConversionResult& result) : result(result), last(chrono::steady_clock::now()) {}
+	void end(ConversionStage stage)
+	{
+		auto now = chrono::steady_clock::now();
+		result.stageMs[stage] += chrono::duration<double, milli>(now - last).count();
+		last = now;
+	}
+private:
+	ConversionResult& result;
+	chrono::steady_clock::time_point last;
+};
+
+string extensionOf(const string& path)
+{
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of('/');
+	if (dot == string::npos || (slash != string::npos && dot < slash)) return "";
+	string extension = path.substr(dot + 1);
+	transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)tolower(c); });
+	return extension;
+}
+
+// Troca '\\' por '/' e tira a barra final
+string normalizeSlashes(string path)
+{
+	replace(path.begin(), path.end(), '\\', '/');
+	while (path.size() > 1 && path.back() == '/') path.pop_back();
+	return path;
+}
+
+string replaceExtension(const string& path, const string& extension)
+{
+	size_t dot = path.find_last_of('.');
+	return path.substr(0, dot) + "." + extension;
+}
+
+// Lista os arquivos de dir recursivamente, com caminhos relativos a dir
+void listFiles(const string& dir, const string& relative, vector<string>& files)
+{
+	string path = relative.empty() ? dir : dir + "/" + relative;
+#ifdef _WIN32
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((path + "/*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE) return;
+	do
+	{
+		string name = data.cFileName;
+		if (name == "." || name == "..") continue;
+		string child = relative.empty() ? name : relative + "/" + name;
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) listFiles(dir, child, files);
+		else files.push_back(child);
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+#else
+	DIR* handle = opendir(path.c_str());
+	if (!handle) return;
+	while (dirent* entry = readdir(handle))
+	{
+		string name = entry->d_name;
+		if (name == "." || name == "..") continue;
+		string child = relative.empty() ? name : relative + "/" + name;
+		struct stat info;
+		if (stat((dir + "/" + child).c_str(), &info) != 0) continue;
+		if (S_ISDIR(info.st_mode)) listFiles(dir, child, files);
+		else files.push_back(child);
+	}
+	closedir(handle);
+#endif
+}
+
+void makeDirectories(const string& path)
+{
+	for (size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1))
+	{
+		string prefix = path.substr(0, slash);
+#ifdef _WIN32
+		_mkdir(prefix.c_str());
+#else
+		mkdir(prefix.c_str(), 0755);
+#endif
+		if (slash == string::npos) break;
+	}
+}
+
+size_t fileSize(const string& path)
+{
+	ifstream in(path, ios::binary | ios::ate);
+	return in ? (size_t)in.tellg() : 0;
+}
+
+bool writeFile(const string& path, const void* data, size_t size)
+{
+	size_t slash = path.find_last_of('/');
+	if (slash != string::npos) makeDirectories(path.substr(0, slash));
+	ofstream out(path, ios::binary);
+	out.write((const char*)data, size);
+	return (bool)out;
+}
+
+void convertMesh(const string& input, ConversionResult& result, bool compress)
+{
+	StageTimer timer(result);
+	vector<float> interleaved = parseObjFile(input);
+	timer.end(STAGE_LOAD);
+	if (interleaved.empty())
+	{
+		result.error = "no triangles";
+		return;
+	}
+
+	MeshBinary mesh;
+	result.sourceVertices = interleaved.size() / OBJ_VERTEX_STRIDE;
+	result.uniqueVertices = indexVertices(interleaved, OBJ_VERTEX_STRIDE, mesh.vertices, mesh.indices);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		mesh.aabbMin[axis] = FLT_MAX;
+		mesh.aabbMax[axis] = -FLT_MAX;
+	}
+	for (size_t i = 0; i < mesh.vertices.size(); i += OBJ_VERTEX_STRIDE)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			mesh.aabbMin[axis] = min(mesh.aabbMin[axis], mesh.vertices[i + axis]);
+			mesh.aabbMax[axis] = max(mesh.aabbMax[axis], mesh.vertices[i + axis]);
+		}
+	}
+	timer.end(STAGE_INDEX);
+
+	result.acmrBefore = averageCacheMissRatio(mesh.indices, result.uniqueVertices);
+	optimizeVertexCache(mesh.indices, result.uniqueVertices);
+	optimizeVertexFetch(mesh.vertices, OBJ_VERTEX_STRIDE, mesh.indices);
+	result.acmrAfter = averageCacheMissRatio(mesh.indices, result.uniqueVertices);
+	timer.end(STAGE_OPTIMIZE);
+
+	vector<unsigned char> bytes;
+	writeMeshBinary(mesh, compress, bytes);
+	timer.end(STAGE_COMPRESS);
+
+	result.ok = writeFile(result.output, bytes.data(), bytes.size());
+	result.outputBytes = bytes.size();
+	timer.end(STAGE_WRITE);
+}
+
+void convertTexture(const string& input, ConversionResult& result, bool compress)
+{
+	StageTimer timer(result);
+	int width, height, channels;
+	unsigned char* pixels = stbi_load(input.c_str(), &width, &height, &channels, 4);
+	timer.end(STAGE_LOAD);
+	if (!pixels)
+	{
+		result.error = stbi_failure_reason();
+		return;
+	}
+
+	TextureBinary texture;
+	buildMipChain(pixels, width, height, texture);
+	stbi_image_free(pixels);
+	timer.end(STAGE_OPTIMIZE);
+
+	vector<unsigned char> bytes;
+	writeTextureBinary(texture, compress, bytes);
+	timer.end(STAGE_COMPRESS);
+
+	result.ok = writeFile(result.output, bytes.data(), bytes.size());
+	result.outputBytes = bytes.size();
+	timer.end(STAGE_WRITE);
+}
+
+void convertMaterial(const string& input, ConversionResult& result)
+{
+	StageTimer timer(result);
+	Material material = parseMTL(input);
+	MaterialBinary binary = toMaterialBinary(material);
+	timer.end(STAGE_LOAD);
+
+	result.ok = writeFile(result.output, &binary, sizeof(binary));
+	result.outputBytes = sizeof(binary);
+	timer.end(STAGE_WRITE);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		cout << "Usage: AssetConverter <input dir> <output dir> [--lz4] [--threads N]" << endl;
+		return 1;
+	}
+	string inputDir = normalizeSlashes(argv[1]);
+	string outputDir = normalizeSlashes(argv[2]);
+	bool compress = false;
+	int threads = -1;
+	for (int i = 3; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--lz4") compress = true;
+		else if (arg == "--threads" && i + 1 < argc) threads = max(1, atoi(argv[++i]));
+	}
+
+	vector<string> files;
+	listFiles(inputDir, "", files);
+	vector<ConversionResult> results;
+	for (const string& file : files)
+	{
+		string extension = extensionOf(file);
+		string outputExtension = extension == "obj" ? "mesh" : extension == "mtl" ? "mat"
+			: (extension == "png" || extension == "jpg" || extension == "jpeg") ? "tex" : "";
+		if (outputExtension.empty()) continue;
+		ConversionResult result;
+		result.input = file;
+		result.output = outputDir + "/" + replaceExtension(file, outputExtension);
+		results.push_back(result);
+	}
+	if (results.empty())
+	{
+		cout << "No .obj, .mtl or image files in " << inputDir << endl;
+		return 1;
+	}
+
+	// O pool inclui a main thread (threadCount = workers + 1)
+	JobSystem jobs(threads > 0 ? threads - 1 : -1);
+	cout << "Converting " << results.size() << " assets on " << jobs.threadCount() << " threads"
+		<< (compress ? " (lz4)" : "") << endl;
+	auto start = chrono::steady_clock::now();
+	JobCounter counter;
+	for (ConversionResult& result : results)
+	{
+		jobs.run([&result, &inputDir, compress]() {
+			auto jobStart = chrono::steady_clock::now();
+			string input = inputDir + "/" + result.input;
+			result.inputBytes = fileSize(input);
+			try
+			{
+				string extension = extensionOf(input);
+				if (extension == "obj") convertMesh(input, result, compress);
+				else if (extension == "mtl") convertMaterial(input, result);
+				else convertTexture(input, result, compress);
+			}
+			catch (const exception& e)
+			{
+				result.ok = false;
+				result.error = e.what();
+			}
+			if (!result.ok && result.error.empty()) result.error = "failed to write " + result.output;
+			result.totalMs = chrono::duration<double, milli>(chrono::steady_clock::now() - jobStart).count();
+		}, &counter);
+	}
+	jobs.wait(counter);
+	double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+	// Mais lentos primeiro
+	sort(results.begin(), results.end(), [](const ConversionResult& a, const ConversionResult& b) { return a.totalMs > b.totalMs; });
+	double jobMs = 0.0, stageTotals[STAGE_COUNT] = {};
+	size_t totalIn = 0, totalOut = 0;
+	int failures = 0;
+	cout << fixed << setprecision(2);
+	for (const ConversionResult& result : results)
+	{
+		jobMs += result.totalMs;
+		for (int s = 0; s < STAGE_COUNT; s++) stageTotals[s] += result.stageMs[s];
+		if (!result.ok)
+		{
+			failures++;
+			cout << "  FAILED " << result.input << ": " << result.error << endl;
+			continue;
+		}
+		totalIn += result.inputBytes;
+		totalOut += result.outputBytes;
+		cout << "  " << result.input << " -> " << result.output << endl;
+		cout << "    " << result.totalMs << " ms (";
+		for (int s = 0; s < STAGE_COUNT; s++)
+		{
+			if (result.stageMs[s] > 0.0) cout << STAGE_NAMES[s] << " " << result.stageMs[s] << (s + 1 < STAGE_COUNT ? " " : "");
+		}
+		cout << "), " << result.inputBytes << " -> " << result.outputBytes << " bytes ("
+			<< 100.0 * result.outputBytes / max<size_t>(result.inputBytes, 1) << "%)" << endl;
+		if (result.sourceVertices > 0)
+		{
+			cout << "    vertices " << result.sourceVertices << " -> " << result.uniqueVertices
+				<< ", ACMR " << result.acmrBefore << " -> " << result.acmrAfter << endl;
+		}
+	}
+	cout << "Stage totals:";
+	for (int s = 0; s < STAGE_COUNT; s++) cout << " " << STAGE_NAMES[s] << " " << stageTotals[s] << " ms";
+	cout << endl;
+	cout << results.size() - failures << " converted, " << failures << " failed, " << totalIn << " -> " << totalOut
+		<< " bytes; wall " << wallMs << " ms vs " << jobMs << " ms of jobs (" << jobMs / max(wallMs, 0.001) << "x)" << endl;
+	return failures == 0 ? 0 : 1;
+}
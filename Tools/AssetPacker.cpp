@@ -0,0 +1,98 @@
+// Empacota arquivos soltos em um .pak (AssetArchive.h) ou lista/confere um .pak existente.
+// Uso:
+//   AssetPacker <saida.pak> [--lz4] [--base <pasta>] <arquivo>...
+//   AssetPacker --list <arquivo.pak>
+// Os nomes no .pak sao os caminhos relativos a --base (por exemplo, a pasta do modulo), do
+// mesmo jeito que o programa os abre. Ex., da raiz do repositorio:
+//   AssetPacker Camera/assets.pak --lz4 --base Camera Camera/textures/suzanne/* Camera/shaders/*
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+
+#include "AssetArchive.h"
+
+using namespace std;
+
+int listArchive(const string& path)
+{
+	AssetArchive archive;
+	if (!archive.open(path))
+	{
+		cout << "Failed to open archive " << path << endl;
+		return 1;
+	}
+	int failures = 0;
+	for (const ArchiveEntry& entry : archive)
+	{
+		AssetData asset;
+		bool ok = archive.read(entry, asset, true);
+		failures += ok ? 0 : 1;
+		cout << archive.nameOf(entry) << ": " << entry.size << " bytes, stored " << entry.storedSize
+			<< (entry.compression == ARCHIVE_COMPRESSION_LZ4 ? " (lz4)" : "") << (ok ? "" : " - HASH MISMATCH") << endl;
+	}
+	cout << archive.size() << " entries, " << failures << " failed verification" << endl;
+	return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 3 && string(argv[1]) == "--list")
+	{
+		return listArchive(argv[2]);
+	}
+	if (argc < 3)
+	{
+		cout << "Usage: AssetPacker <output.pak> [--lz4] [--base <dir>] <file>..." << endl;
+		cout << "       AssetPacker --list <archive.pak>" << endl;
+		return 1;
+	}
+	string output = argv[1];
+	bool compress = false;
+	string base;
+	vector<string> files;
+	for (int i = 2; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--lz4") compress = true;
+		else if (arg == "--base" && i + 1 < argc) base = argv[++i];
+		else files.push_back(arg);
+	}
+	string basePrefix = normalizeAssetPath(base);
+	if (!basePrefix.empty()) basePrefix += '/';
+
+	auto start = chrono::steady_clock::now();
+	AssetArchiveWriter writer;
+	size_t totalSize = 0;
+	for (const string& file : files)
+	{
+		ifstream in(file, ios::binary);
+		if (!in)
+		{
+			cout << "Failed to open " << file << endl;
+			return 1;
+		}
+		vector<unsigned char> content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+		string name = normalizeAssetPath(file);
+		if (!basePrefix.empty() && name.compare(0, basePrefix.size(), basePrefix) == 0)
+		{
+			name = name.substr(basePrefix.size());
+		}
+		if (!writer.add(name, content, compress)) return 1;
+		totalSize += content.size();
+		cout << "  " << name << " (" << content.size() << " bytes)" << endl;
+	}
+	if (!writer.write(output))
+	{
+		cout << "Failed to write " << output << endl;
+		return 1;
+	}
+	ifstream written(output, ios::binary | ios::ate);
+	double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	cout << files.size() << " files, " << totalSize << " bytes -> " << output << " (" << (size_t)written.tellg()
+		<< " bytes) in " << ms << " ms" << endl;
+	return listArchive(output);
+}